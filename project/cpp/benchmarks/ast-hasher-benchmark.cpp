@@ -0,0 +1,88 @@
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "spglsl/spglsl-angle/lib/spglsl-angle-ast-hasher.h"
+#include "spglsl/spglsl-angle/spglsl-angle-compiler-handle.h"
+#include "spglsl/spglsl-angle/spglsl-angle-compiler.h"
+#include "spglsl/spglsl-compile-options.h"
+#include "spglsl/spglsl-init.h"
+
+struct CompiledShader {
+  std::unique_ptr<SpglslCompileOptions> options;
+  std::unique_ptr<SpglslAngleCompilerHandle> handle;
+};
+
+/** Compiles every .frag and .vert file in the folder and its subfolders, the shaders that do not compile are skipped */
+static std::vector<CompiledShader> compileShaders(const std::filesystem::path & folder) {
+  std::vector<CompiledShader> result;
+  size_t failed = 0;
+  for (const auto & entry : std::filesystem::recursive_directory_iterator(folder)) {
+    const std::string extension = entry.path().extension().string();
+    if (!entry.is_regular_file() || (extension != ".frag" && extension != ".vert")) {
+      continue;
+    }
+    std::ifstream file(entry.path());
+    std::stringstream source;
+    source << file.rdbuf();
+
+    CompiledShader shader;
+    shader.options = std::make_unique<SpglslCompileOptions>();
+    shader.options->compileMode = SpglslCompileMode::Compile;
+    shader.options->language = extension == ".vert" ? EShLangVertex : EShLangFragment;
+    shader.handle = std::make_unique<SpglslAngleCompilerHandle>(*shader.options);
+    if (shader.handle->compile(source.str())) {
+      result.push_back(std::move(shader));
+    } else {
+      ++failed;
+    }
+  }
+  printf("%zu shaders compiled, %zu skipped\n", result.size(), failed);
+  return result;
+}
+
+/** Hashes the body of every shader iterations times, returns the elapsed milliseconds */
+template <typename Hasher>
+static double hashShaders(const std::vector<CompiledShader> & shaders, int iterations, uint64_t & checksum) {
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    for (const CompiledShader & shader : shaders) {
+      SpglslAngleCompiler & compiler = *shader.handle->compiler;
+      Hasher hasher(&compiler.symbolTable);
+      const typename Hasher::HashValue value = hasher.computeNodeHash(compiler.body);
+      checksum += std::hash<typename Hasher::HashValue>()(value);
+    }
+  }
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Hashes the ASTs of the test shaders with the persistent HighwayHash256 policy and the in memory xxhash64 policy.
+ * Usage: spglsl-ast-hasher-benchmark [shaders folder]
+ */
+int main(int argc, char ** argv) {
+  if (!spglsl_init(emscripten::val::null())) {
+    fprintf(stderr, "initialization failed\n");
+    return 1;
+  }
+
+  const std::vector<CompiledShader> shaders = compileShaders(argc > 1 ? argv[1] : SPGLSL_TEST_SHADERS_DIR);
+  if (shaders.empty()) {
+    fprintf(stderr, "no shader to hash\n");
+    return 1;
+  }
+
+  const int iterations = 200;
+  uint64_t checksum = 0;
+  const double highwayMs = hashShaders<AngleAstHasher>(shaders, iterations, checksum);
+  const double xxhashMs = hashShaders<AngleAstFastHasher>(shaders, iterations, checksum);
+  printf("%d iterations: HighwayHash256 %.2f ms, xxhash64 %.2f ms (checksum %llx)\n", iterations, highwayMs,
+      xxhashMs, (unsigned long long)checksum);
+  return 0;
+}
@@ -0,0 +1,91 @@
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "spglsl/core/hash-stream.h"
+
+using namespace highwayhash;
+
+static const uint64_t hashKey[4] = {0x125231, 0x876832, 0x8876263, 0x7486864};
+
+/** The hasher before the staging buffer, every write goes through HighwayHashCatAppend */
+class PerWriteHasher {
+ public:
+  inline PerWriteHasher() {
+    HighwayHashCatStart(hashKey, &this->_state);
+  }
+
+  inline PerWriteHasher & append(const void * data, size_t size) {
+    HighwayHashCatAppend((const uint8_t *)data, size, &this->_state);
+    return *this;
+  }
+
+  inline SpglslHashValue digest() const {
+    SpglslHashValue result;
+    HighwayHashCatFinish256(&this->_state, result.data);
+    return result;
+  }
+
+ private:
+  HighwayHashCat _state;
+};
+
+/** Writes like the AST hasher does: node headers, enums, names and constants of a few bytes each */
+template <typename Hasher>
+static SpglslHashValue hashNodes(Hasher & hasher, const std::vector<std::string> & names, int nodesCount) {
+  for (int i = 0; i < nodesCount; ++i) {
+    const int header[2] = {0xAC0FFEE, i & 15};
+    hasher.append(header, sizeof(header));
+    const int op = i % 37;
+    hasher.append(&op, sizeof(op));
+    const std::string & name = names[(size_t)i % names.size()];
+    hasher.append(name.c_str(), name.size() + 1);
+    const float constant = (float)i * 0.25f;
+    hasher.append(&constant, sizeof(constant));
+    const char flag = (char)(i & 1);
+    hasher.append(&flag, sizeof(flag));
+    const int footer[2] = {0x3C123ABC, 0xABBA};
+    hasher.append(footer, sizeof(footer));
+  }
+  return hasher.digest();
+}
+
+template <typename Fn>
+static double measureMs(Fn fn) {
+  const auto start = std::chrono::steady_clock::now();
+  fn();
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Compares SpglslHasher, that stages the writes in a 256 bytes buffer, with a HighwayHashCatAppend for every write.
+ * Both must produce the same digest.
+ * Usage: spglsl-hasher-benchmark
+ */
+int main() {
+  const std::vector<std::string> names = {"x", "uv", "color", "gl_FragCoord", "normalize", "rayDirection"};
+
+  for (const int nodesCount : {100000, 1000000}) {
+    SpglslHashValue perWriteDigest;
+    const double perWriteMs = measureMs([&]() {
+      PerWriteHasher hasher;
+      perWriteDigest = hashNodes(hasher, names, nodesCount);
+    });
+
+    SpglslHashValue stagedDigest;
+    const double stagedMs = measureMs([&]() {
+      SpglslHasher hasher;
+      stagedDigest = hashNodes(hasher, names, nodesCount);
+    });
+
+    if (perWriteDigest != stagedDigest) {
+      fprintf(stderr, "%d nodes: the digests differ\n", nodesCount);
+      return 1;
+    }
+    printf("%d nodes, %d writes: per write %.2f ms, staging buffer %.2f ms\n", nodesCount, nodesCount * 6,
+        perWriteMs, stagedMs);
+  }
+  return 0;
+}
@@ -0,0 +1,114 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "spglsl/spglsl-angle/symbols/spglsl-symbol-usage.h"
+#include "spglsl/spglsl-compile-options.h"
+
+static const char * sampleText =
+    "#version 300 es\n"
+    "precision highp float;\n"
+    "uniform float uTime;\n"
+    "uniform vec2 uResolution;\n"
+    "out vec4 fragColor;\n"
+    "float sdSphere(vec3 p, float radius) { return length(p) - radius; }\n"
+    "float map(vec3 p) { return min(sdSphere(p, 1.0), p.y + 1.0); }\n"
+    "void main() {\n"
+    "  vec2 uv = (gl_FragCoord.xy * 2.0 - uResolution) / uResolution.y;\n"
+    "  vec3 rayOrigin = vec3(0.0, 0.0, -3.0);\n"
+    "  vec3 rayDirection = normalize(vec3(uv, 1.5));\n"
+    "  float distance = 0.0;\n"
+    "  for (int i = 0; i < 64; ++i) { distance += map(rayOrigin + rayDirection * distance); }\n"
+    "  fragColor = vec4(vec3(exp(-distance * 0.25)) * (0.5 + 0.5 * sin(uTime)), 1.0);\n"
+    "}\n";
+
+/** The generator before the names table, an ostringstream and floating point divisions for every name */
+static std::vector<std::string> oldGenerateNames(const SpglslSymbolGenerator & generator, int count) {
+  std::unordered_map<int, std::string> mangleMap;
+  std::unordered_set<std::string> usedNames;
+  size_t usedWords = 0;
+  uint64_t genCounter = 0;
+  std::vector<std::string> names;
+  for (int mangleId = 1; mangleId <= count; ++mangleId) {
+    auto & result = mangleMap[mangleId];
+    if (result.empty()) {
+      for (;;) {
+        if (usedWords < generator.words.size()) {
+          result = generator.words[usedWords++];
+        } else {
+          auto index = genCounter++;
+          std::ostringstream ss;
+          ss.put(generator.chars[index % generator.chars.size()]);
+          index = floor((double)index / (double)generator.chars.size());
+          while (index > 0) {
+            index -= 1;
+            ss.put(generator.charsAndNumbers[index % generator.charsAndNumbers.size()]);
+            index = floor((double)index / (double)generator.charsAndNumbers.size());
+          }
+          result = ss.str();
+        }
+        if (generator.isReservedWord(result)) {
+          continue;
+        }
+        if (usedNames.emplace(result).second) {
+          break;
+        }
+      }
+    }
+    names.push_back(result);
+  }
+  return names;
+}
+
+static std::vector<std::string> newGenerateNames(SpglslSymbolGenerator & generator, int count) {
+  std::vector<std::string> names;
+  generator.generateNames((size_t)count);
+  for (int mangleId = 1; mangleId <= count; ++mangleId) {
+    names.push_back(generator.getOrCreateMangledName(mangleId));
+  }
+  return names;
+}
+
+template <typename Fn>
+static double measureMs(Fn fn) {
+  const auto start = std::chrono::steady_clock::now();
+  fn();
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Compares the old and the new generator of mangled names, both must produce the same sequence.
+ * Usage: spglsl-symbol-generator-benchmark
+ */
+int main() {
+  SpglslCompileOptions options;
+  SpglslSymbols symbols(nullptr, options);
+  SpglslSymbolUsage usage(symbols);
+  SpglslTextStats stats;
+  stats.addText(sampleText, strlen(sampleText));
+
+  for (const int count : {10000, 100000}) {
+    SpglslSymbolGenerator oldGenerator(usage);
+    oldGenerator.load(stats);
+    std::vector<std::string> oldNames;
+    const double oldMs = measureMs([&]() { oldNames = oldGenerateNames(oldGenerator, count); });
+
+    SpglslSymbolGenerator newGenerator(usage);
+    newGenerator.load(stats);
+    std::vector<std::string> newNames;
+    const double newMs = measureMs([&]() { newNames = newGenerateNames(newGenerator, count); });
+
+    if (oldNames != newNames) {
+      fprintf(stderr, "%d names: the sequences differ\n", count);
+      return 1;
+    }
+    printf("%d names: old %.2f ms, new %.2f ms\n", count, oldMs, newMs);
+  }
+  return 0;
+}
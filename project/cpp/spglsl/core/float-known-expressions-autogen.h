@@ -0,0 +1,493 @@
+// Generated by scripts/generate-known-floats.js, do not edit.
+
+#ifndef _SPGLSL_FLOAT_KNOWN_EXPRESSIONS_AUTOGEN_
+#define _SPGLSL_FLOAT_KNOWN_EXPRESSIONS_AUTOGEN_
+
+#include <cstdint>
+#include <string_view>
+
+/** A float value, as its bits, and a GLSL expression that evaluates to it */
+struct SpglslKnownFloatExpression {
+  uint32_t bits;
+  std::string_view expression;
+};
+
+constexpr uint32_t spglslKnownFloatExpressionsCount = 461;
+
+/** Sorted by bits */
+constexpr SpglslKnownFloatExpression spglslKnownFloatExpressions[spglslKnownFloatExpressionsCount] = {
+    {0x3d2a5096u, "sin(3.1)"},
+    {0x3d888889u, "(1./15.)"},
+    {0x3d90deaau, "cos(1.5)"},
+    {0x3d924925u, "(1./14.)"},
+    {0x3d9d89d9u, "(1./13.)"},
+    {0x3daaaaabu, "(1./12.)"},
+    {0x3db332c4u, "cos(4.8)"},
+    {0x3dba2e8cu, "(1./11.)"},
+    {0x3dcc1f14u, "atan(.1)"},
+    {0x3dcc7577u, "sin(.1)"},
+    {0x3dcc75cfu, "asinh(.1)"},
+    {0x3de38e39u, "(1./9.)"},
+    {0x3e088889u, "(2./15.)"},
+    {0x3e124925u, "(1./7.)"},
+    {0x3e1d89d9u, "(2./13.)"},
+    {0x3e2aaaabu, "(1./6.)"},
+    {0x3e2e0bdfu, "cos(1.4)"},
+    {0x3e3a2e8cu, "(2./11.)"},
+    {0x3e3efd20u, "cos(4.9)"},
+    {0x3e4a2210u, "atan(.2)"},
+    {0x3e4b6ff9u, "sin(.2)"},
+    {0x3e4b756cu, "asinh(.2)"},
+    {0x3e5b6db7u, "(3./14.)"},
+    {0x3e638e39u, "(2./9.)"},
+    {0x3e6c4ec5u, "(3./13.)"},
+    {0x3e74fdc0u, "sin(2.9)"},
+    {0x3e888889u, "(4./15.)"},
+    {0x3e88f59du, "cos(1.3)"},
+    {0x3e8ba2e9u, "(3./11.)"},
+    {0x3e924925u, "(2./7.)"},
+    {0x3e9539d4u, "atan(.3)"},
+    {0x3e974e6du, "sin(.3)"},
+    {0x3e976276u, "asinh(.3)"},
+    {0x3e9d89d9u, "(4./13.)"},
+    {0x3ea1e89bu, "sqrt(.1)"},
+    {0x3eaaaaabu, "(1./3.)"},
+    {0x3eab8393u, "sin(2.8)"},
+    {0x3eb6db6eu, "(5./14.)"},
+    {0x3eb986f3u, "cos(1.2)"},
+    {0x3eba2e8cu, "(4./11.)"},
+    {0x3ec2d1bcu, "atan(.4)"},
+    {0x3ec4ec4fu, "(5./13.)"},
+    {0x3ec761d7u, "sin(.4)"},
+    {0x3ec7b2b6u, "asinh(.4)"},
+    {0x3ed55555u, "(5./12.)"},
+    {0x3edad188u, "sin(2.7)"},
+    {0x3edb6db7u, "(3./7.)"},
+    {0x3ee38e39u, "(4./9.)"},
+    {0x3ee4f92eu, "sqrt(.2)"},
+    {0x3ee83dbfu, "cos(1.1)"},
+    {0x3ee8ba2fu, "(5./11.)"},
+    {0x3eec4ec5u, "(6./13.)"},
+    {0x3eed6338u, "atan(.5)"},
+    {0x3eeeeeefu, "(7./15.)"},
+    {0x3ef57744u, "sin(.5)"},
+    {0x3f03f7e7u, "sin(2.6)"},
+    {0x3f088889u, "(8./15.)"},
+    {0x3f09d89eu, "(7./13.)"},
+    {0x3f0a5140u, "cos(1.)"},
+    {0x3f0a58efu, "atan(.6)"},
+    {0x3f0ba2e9u, "(6./11.)"},
+    {0x3f0c378cu, "sqrt(.3)"},
+    {0x3f0e38e4u, "(5./9.)"},
+    {0x3f108c69u, "sin(.6)"},
+    {0x3f119e83u, "asinh(.6)"},
+    {0x3f124925u, "(4./7.)"},
+    {0x3f155555u, "(7./12.)"},
+    {0x3f193578u, "sin(2.5)"},
+    {0x3f1c5889u, "atan(.7)"},
+    {0x3f1d89d9u, "(8./13.)"},
+    {0x3f21e89bu, "sqrt(.4)"},
+    {0x3f22e8bau, "(7./11.)"},
+    {0x3f249249u, "(9./14.)"},
+    {0x3f24eb73u, "sin(.7)"},
+    {0x3f271528u, "asinh(.7)"},
+    {0x3f2aaaabu, "(2./3.)"},
+    {0x3f2cbbd3u, "atan(.8)"},
+    {0x3f2ceb27u, "sin(2.4)"},
+    {0x3f313b14u, "(9./13.)"},
+    {0x3f317218u, "log(2.)"},
+    {0x3f325b5fu, "cos(.8)"},
+    {0x3f3504f3u, "sqrt(.5)"},
+    {0x3f36db6eu, "(5./7.)"},
+    {0x3f37a4a6u, "sin(.8)"},
+    {0x3f3a2e8cu, "(8./11.)"},
+    {0x3f3b99c5u, "atan(.9)"},
+    {0x3f3bbbbcu, "(11./15.)"},
+    {0x3f3ee68au, "sin(2.3)"},
+    {0x3f43ccb3u, "cos(.7)"},
+    {0x3f464bf8u, "sqrt(.6)"},
+    {0x3f471c72u, "(7./9.)"},
+    {0x3f48881du, "sin(.9)"},
+    {0x3f490fdbu, "atan(1.)"},
+    {0x3f492492u, "(11./14.)"},
+    {0x3f4ef99eu, "sin(2.2)"},
+    {0x3f51745du, "(9./11.)"},
+    {0x3f534932u, "cos(.6)"},
+    {0x3f555555u, "(5./6.)"},
+    {0x3f576aa4u, "sin(1.)"},
+    {0x3f589d8au, "(11./13.)"},
+    {0x3f5b6db7u, "(6./7.)"},
+    {0x3f5cfb4bu, "sin(2.1)"},
+    {0x3f604557u, "atan(1.2)"},
+    {0x3f60a940u, "cos(.5)"},
+    {0x3f638e39u, "(8./9.)"},
+    {0x3f64262bu, "sin(1.1)"},
+    {0x3f64f92eu, "sqrt(.8)"},
+    {0x3f68ba2fu, "(10./11.)"},
+    {0x3f68c7b7u, "sin(2.)"},
+    {0x3f6bcaa7u, "cos(.4)"},
+    {0x3f6e9a1du, "sin(1.2)"},
+    {0x3f6eeeefu, "(14./15.)"},
+    {0x3f7240b9u, "sin(1.9)"},
+    {0x3f72dce8u, "sqrt(.9)"},
+    {0x3f73570au, "atan(1.4)"},
+    {0x3f7490efu, "cos(.3)"},
+    {0x3f76abc0u, "sin(1.3)"},
+    {0x3f794e14u, "sin(1.8)"},
+    {0x3f7ae5a5u, "cos(.2)"},
+    {0x3f7b985fu, "atan(1.5)"},
+    {0x3f7c466fu, "sin(1.4)"},
+    {0x3f7dddbfu, "sin(1.7)"},
+    {0x3f7eb898u, "cos(.1)"},
+    {0x3f7fe40eu, "sin(1.6)"},
+    {0x3f80a3fau, "cosh(.1)"},
+    {0x3f82918cu, "cosh(.2)"},
+    {0x3f850052u, "atan(1.7)"},
+    {0x3f85cda7u, "cosh(.3)"},
+    {0x3f863f5eu, "sqrt(1.1)"},
+    {0x3f882740u, "atan(1.8)"},
+    {0x3f8a6094u, "cosh(.4)"},
+    {0x3f8b0c7bu, "atan(1.9)"},
+    {0x3f8c378cu, "sqrt(1.2)"},
+    {0x3f8c9f54u, "log(3.)"},
+    {0x3f8d763eu, "exp(.1)"},
+    {0x3f8db70du, "atan(2.)"},
+    {0x3f902d20u, "atan(2.1)"},
+    {0x3f90560cu, "cosh(.5)"},
+    {0x3f91f145u, "sqrt(1.3)"},
+    {0x3f927420u, "atan(2.2)"},
+    {0x3f968757u, "atan(2.4)"},
+    {0x3f97bd53u, "cosh(.6)"},
+    {0x3f9a104du, "atan(2.6)"},
+    {0x3f9ba8dcu, "atan(2.7)"},
+    {0x3f9c56edu, "exp(.2)"},
+    {0x3f9cc471u, "sqrt(1.5)"},
+    {0x3f9d27a5u, "atan(2.8)"},
+    {0x3f9e8eeeu, "atan(2.9)"},
+    {0x3f9fe0bbu, "atan(3.)"},
+    {0x3fa0a961u, "cosh(.7)"},
+    {0x3fa11edcu, "atan(3.1)"},
+    {0x3fa24aecu, "atan(3.2)"},
+    {0x3fa36660u, "atan(3.3)"},
+    {0x3fa47285u, "atan(3.4)"},
+    {0x3fa57088u, "atan(3.5)"},
+    {0x3fa66178u, "atan(3.6)"},
+    {0x3fa6e43fu, "sqrt(1.7)"},
+    {0x3fa7464au, "atan(3.7)"},
+    {0x3fa81fdfu, "atan(3.8)"},
+    {0x3fa8ef00u, "atan(3.9)"},
+    {0x3fa9b465u, "atan(4.)"},
+    {0x3faa70b6u, "atan(4.1)"},
+    {0x3fab248fu, "atan(4.2)"},
+    {0x3fab3112u, "cosh(.8)"},
+    {0x3fabbae2u, "sqrt(1.8)"},
+    {0x3fabd07au, "atan(4.3)"},
+    {0x3fac74f9u, "atan(4.4)"},
+    {0x3facc82du, "exp(.3)"},
+    {0x3fad1283u, "atan(4.5)"},
+    {0x3fada983u, "atan(4.6)"},
+    {0x3fae3a60u, "atan(4.7)"},
+    {0x3faec575u, "atan(4.8)"},
+    {0x3faf4b18u, "atan(4.9)"},
+    {0x3fb06f92u, "sqrt(1.9)"},
+    {0x3fb17218u, "log(4.)"},
+    {0x3fb504f3u, "sqrt(2.)"},
+    {0x3fb76f60u, "cosh(.9)"},
+    {0x3fb8c90cu, "asinh(2.)"},
+    {0x3fb97d58u, "sqrt(2.1)"},
+    {0x3fbddacdu, "sqrt(2.2)"},
+    {0x3fbef41du, "exp(.4)"},
+    {0x3fc21f22u, "sqrt(2.3)"},
+    {0x3fc583abu, "cosh(1.)"},
+    {0x3fc64bf8u, "sqrt(2.4)"},
+    {0x3fc90fdbu, "acos(0.)"},
+    {0x3fca62c2u, "sqrt(2.5)"},
+    {0x3fce0210u, "log(5.)"},
+    {0x3fce64d0u, "sqrt(2.6)"},
+    {0x3fd25352u, "sqrt(2.7)"},
+    {0x3fd3094cu, "exp(.5)"},
+    {0x3fd59204u, "cosh(1.1)"},
+    {0x3fd9f9e5u, "sqrt(2.9)"},
+    {0x3fddb3d7u, "sqrt(3.)"},
+    {0x3fe15e04u, "sqrt(3.1)"},
+    {0x3fe4f92eu, "sqrt(3.2)"},
+    {0x3fe55860u, "log(6.)"},
+    {0x3fe7c390u, "cosh(1.2)"},
+    {0x3fe88607u, "sqrt(3.3)"},
+    {0x3fe8c2dbu, "asinh(3.)"},
+    {0x3fe93b31u, "exp(.6)"},
+    {0x3fec0535u, "sqrt(3.4)"},
+    {0x3fef7751u, "sqrt(3.5)"},
+    {0x3ff2dce8u, "sqrt(3.6)"},
+    {0x3ff63682u, "sqrt(3.7)"},
+    {0x3ff91395u, "log(7.)"},
+    {0x3ff98497u, "sqrt(3.8)"},
+    {0x3ffc46eau, "cosh(1.3)"},
+    {0x3ffcc79eu, "sqrt(3.9)"},
+    {0x4000e153u, "exp(.7)"},
+    {0x40019712u, "sqrt(4.1)"},
+    {0x4004b696u, "sqrt(4.3)"},
+    {0x40051592u, "log(8.)"},
+    {0x40060fc5u, "asinh(4.)"},
+    {0x40063f5eu, "sqrt(4.4)"},
+    {0x4007c3b6u, "sqrt(4.5)"},
+    {0x4009a852u, "cosh(1.4)"},
+    {0x400abfaau, "sqrt(4.7)"},
+    {0x400c378cu, "sqrt(4.8)"},
+    {0x400c9f54u, "log(9.)"},
+    {0x400dab88u, "sqrt(4.9)"},
+    {0x400e6f43u, "exp(.8)"},
+    {0x400f1bbdu, "sqrt(5.)"},
+    {0x40135d8eu, "log(10.)"},
+    {0x40168de1u, "cosh(1.5)"},
+    {0x4019771eu, "log(11.)"},
+    {0x401cc471u, "sqrt(6.)"},
+    {0x401d6a23u, "exp(.9)"},
+    {0x401f08b6u, "log(12.)"},
+    {0x40242821u, "log(13.)"},
+    {0x4024f52eu, "cosh(1.6)"},
+    {0x4028e651u, "log(14.)"},
+    {0x402953fdu, "sqrt(7.)"},
+    {0x402d50b2u, "log(15.)"},
+    {0x402df854u, "exp(1.)"},
+    {0x40317218u, "log(16.)"},
+    {0x4035031fu, "cosh(1.7)"},
+    {0x403504f3u, "sqrt(8.)"},
+    {0x4035535eu, "log(17.)"},
+    {0x4038fbdau, "log(18.)"},
+    {0x403c71b0u, "log(19.)"},
+    {0x403fba14u, "log(20.)"},
+    {0x40404442u, "exp(1.1)"},
+    {0x4042d975u, "log(21.)"},
+    {0x4045d3a4u, "log(22.)"},
+    {0x4046e0d7u, "cosh(1.8)"},
+    {0x4048abf0u, "log(23.)"},
+    {0x40490fdbu, "acos(-1.)"},
+    {0x404a62c2u, "sqrt(10.)"},
+    {0x404b653cu, "log(24.)"},
+    {0x404e0210u, "log(25.)"},
+    {0x405084a7u, "log(26.)"},
+    {0x4052eefeu, "log(27.)"},
+    {0x40544395u, "sqrt(11.)"},
+    {0x40547cccu, "exp(1.2)"},
+    {0x405542d7u, "log(28.)"},
+    {0x405781c6u, "log(29.)"},
+    {0x4059ad38u, "log(30.)"},
+    {0x405abc1du, "cosh(1.9)"},
+    {0x405bc672u, "log(31.)"},
+    {0x405db3d7u, "sqrt(12.)"},
+    {0x405dce9eu, "log(32.)"},
+    {0x405fc6c8u, "log(33.)"},
+    {0x4061afe4u, "log(34.)"},
+    {0x40638ad3u, "log(35.)"},
+    {0x40655860u, "log(36.)"},
+    {0x4066c15au, "sqrt(13.)"},
+    {0x40671947u, "log(37.)"},
+    {0x4068ce36u, "log(38.)"},
+    {0x406a77cbu, "log(39.)"},
+    {0x406ad5c1u, "exp(1.3)"},
+    {0x406c169au, "log(40.)"},
+    {0x406dab2au, "log(41.)"},
+    {0x406f35fbu, "log(42.)"},
+    {0x406f7751u, "sqrt(14.)"},
+    {0x4070b781u, "log(43.)"},
+    {0x4070c7d0u, "cosh(2.)"},
+    {0x4072302au, "log(44.)"},
+    {0x4073a05cu, "log(45.)"},
+    {0x40750876u, "log(46.)"},
+    {0x407668d1u, "log(47.)"},
+    {0x4077c1c2u, "log(48.)"},
+    {0x4077def6u, "sqrt(15.)"},
+    {0x40791395u, "log(49.)"},
+    {0x407a5e96u, "log(50.)"},
+    {0x407ba308u, "log(51.)"},
+    {0x407ce12du, "log(52.)"},
+    {0x407e1943u, "log(53.)"},
+    {0x407f4b84u, "log(54.)"},
+    {0x40803c13u, "log(55.)"},
+    {0x4080cfaeu, "log(56.)"},
+    {0x408160adu, "log(57.)"},
+    {0x4081ef26u, "log(58.)"},
+    {0x40827b30u, "log(59.)"},
+    {0x408304dfu, "log(60.)"},
+    {0x40838c47u, "log(61.)"},
+    {0x4083f07bu, "sqrt(17.)"},
+    {0x4084117cu, "log(62.)"},
+    {0x4084948fu, "log(63.)"},
+    {0x40851592u, "log(64.)"},
+    {0x40859495u, "log(65.)"},
+    {0x408611a7u, "log(66.)"},
+    {0x40868cd8u, "log(67.)"},
+    {0x40870635u, "log(68.)"},
+    {0x40877dcdu, "log(69.)"},
+    {0x4087c3b6u, "sqrt(18.)"},
+    {0x4087f3acu, "log(70.)"},
+    {0x4088da73u, "log(72.)"},
+    {0x40894b72u, "log(73.)"},
+    {0x4089bae7u, "log(74.)"},
+    {0x408a28ddu, "log(75.)"},
+    {0x408a955eu, "log(76.)"},
+    {0x408b0074u, "log(77.)"},
+    {0x408b6a29u, "log(78.)"},
+    {0x408bd284u, "log(79.)"},
+    {0x408c3990u, "log(80.)"},
+    {0x408c9f54u, "log(81.)"},
+    {0x408d03d8u, "log(82.)"},
+    {0x408d6724u, "log(83.)"},
+    {0x408dc940u, "log(84.)"},
+    {0x408e2a33u, "log(85.)"},
+    {0x408e8a03u, "log(86.)"},
+    {0x408ee8b8u, "log(87.)"},
+    {0x408f4658u, "log(88.)"},
+    {0x408f69ffu, "exp(1.5)"},
+    {0x408fa2e9u, "log(89.)"},
+    {0x408ffe71u, "log(90.)"},
+    {0x409058f6u, "log(91.)"},
+    {0x4090b27eu, "log(92.)"},
+    {0x40910b0eu, "log(93.)"},
+    {0x409162acu, "log(94.)"},
+    {0x4091b95cu, "log(95.)"},
+    {0x40920f24u, "log(96.)"},
+    {0x40926408u, "log(97.)"},
+    {0x4092b80eu, "log(98.)"},
+    {0x40997774u, "sqrt(23.)"},
+    {0x409cc471u, "sqrt(24.)"},
+    {0x409e7f3eu, "exp(1.6)"},
+    {0x40a130e9u, "cosh(2.3)"},
+    {0x40a32b2bu, "sqrt(26.)"},
+    {0x40a953fdu, "sqrt(28.)"},
+    {0x40ac5345u, "sqrt(29.)"},
+    {0x40af2a94u, "exp(1.7)"},
+    {0x40b1d284u, "cosh(2.4)"},
+    {0x40b22b20u, "sqrt(31.)"},
+    {0x40b7d375u, "sqrt(33.)"},
+    {0x40ba9728u, "sqrt(34.)"},
+    {0x40c196b6u, "exp(1.8)"},
+    {0x40c2a5feu, "sqrt(37.)"},
+    {0x40c43bb7u, "cosh(2.5)"},
+    {0x40ca62c2u, "sqrt(40.)"},
+    {0x40cce665u, "sqrt(41.)"},
+    {0x40cf623au, "sqrt(42.)"},
+    {0x40d1d689u, "sqrt(43.)"},
+    {0x40d44395u, "sqrt(44.)"},
+    {0x40d5f2d9u, "exp(1.9)"},
+    {0x40d89bb1u, "cosh(2.6)"},
+    {0x40db6186u, "sqrt(47.)"},
+    {0x40e48695u, "sqrt(51.)"},
+    {0x40e6c15au, "sqrt(52.)"},
+    {0x40eb26a9u, "sqrt(54.)"},
+    {0x40ec7326u, "exp(2.)"},
+    {0x40ed517fu, "sqrt(55.)"},
+    {0x40f1983eu, "sqrt(57.)"},
+    {0x40f5cbf2u, "sqrt(59.)"},
+    {0x40fbf7dfu, "sqrt(62.)"},
+    {0x4102a8a1u, "exp(2.1)"},
+    {0x4108b43du, "sqrt(73.)"},
+    {0x410a9067u, "sqrt(75.)"},
+    {0x41106675u, "exp(2.2)"},
+    {0x411f9640u, "exp(2.3)"},
+    {0x41211525u, "cosh(3.)"},
+    {0x41305eefu, "exp(2.4)"},
+    {0x4131f1a9u, "cosh(3.1)"},
+    {0x4142eb7fu, "exp(2.5)"},
+    {0x4144961bu, "cosh(3.2)"},
+    {0x41576b77u, "exp(2.6)"},
+    {0x416e1362u, "exp(2.7)"},
+    {0x416ffad5u, "cosh(3.4)"},
+    {0x41838ea3u, "exp(2.8)"},
+    {0x41849525u, "cosh(3.5)"},
+    {0x419164a7u, "exp(2.9)"},
+    {0x41928091u, "cosh(3.6)"},
+    {0x41a0af2eu, "exp(3.)"},
+    {0x41a1e35cu, "cosh(3.7)"},
+    {0x41b19566u, "exp(3.1)"},
+    {0x41b2e4ebu, "cosh(3.8)"},
+    {0x41c442a0u, "exp(3.2)"},
+    {0x41c5b0d7u, "cosh(3.9)"},
+    {0x41d8e6afu, "exp(3.3)"},
+    {0x41da7743u, "cosh(4.)"},
+    {0x41efb67cu, "exp(3.4)"},
+    {0x41f16d6bu, "cosh(4.1)"},
+    {0x42047639u, "exp(3.5)"},
+    {0x42126497u, "exp(3.6)"},
+    {0x4221ca0bu, "exp(3.7)"},
+    {0x4222ed22u, "cosh(4.4)"},
+    {0x4232ce03u, "exp(3.8)"},
+    {0x42340e76u, "cosh(4.5)"},
+    {0x42459c1du, "exp(3.9)"},
+    {0x4246fd1cu, "cosh(4.6)"},
+    {0x425a6481u, "exp(4.)"},
+    {0x425be999u, "cosh(4.7)"},
+    {0x42715c73u, "exp(4.1)"},
+    {0x4273098fu, "cosh(4.8)"},
+    {0x42855f65u, "exp(4.2)"},
+    {0x4293664du, "exp(4.3)"},
+    {0x42a2e6d9u, "exp(4.4)"},
+    {0x42b408c5u, "exp(4.5)"},
+    {0x42c6f7f7u, "exp(4.6)"},
+    {0x42dbe4f1u, "exp(4.7)"},
+    {0x42f30558u, "exp(4.8)"},
+    {0x43064a30u, "exp(4.9)"},
+    {0xbc4afa9fu, "cos(4.7)"},
+    {0xbcef33e3u, "cos(1.6)"},
+    {0xbd6f19c7u, "sin(3.2)"},
+    {0xbde5b046u, "cos(4.6)"},
+    {0xbe03efd3u, "cos(1.7)"},
+    {0xbe218813u, "sin(3.3)"},
+    {0xbe57dadbu, "cos(4.5)"},
+    {0xbe68a7a7u, "cos(1.8)"},
+    {0xbe82d64cu, "sin(3.4)"},
+    {0xbe9d5ab9u, "cos(4.4)"},
+    {0xbea58635u, "cos(1.9)"},
+    {0xbeb399dcu, "sin(3.5)"},
+    {0xbecd3587u, "cos(4.3)"},
+    {0xbed51133u, "cos(2.)"},
+    {0xbee29207u, "sin(3.6)"},
+    {0xbefb037du, "cos(4.2)"},
+    {0xbf013d97u, "cos(2.1)"},
+    {0xbf07a358u, "sin(3.7)"},
+    {0xbf1327abu, "cos(4.1)"},
+    {0xbf16a803u, "cos(2.2)"},
+    {0xbf1ca2b7u, "sin(3.8)"},
+    {0xbf275530u, "cos(4.)"},
+    {0xbf2a9110u, "cos(2.3)"},
+    {0xbf301173u, "sin(3.9)"},
+    {0xbf39d6b2u, "cos(3.9)"},
+    {0xbf3cc5d7u, "cos(2.4)"},
+    {0xbf41bdcfu, "sin(4.)"},
+    {0xbf4a7cddu, "cos(3.8)"},
+    {0xbf4d17bfu, "cos(2.5)"},
+    {0xbf517a9bu, "sin(4.1)"},
+    {0xbf5b5d0fu, "cos(2.6)"},
+    {0xbf5f1f95u, "sin(4.2)"},
+    {0xbf6591f6u, "cos(3.6)"},
+    {0xbf677146u, "cos(2.7)"},
+    {0xbf6a89dbu, "sin(4.3)"},
+    {0xbf6fbba0u, "cos(3.5)"},
+    {0xbf71357bu, "cos(2.8)"},
+    {0xbf739c32u, "sin(4.4)"},
+    {0xbf778016u, "cos(3.4)"},
+    {0xbf7890b7u, "cos(2.9)"},
+    {0xbf7a3f6au, "sin(4.5)"},
+    {0xbf7b8203u, "sin(4.9)"},
+    {0xbf7ccb7au, "cos(3.3)"},
+    {0xbf7d7026u, "cos(3.)"},
+    {0xbf7e6288u, "sin(4.6)"},
+    {0xbf7f04a5u, "sin(4.8)"},
+    {0xbf7f903fu, "cos(3.2)"},
+    {0xbf7fc752u, "cos(3.1)"},
+    {0xbf7ffaf8u, "sin(4.7)"},
+};
+
+constexpr bool spglslKnownFloatExpressionsAreSorted() {
+  for (uint32_t i = 1; i < spglslKnownFloatExpressionsCount; ++i) {
+    if (spglslKnownFloatExpressions[i - 1].bits >= spglslKnownFloatExpressions[i].bits) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static_assert(spglslKnownFloatExpressionsAreSorted());
+
+#endif
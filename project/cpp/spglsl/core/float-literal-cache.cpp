@@ -0,0 +1,83 @@
+#include "float-literal-cache.h"
+
+#include <cstring>
+
+static inline uint32_t _floatBits(float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+static inline uint32_t _setIndex(uint32_t bits) {
+  return (bits * 0x9e3779b1u) >> (32 - SpglslFloatLiteralCache::SET_BITS);
+}
+
+////////////////////////////////////////
+//    Class SpglslFloatLiteralCache
+////////////////////////////////////////
+
+SpglslFloatLiteralCache::SpglslFloatLiteralCache() {
+  this->clear();
+}
+
+bool SpglslFloatLiteralCache::find(float value, std::string_view & literal) {
+  const uint32_t bits = _floatBits(value);
+  Slot * set = &this->_slots[_setIndex(bits) * WAYS_COUNT];
+  for (uint32_t i = 0; i < WAYS_COUNT; ++i) {
+    Slot & slot = set[i];
+    if (slot.used && slot.bits == bits) {
+      slot.referenced = true;
+      literal = std::string_view(slot.text, slot.length);
+      ++this->hits;
+      return true;
+    }
+  }
+  ++this->misses;
+  return false;
+}
+
+void SpglslFloatLiteralCache::add(float value, std::string_view literal) {
+  if (literal.length() > MAX_LITERAL_LENGTH) {
+    return;
+  }
+  const uint32_t bits = _floatBits(value);
+  const uint32_t setIndex = _setIndex(bits);
+  Slot * set = &this->_slots[setIndex * WAYS_COUNT];
+
+  Slot * target = nullptr;
+  for (uint32_t i = 0; i < WAYS_COUNT; ++i) {
+    if (!set[i].used || set[i].bits == bits) {
+      target = &set[i];
+      break;
+    }
+  }
+
+  if (!target) {
+    // CLOCK: skips and clears the slots used since the last pass, evicts the first one that was not used.
+    uint8_t & hand = this->_hands[setIndex];
+    while (set[hand].referenced) {
+      set[hand].referenced = false;
+      hand = (uint8_t)((hand + 1) % WAYS_COUNT);
+    }
+    target = &set[hand];
+    hand = (uint8_t)((hand + 1) % WAYS_COUNT);
+    ++this->evictions;
+  }
+
+  target->bits = bits;
+  target->length = (uint8_t)literal.length();
+  target->used = true;
+  target->referenced = false;
+  memcpy(target->text, literal.data(), literal.length());
+}
+
+void SpglslFloatLiteralCache::clear() {
+  for (Slot & slot : this->_slots) {
+    slot.used = false;
+    slot.referenced = false;
+  }
+  memset(this->_hands, 0, sizeof(this->_hands));
+  this->hits = 0;
+  this->misses = 0;
+  this->evictions = 0;
+}
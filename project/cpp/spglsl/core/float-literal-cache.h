@@ -0,0 +1,59 @@
+#ifndef _SPGLSL_FLOAT_LITERAL_CACHE_H_
+#define _SPGLSL_FLOAT_LITERAL_CACHE_H_
+
+#include <cstdint>
+#include <string_view>
+
+#include "non-copyable.h"
+
+/**
+ * Fixed capacity cache of the GLSL literals of float values, keyed by the bits of the float.
+ * It is set associative, each value can be stored only in the few slots of its set,
+ * when all are used the one not used for longer is evicted, with the CLOCK algorithm.
+ * It is not thread safe, every compiler owns its own.
+ */
+class SpglslFloatLiteralCache : NonCopyable {
+ public:
+  static constexpr uint32_t SET_BITS = 8;
+  static constexpr uint32_t SETS_COUNT = 1u << SET_BITS;
+  static constexpr uint32_t WAYS_COUNT = 4;
+  static constexpr uint32_t MAX_LITERAL_LENGTH = 23;
+
+  /** Number of lookups that found the value */
+  uint64_t hits = 0;
+
+  /** Number of lookups that did not find the value */
+  uint64_t misses = 0;
+
+  /** Number of values removed to make room for others */
+  uint64_t evictions = 0;
+
+  SpglslFloatLiteralCache();
+
+  inline double hitRate() const {
+    const uint64_t lookups = this->hits + this->misses;
+    return lookups != 0 ? (double)this->hits / (double)lookups : 0;
+  }
+
+  /** Finds the literal of a value, returns false if not in the cache */
+  bool find(float value, std::string_view & literal);
+
+  /** Adds the literal of a value, literals longer than MAX_LITERAL_LENGTH are not stored */
+  void add(float value, std::string_view literal);
+
+  void clear();
+
+ private:
+  struct Slot {
+    uint32_t bits;
+    uint8_t length;
+    bool used;
+    bool referenced;
+    char text[MAX_LITERAL_LENGTH];
+  };
+
+  Slot _slots[SETS_COUNT * WAYS_COUNT];
+  uint8_t _hands[SETS_COUNT];
+};
+
+#endif
@@ -0,0 +1,193 @@
+#include "float-to-decimal.h"
+
+#include <cstring>
+
+// Ryu, Ulf Adams, "Ryu: fast float-to-string conversion", PLDI 2018.
+
+static constexpr int32_t FLOAT_MANTISSA_BITS = 23;
+static constexpr int32_t FLOAT_BIAS = 127;
+static constexpr int32_t FLOAT_POW5_INV_BITCOUNT = 59;
+static constexpr int32_t FLOAT_POW5_BITCOUNT = 61;
+
+/** floor(2^(pow5bits(i) - 1 + FLOAT_POW5_INV_BITCOUNT) / 5^i) + 1 */
+static constexpr uint64_t FLOAT_POW5_INV_SPLIT[32] = {
+    0x0800000000000001ull, 0x0666666666666667ull, 0x051eb851eb851eb9ull, 0x04189374bc6a7efaull, 0x068db8bac710cb2aull,
+    0x053e2d6238da3c22ull, 0x0431bde82d7b634eull, 0x06b5fca6af2bd216ull, 0x055e63b88c230e78ull, 0x044b82fa09b5a52dull,
+    0x06df37f675ef6eaeull, 0x057f5ff85e592558ull, 0x0465e6604b7a8447ull, 0x0709709a125da071ull, 0x05a126e1a84ae6c1ull,
+    0x0480ebe7b9d58567ull, 0x0734aca5f6226f0bull, 0x05c3bd5191b525a3ull, 0x049c97747490eae9ull, 0x0760f253edb4ab0eull,
+    0x05e72843249088d8ull, 0x04b8ed0283a6d3e0ull, 0x078e480405d7b966ull, 0x060b6cd004ac9452ull, 0x04d5f0a66a23a9dbull,
+    0x07bcb43d769f762bull, 0x063090312bb2c4efull, 0x04f3a68dbc8f03f3ull, 0x07ec3daf94180651ull, 0x065697bfa9acd1daull,
+    0x051212ffbaf0a7e2ull, 0x040e7599625a1fe8ull,
+};
+
+/** The FLOAT_POW5_BITCOUNT most significant bits of 5^i */
+static constexpr uint64_t FLOAT_POW5_SPLIT[48] = {
+    0x1000000000000000ull, 0x1400000000000000ull, 0x1900000000000000ull, 0x1f40000000000000ull, 0x1388000000000000ull,
+    0x186a000000000000ull, 0x1e84800000000000ull, 0x1312d00000000000ull, 0x17d7840000000000ull, 0x1dcd650000000000ull,
+    0x12a05f2000000000ull, 0x174876e800000000ull, 0x1d1a94a200000000ull, 0x12309ce540000000ull, 0x16bcc41e90000000ull,
+    0x1c6bf52634000000ull, 0x11c37937e0800000ull, 0x16345785d8a00000ull, 0x1bc16d674ec80000ull, 0x1158e460913d0000ull,
+    0x15af1d78b58c4000ull, 0x1b1ae4d6e2ef5000ull, 0x10f0cf064dd59200ull, 0x152d02c7e14af680ull, 0x1a784379d99db420ull,
+    0x108b2a2c28029094ull, 0x14adf4b7320334b9ull, 0x19d971e4fe8401e7ull, 0x1027e72f1f128130ull, 0x1431e0fae6d7217cull,
+    0x193e5939a08ce9dbull, 0x1f8def8808b02452ull, 0x13b8b5b5056e16b3ull, 0x18a6e32246c99c60ull, 0x1ed09bead87c0378ull,
+    0x13426172c74d822bull, 0x1812f9cf7920e2b6ull, 0x1e17b84357691b64ull, 0x12ced32a16a1b11eull, 0x178287f49c4a1d66ull,
+    0x1d6329f1c35ca4bfull, 0x125dfa371a19e6f7ull, 0x16f578c4e0a060b5ull, 0x1cb2d6f618c878e3ull, 0x11efc659cf7d4b8dull,
+    0x166bb7f0435c9e71ull, 0x1c06a5ec5433c60dull, 0x118427b3b4a05bc8ull,
+};
+
+/** ceil(log2(5^e)), or 1 for e = 0 */
+static inline int32_t _pow5bits(int32_t e) {
+  return (int32_t)(((uint32_t)e * 1217359) >> 19) + 1;
+}
+
+/** floor(log10(2^e)) */
+static inline uint32_t _log10Pow2(int32_t e) {
+  return ((uint32_t)e * 78913) >> 18;
+}
+
+/** floor(log10(5^e)) */
+static inline uint32_t _log10Pow5(int32_t e) {
+  return ((uint32_t)e * 732923) >> 20;
+}
+
+static inline bool _multipleOfPowerOf5(uint32_t value, uint32_t p) {
+  uint32_t count = 0;
+  while (value != 0 && value % 5 == 0) {
+    value /= 5;
+    ++count;
+  }
+  return count >= p;
+}
+
+static inline bool _multipleOfPowerOf2(uint32_t value, uint32_t p) {
+  return (value & ((1u << p) - 1)) == 0;
+}
+
+static inline uint32_t _mulShift32(uint32_t m, uint64_t factor, int32_t shift) {
+  const uint64_t bits0 = (uint64_t)m * (uint32_t)factor;
+  const uint64_t bits1 = (uint64_t)m * (uint32_t)(factor >> 32);
+  return (uint32_t)(((bits0 >> 32) + bits1) >> (shift - 32));
+}
+
+SpglslFloatDecimal floatToShortestDecimal(float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  const uint32_t ieeeMantissa = bits & ((1u << FLOAT_MANTISSA_BITS) - 1);
+  const int32_t ieeeExponent = (int32_t)((bits >> FLOAT_MANTISSA_BITS) & 0xff);
+
+  // Step 1: the value is m2 * 2^e2, the exponent is reduced by 2 to have room for the interval bounds.
+  int32_t e2;
+  uint32_t m2;
+  if (ieeeExponent == 0) {
+    e2 = 1 - FLOAT_BIAS - FLOAT_MANTISSA_BITS - 2;
+    m2 = ieeeMantissa;
+  } else {
+    e2 = ieeeExponent - FLOAT_BIAS - FLOAT_MANTISSA_BITS - 2;
+    m2 = (1u << FLOAT_MANTISSA_BITS) | ieeeMantissa;
+  }
+  const bool acceptBounds = (m2 & 1) == 0;
+
+  // Step 2: the interval of the decimals that round to this float.
+  const uint32_t mv = 4 * m2;
+  const uint32_t mp = 4 * m2 + 2;
+  const uint32_t mmShift = ieeeMantissa != 0 || ieeeExponent <= 1;
+  const uint32_t mm = 4 * m2 - 1 - mmShift;
+
+  // Step 3: convert the interval to a decimal power base.
+  uint32_t vr, vp, vm;
+  int32_t e10;
+  bool vmIsTrailingZeros = false;
+  bool vrIsTrailingZeros = false;
+  uint32_t lastRemovedDigit = 0;
+  if (e2 >= 0) {
+    const uint32_t q = _log10Pow2(e2);
+    e10 = (int32_t)q;
+    const int32_t k = FLOAT_POW5_INV_BITCOUNT + _pow5bits((int32_t)q) - 1;
+    const int32_t i = -e2 + (int32_t)q + k;
+    vr = _mulShift32(mv, FLOAT_POW5_INV_SPLIT[q], i);
+    vp = _mulShift32(mp, FLOAT_POW5_INV_SPLIT[q], i);
+    vm = _mulShift32(mm, FLOAT_POW5_INV_SPLIT[q], i);
+    if (q != 0 && (vp - 1) / 10 <= vm / 10) {
+      // One removed digit is needed even if the loop below does not run.
+      const int32_t l = FLOAT_POW5_INV_BITCOUNT + _pow5bits((int32_t)(q - 1)) - 1;
+      lastRemovedDigit = _mulShift32(mv, FLOAT_POW5_INV_SPLIT[q - 1], -e2 + (int32_t)q - 1 + l) % 10;
+    }
+    if (q <= 9) {
+      if (mv % 5 == 0) {
+        vrIsTrailingZeros = _multipleOfPowerOf5(mv, q);
+      } else if (acceptBounds) {
+        vmIsTrailingZeros = _multipleOfPowerOf5(mm, q);
+      } else {
+        vp -= _multipleOfPowerOf5(mp, q);
+      }
+    }
+  } else {
+    const uint32_t q = _log10Pow5(-e2);
+    e10 = (int32_t)q + e2;
+    const int32_t i = -e2 - (int32_t)q;
+    const int32_t k = _pow5bits(i) - FLOAT_POW5_BITCOUNT;
+    int32_t j = (int32_t)q - k;
+    vr = _mulShift32(mv, FLOAT_POW5_SPLIT[i], j);
+    vp = _mulShift32(mp, FLOAT_POW5_SPLIT[i], j);
+    vm = _mulShift32(mm, FLOAT_POW5_SPLIT[i], j);
+    if (q != 0 && (vp - 1) / 10 <= vm / 10) {
+      j = (int32_t)q - 1 - (_pow5bits(i + 1) - FLOAT_POW5_BITCOUNT);
+      lastRemovedDigit = _mulShift32(mv, FLOAT_POW5_SPLIT[i + 1], j) % 10;
+    }
+    if (q <= 1) {
+      vrIsTrailingZeros = true;
+      if (acceptBounds) {
+        vmIsTrailingZeros = mmShift == 1;
+      } else {
+        --vp;
+      }
+    } else if (q < 31) {
+      vrIsTrailingZeros = _multipleOfPowerOf2(mv, q - 1);
+    }
+  }
+
+  // Step 4: remove digits while the interval still contains a shorter decimal.
+  int32_t removed = 0;
+  uint32_t output;
+  if (vmIsTrailingZeros || vrIsTrailingZeros) {
+    while (vp / 10 > vm / 10) {
+      vmIsTrailingZeros &= vm % 10 == 0;
+      vrIsTrailingZeros &= lastRemovedDigit == 0;
+      lastRemovedDigit = vr % 10;
+      vr /= 10;
+      vp /= 10;
+      vm /= 10;
+      ++removed;
+    }
+    if (vmIsTrailingZeros) {
+      while (vm % 10 == 0) {
+        vrIsTrailingZeros &= lastRemovedDigit == 0;
+        lastRemovedDigit = vr % 10;
+        vr /= 10;
+        vp /= 10;
+        vm /= 10;
+        ++removed;
+      }
+    }
+    if (vrIsTrailingZeros && lastRemovedDigit == 5 && vr % 2 == 0) {
+      // The exact value is ...50..0, round to even.
+      lastRemovedDigit = 4;
+    }
+    output = vr + ((vr == vm && (!acceptBounds || !vmIsTrailingZeros)) || lastRemovedDigit >= 5);
+  } else {
+    while (vp / 10 > vm / 10) {
+      lastRemovedDigit = vr % 10;
+      vr /= 10;
+      vp /= 10;
+      vm /= 10;
+      ++removed;
+    }
+    output = vr + (vr == vm || lastRemovedDigit >= 5);
+  }
+
+  SpglslFloatDecimal result{output, e10 + removed};
+  while (result.digits != 0 && result.digits % 10 == 0) {
+    result.digits /= 10;
+    ++result.exponent;
+  }
+  return result;
+}
@@ -0,0 +1,22 @@
+#ifndef _SPGLSL_FLOAT_TO_DECIMAL_H_
+#define _SPGLSL_FLOAT_TO_DECIMAL_H_
+
+#include <cstdint>
+
+/** A decimal number, digits * 10^exponent */
+struct SpglslFloatDecimal {
+  /** Significant digits, without trailing zeros */
+  uint32_t digits;
+
+  /** Power of ten of the last digit */
+  int32_t exponent;
+};
+
+/**
+ * Computes the shortest decimal that converts back to the same float, using the Ryu algorithm.
+ * When more decimals of the same length are possible, the closest to the exact value is returned.
+ * The value must be finite and greater than zero.
+ */
+SpglslFloatDecimal floatToShortestDecimal(float value);
+
+#endif
@@ -0,0 +1,29 @@
+#include "gzip-size.h"
+
+#include <zlib.h>
+
+size_t gzipSize(const char * data, size_t size) {
+  z_stream stream{};
+
+  // windowBits 15 + 16 writes a gzip header and trailer, memLevel 8 is the zlib and nodejs default.
+  if (deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+    return size;
+  }
+
+  unsigned char chunk[16384];
+  size_t result = 0;
+
+  stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+  stream.avail_in = static_cast<uInt>(size);
+
+  int status;
+  do {
+    stream.next_out = chunk;
+    stream.avail_out = sizeof(chunk);
+    status = deflate(&stream, Z_FINISH);
+    result += sizeof(chunk) - stream.avail_out;
+  } while (status == Z_OK);
+
+  deflateEnd(&stream);
+  return status == Z_STREAM_END ? result : size;
+}
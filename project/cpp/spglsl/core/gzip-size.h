@@ -0,0 +1,14 @@
+#ifndef _SPGLSL_GZIP_SIZE_H_
+#define _SPGLSL_GZIP_SIZE_H_
+
+#include <cstddef>
+#include <string>
+
+/** Size in bytes of the data compressed with gzip at maximum level, as node zlib.gzipSync(data, { level: 9 }) */
+size_t gzipSize(const char * data, size_t size);
+
+inline size_t gzipSize(const std::string & data) {
+  return gzipSize(data.data(), data.size());
+}
+
+#endif
@@ -1,8 +1,16 @@
 #ifndef _SPGLSL_HASH_STREAM_H_
 #define _SPGLSL_HASH_STREAM_H_
 
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <string>
+
 #include "../external/highwayhash/highwayhash.h"
 
+#define XXH_INLINE_ALL
+#include <xxhash.h>
+
 struct SpglslHashValue {
   union {
     struct {
@@ -26,149 +34,257 @@ struct SpglslHashValue {
   }
 };
 
-class SpglslHasher {
+namespace std {
+  template <>
+  struct hash<SpglslHashValue> {
+    inline size_t operator()(const SpglslHashValue & value) const {
+      return (size_t)value.a;
+    }
+  };
+}  // namespace std
+
+/** 256 bits HighwayHash, strong enough to be used as a persistent key */
+struct SpglslHighwayHash256Policy {
+  typedef SpglslHashValue HashValue;
+  typedef highwayhash::HighwayHashCat State;
+
+  static inline void reset(State & state) {
+    const uint64_t hkey[4] = {0x125231, 0x876832, 0x8876263, 0x7486864};
+    highwayhash::HighwayHashCatStart(hkey, &state);
+  }
+
+  /** size is a multiple of 32 bytes */
+  static inline void update(State & state, const uint8_t * data, size_t size) {
+    highwayhash::HighwayHashUpdatePackets(data, size / 32, &state.state);
+  }
+
+  static inline void finish(const State & state, const uint8_t * tail, size_t size, HashValue & result) {
+    State copy = state;
+    highwayhash::HighwayHashCatAppend(tail, size, &copy);
+    highwayhash::HighwayHashCatFinish256(&copy, result.data);
+  }
+};
+
+/** 64 bits xxhash, for in memory change detection and equality checks */
+struct SpglslXXHash64Policy {
+  typedef uint64_t HashValue;
+  typedef XXH64_state_t State;
+
+  static inline void reset(State & state) {
+    XXH64_reset(&state, 0x125231876832);
+  }
+
+  static inline void update(State & state, const uint8_t * data, size_t size) {
+    XXH64_update(&state, data, size);
+  }
+
+  static inline void finish(const State & state, const uint8_t * tail, size_t size, HashValue & result) {
+    State copy = state;
+    XXH64_update(&copy, tail, size);
+    result = XXH64_digest(&copy);
+  }
+};
+
+/**
+ * Streaming hasher, the hash algorithm is given by HashPolicy.
+ * Writes are staged in a 32 bytes aligned buffer and the hash is fed whole buffers,
+ * the digest is the same as hashing every single write one after the other.
+ */
+template <typename HashPolicy>
+class SpglslHasherT {
  public:
-  highwayhash::HighwayHashCat state;
+  typedef typename HashPolicy::HashValue HashValue;
+
+  /** Size of the staging buffer, a multiple of the HighwayHash 32 bytes packet size */
+  static constexpr size_t BUFFER_SIZE = 256;
 
-  inline SpglslHasher() {
+  inline SpglslHasherT() {
     this->resetHash();
   }
 
-  inline SpglslHasher & resetHash() {
-    const uint64_t hkey[4] = {0x125231, 0x876832, 0x8876263, 0x7486864};
-    highwayhash::HighwayHashCatStart(hkey, &this->state);
+  inline SpglslHasherT & resetHash() {
+    HashPolicy::reset(this->_state);
+    this->_bufferSize = 0;
     return *this;
   }
 
-  inline SpglslHasher & begin(int header = 0) {
+  inline SpglslHasherT & begin(int header = 0) {
     int h[2] = {0xAC0FFEE, header};
-    highwayhash::HighwayHashCatAppend((const uint8_t *)&h, sizeof(h), &this->state);
+    this->append(&h, sizeof(h));
     return *this;
   }
 
-  inline SpglslHasher & end() {
+  inline SpglslHasherT & end() {
     int h[2] = {0x3C123ABC, 0xABBA};
-    highwayhash::HighwayHashCatAppend((const uint8_t *)&h, sizeof(h), &this->state);
+    this->append(&h, sizeof(h));
     return *this;
   }
 
-  inline SpglslHasher & write(const char * value) {
+  inline SpglslHasherT & write(const char * value) {
     if (value != nullptr) {
-      highwayhash::HighwayHashCatAppend((const uint8_t *)&value, strlen(value) + 1, &this->state);
+      this->append(value, strlen(value) + 1);
     }
     return *this;
   }
 
-  inline SpglslHasher & write(const std::string & value) {
-    highwayhash::HighwayHashCatAppend((const uint8_t *)value.c_str(), value.size() + 1, &this->state);
+  inline SpglslHasherT & write(const std::string & value) {
+    this->append(value.c_str(), value.size() + 1);
     return *this;
   }
 
-  inline SpglslHasher & write(const bool value) {
+  inline SpglslHasherT & write(const bool value) {
     char v = value ? 1 : 0;
-    highwayhash::HighwayHashCatAppend((const uint8_t *)&v, sizeof(v), &this->state);
+    this->append(&v, sizeof(v));
     return *this;
   }
 
-  inline SpglslHasher & write(const char value) {
-    highwayhash::HighwayHashCatAppend((const uint8_t *)&value, sizeof(value), &this->state);
+  inline SpglslHasherT & write(const char value) {
+    this->append(&value, sizeof(value));
     return *this;
   }
 
-  inline SpglslHasher & write(const unsigned char value) {
-    highwayhash::HighwayHashCatAppend((const uint8_t *)&value, sizeof(value), &this->state);
+  inline SpglslHasherT & write(const unsigned char value) {
+    this->append(&value, sizeof(value));
     return *this;
   }
 
-  inline SpglslHasher & write(const short value) {
-    highwayhash::HighwayHashCatAppend((const uint8_t *)&value, sizeof(value), &this->state);
+  inline SpglslHasherT & write(const short value) {
+    this->append(&value, sizeof(value));
     return *this;
   }
 
-  inline SpglslHasher & write(const unsigned short value) {
-    highwayhash::HighwayHashCatAppend((const uint8_t *)&value, sizeof(value), &this->state);
+  inline SpglslHasherT & write(const unsigned short value) {
+    this->append(&value, sizeof(value));
     return *this;
   }
 
-  inline SpglslHasher & write(const int value) {
-    highwayhash::HighwayHashCatAppend((const uint8_t *)&value, sizeof(value), &this->state);
+  inline SpglslHasherT & write(const int value) {
+    this->append(&value, sizeof(value));
     return *this;
   }
 
-  inline SpglslHasher & write(const unsigned int value) {
-    highwayhash::HighwayHashCatAppend((const uint8_t *)&value, sizeof(value), &this->state);
+  inline SpglslHasherT & write(const unsigned int value) {
+    this->append(&value, sizeof(value));
     return *this;
   }
 
-  inline SpglslHasher & write(const nullptr_t) {
+  inline SpglslHasherT & write(const std::nullptr_t) {
     auto value = nullptr;
-    highwayhash::HighwayHashCatAppend((const uint8_t *)&value, sizeof(nullptr_t), &this->state);
+    this->append(&value, sizeof(std::nullptr_t));
+    return *this;
+  }
+
+  // long and long long are distinct types, size_t, int64_t and uint64_t are aliases of one of them.
+
+  inline SpglslHasherT & write(const long value) {
+    this->append(&value, sizeof(value));
     return *this;
   }
 
-  inline SpglslHasher & write(const size_t value) {
-    highwayhash::HighwayHashCatAppend((const uint8_t *)&value, sizeof(value), &this->state);
+  inline SpglslHasherT & write(const unsigned long value) {
+    this->append(&value, sizeof(value));
     return *this;
   }
 
-  inline SpglslHasher & write(const int64_t value) {
-    highwayhash::HighwayHashCatAppend((const uint8_t *)&value, sizeof(value), &this->state);
+  inline SpglslHasherT & write(const long long value) {
+    this->append(&value, sizeof(value));
     return *this;
   }
 
-  inline SpglslHasher & write(const uint64_t value) {
-    highwayhash::HighwayHashCatAppend((const uint8_t *)&value, sizeof(value), &this->state);
+  inline SpglslHasherT & write(const unsigned long long value) {
+    this->append(&value, sizeof(value));
     return *this;
   }
 
-  inline SpglslHasher & write(const float value) {
-    highwayhash::HighwayHashCatAppend((const uint8_t *)&value, sizeof(value), &this->state);
+  inline SpglslHasherT & write(const float value) {
+    this->append(&value, sizeof(value));
     return *this;
   }
 
-  inline SpglslHasher & write(const double value) {
-    highwayhash::HighwayHashCatAppend((const uint8_t *)&value, sizeof(value), &this->state);
+  inline SpglslHasherT & write(const double value) {
+    this->append(&value, sizeof(value));
     return *this;
   }
 
   template <typename T>
-  inline SpglslHasher & writeStruct(const T & value) {
-    highwayhash::HighwayHashCatAppend((const uint8_t *)&value, sizeof(T), &this->state);
+  inline SpglslHasherT & writeStruct(const T & value) {
+    this->append(&value, sizeof(T));
     return *this;
   }
 
   template <typename T>
-  inline SpglslHasher & writeStruct(const T * value) {
-    highwayhash::HighwayHashCatAppend((const uint8_t *)value, sizeof(T), &this->state);
+  inline SpglslHasherT & writeStruct(const T * value) {
+    this->append(value, sizeof(T));
     return *this;
   }
 
   template <typename T>
-  inline SpglslHasher & writePtr(const T * ptr, size_t size) {
-    highwayhash::HighwayHashCatAppend((const uint8_t *)ptr, size * sizeof(T), &this->state);
+  inline SpglslHasherT & writePtr(const T * ptr, size_t size) {
+    this->append(ptr, size * sizeof(T));
     return *this;
   }
 
-  inline SpglslHashValue & digest(SpglslHashValue & result) const {
-    highwayhash::HighwayHashCatFinish256(&this->state, result.data);
-    return result;
+  inline SpglslHasherT & append(const void * data, size_t size) {
+    size_t bufferSize = this->_bufferSize;
+    if (bufferSize + size < BUFFER_SIZE) {
+      memcpy(this->_buffer + bufferSize, data, size);
+      this->_bufferSize = bufferSize + size;
+    } else {
+      this->_appendAndFlush((const uint8_t *)data, size);
+    }
+    return *this;
   }
 
-  inline SpglslHashValue digest() const {
-    SpglslHashValue result;
-    highwayhash::HighwayHashCatFinish256(&this->state, result.data);
+  inline HashValue & digest(HashValue & result) const {
+    HashPolicy::finish(this->_state, this->_buffer, this->_bufferSize, result);
     return result;
   }
 
-  inline bool digestChanged(SpglslHashValue & hashValue) const {
-    SpglslHashValue temp;
-    highwayhash::HighwayHashCatFinish256(&this->state, temp.data);
+  inline HashValue digest() const {
+    HashValue result{};
+    return this->digest(result);
+  }
+
+  inline bool digestChanged(HashValue & hashValue) const {
+    HashValue temp{};
+    this->digest(temp);
     if (temp != hashValue) {
       hashValue = temp;
       return true;
     }
     return false;
   }
+
+ private:
+  typename HashPolicy::State _state;
+  alignas(32) uint8_t _buffer[BUFFER_SIZE];
+  size_t _bufferSize = 0;
+
+  void _appendAndFlush(const uint8_t * data, size_t size) {
+    // Fill and hash the staging buffer.
+    size_t fill = BUFFER_SIZE - this->_bufferSize;
+    memcpy(this->_buffer + this->_bufferSize, data, fill);
+    HashPolicy::update(this->_state, this->_buffer, BUFFER_SIZE);
+    data += fill;
+    size -= fill;
+
+    // Hash the whole buffers directly from the input.
+    size_t whole = size - size % BUFFER_SIZE;
+    if (whole != 0) {
+      HashPolicy::update(this->_state, data, whole);
+      data += whole;
+      size -= whole;
+    }
+
+    memcpy(this->_buffer, data, size);
+    this->_bufferSize = size;
+  }
 };
 
+/** HighwayHash 256 bits hasher */
+typedef SpglslHasherT<SpglslHighwayHash256Policy> SpglslHasher;
+
+/** xxhash 64 bits hasher */
+typedef SpglslHasherT<SpglslXXHash64Policy> SpglslFastHasher;
+
 #endif
@@ -4,14 +4,16 @@
 
 #include <algorithm>
 #include <cfloat>
+#include <cmath>
+#include <cstring>
 #include <sstream>
 
 #include "../spglsl-init.h"
+#include "float-known-expressions-autogen.h"
+#include "float-literal-cache.h"
+#include "float-to-decimal.h"
 #include "string-utils.h"
 
-std::unordered_map<float, std::string> _floatToGlslCache;
-std::unordered_map<std::string, std::string> _knownConversions;
-
 static const std::string PositiveInfinity = "(1./0.)";
 static const std::string ParentesizedPositiveInfinity = "(1./0.)";
 
@@ -48,88 +50,151 @@ bool floatIsInfinity(float value) {
   return std::isinf(value) || gl::isInf(value);
 }
 
-std::string _floatToGlslInner(float value, bool scientific = false) {
-  std::string s;
-  float diff = 0;
-  for (int i = 8; i >= 0; --i) {
-    std::stringstream ss;
-    if (scientific) {
-      ss.unsetf(std::ios::fixed);
-      ss.setf(std::ios::scientific);
+/** Writes the decimal digits of a value, returns the number of characters written */
+static size_t _writeDecimal(char * out, uint64_t value) {
+  char tmp[20];
+  size_t length = 0;
+  do {
+    tmp[length++] = (char)('0' + value % 10);
+    value /= 10;
+  } while (value != 0);
+  for (size_t i = 0; i < length; ++i) {
+    out[i] = tmp[length - 1 - i];
+  }
+  return length;
+}
+
+/**
+ * Writes a decimal as a GLSL literal in fixed or in scientific notation, the shortest, fixed is preferred if equal.
+ * If exactIntegers is true, integers in fixed notation are written with all the digits of the float value.
+ */
+static std::string _decimalToGlsl(float value, const SpglslFloatDecimal & decimal, bool exactIntegers) {
+  const float absValue = std::abs(value);
+  char digits[10];
+  const int32_t digitsLength = (int32_t)_writeDecimal(digits, decimal.digits);
+
+  char fixed[64];
+  size_t fixedLength = 0;
+  if (value < 0) {
+    fixed[fixedLength++] = '-';
+  }
+  if (decimal.exponent >= 0) {
+    if (exactIntegers && absValue < 18446744073709551616.0f) {
+      fixedLength += _writeDecimal(fixed + fixedLength, (uint64_t)absValue);
     } else {
-      ss.setf(std::ios::fixed);
-      ss.unsetf(std::ios::scientific);
+      memcpy(fixed + fixedLength, digits, digitsLength);
+      fixedLength += digitsLength;
+      memset(fixed + fixedLength, '0', decimal.exponent);
+      fixedLength += decimal.exponent;
     }
-    ss.precision(i);
-    ss << value;
-
-    float v = std::stof(ss.str());
-    float ndiff = std::abs(v - value);
-    if (ndiff <= diff || s.empty() || v == value) {
-      ndiff = diff;
-      s = ss.str();
+    fixed[fixedLength++] = '.';
+  } else {
+    const int32_t pointPosition = digitsLength + decimal.exponent;
+    if (pointPosition > 0) {
+      memcpy(fixed + fixedLength, digits, pointPosition);
+      fixedLength += pointPosition;
+      fixed[fixedLength++] = '.';
+      memcpy(fixed + fixedLength, digits + pointPosition, digitsLength - pointPosition);
+      fixedLength += digitsLength - pointPosition;
+    } else {
+      fixed[fixedLength++] = '.';
+      memset(fixed + fixedLength, '0', -pointPosition);
+      fixedLength += -pointPosition;
+      memcpy(fixed + fixedLength, digits, digitsLength);
+      fixedLength += digitsLength;
     }
   }
 
-  bool hasDot = s.find('.') != std::string::npos;
-
-  if (s.size() > 1 && s[0] == '+') {
-    s.erase(0, 1);
+  const int32_t scientificExponent = decimal.exponent + digitsLength - 1;
+  if (scientificExponent == 0) {
+    return std::string(fixed, fixedLength);
   }
 
-  auto expSplit = stringSplit(s, "e");
-  bool isExponential = expSplit.size() > 1;
-  if (isExponential) {
-    s = expSplit[0] + "e" + std::to_string(std::stoi(expSplit[1]));
-  }
-  if (s.size() > 2 && s[s.size() - 2] == 'e' && s[s.size() - 1] == '0') {
-    s = s.substr(0, s.size() - 2);
-    isExponential = false;
-  }
-
-  if (!isExponential && !hasDot) {
-    s += '.';
-  }
-  if (hasDot) {
-    while (s.size() > 1 && s[s.size() - 1] == '0') {
-      s.erase(s.size() - 1, 1);
-    }
-  }
-  if (s.size() > 2 && s[0] == '0' && s[1] == '.') {
-    s.erase(0, 1);
+  char scientific[32];
+  size_t scientificLength = 0;
+  if (value < 0) {
+    scientific[scientificLength++] = '-';
   }
-  if (s.size() > 3 && s[0] == '-' && s[1] == '0' && s[2] == '.') {
-    s.erase(0, 2);
-    s = "-" + s;
+  scientific[scientificLength++] = digits[0];
+  if (digitsLength > 1) {
+    scientific[scientificLength++] = '.';
+    memcpy(scientific + scientificLength, digits + 1, digitsLength - 1);
+    scientificLength += digitsLength - 1;
   }
-  if (s == "." || s == "-." || s == "-0.") {
-    return "0.";
+  scientific[scientificLength++] = 'e';
+  if (scientificExponent < 0) {
+    scientific[scientificLength++] = '-';
   }
-  if (s.empty()) {
+  scientificLength += _writeDecimal(scientific + scientificLength, (uint64_t)std::abs(scientificExponent));
+
+  return fixedLength <= scientificLength ? std::string(fixed, fixedLength)
+                                         : std::string(scientific, scientificLength);
+}
+
+/**
+ * The shortest GLSL literal of a finite float.
+ * It is built from the shortest decimal that converts back to the same float.
+ */
+std::string _floatToGlslShortest(float value) {
+  const float absValue = std::abs(value);
+  if (!(absValue > 0)) {
     return "0.";
   }
+  return _decimalToGlsl(value, floatToShortestDecimal(absValue), true);
+}
 
-  return s;
+/** Rounds a value to the given number of mantissa bits, ties to even */
+static double _roundToMantissaBits(double value, int mantissaBits) {
+  int exponent;
+  const double mantissa = std::frexp(value, &exponent);
+  return std::ldexp(std::nearbyint(std::ldexp(mantissa, mantissaBits + 1)), exponent - mantissaBits - 1);
 }
 
-void _initKnownConversions() {
-  _knownConversions[_floatToGlslInner(3.141592653589793f)] = "acos(-1.)";
-  _knownConversions[_floatToGlslInner(3.141592653589793f * 2)] = "(acos(-1.)*2.)";
-  _knownConversions[_floatToGlslInner(1.5707963267948966f)] = "acos(0.)";
-
-  for (int i = 0; i < 50; ++i) {
-    float f = ((float)i) / 10.0f;
-    _knownConversions[_floatToGlslInner(cosf(f))] = "cos(" + _floatToGlslInner(f) + ")";
-    _knownConversions[_floatToGlslInner(sin(f))] = "sin(" + _floatToGlslInner(f) + ")";
-    _knownConversions[_floatToGlslInner(expf(f))] = "exp(" + _floatToGlslInner(f) + ")";
-    _knownConversions[_floatToGlslInner(sqrtf(f))] = "sqrt(" + _floatToGlslInner(f) + ")";
-    _knownConversions[_floatToGlslInner(atanf(f))] = "atan(" + _floatToGlslInner(f) + ")";
-    _knownConversions[_floatToGlslInner(asinhf(f))] = "asinh(" + _floatToGlslInner(f) + ")";
-    _knownConversions[_floatToGlslInner(coshf(f))] = "cosh(" + _floatToGlslInner(f) + ")";
+/**
+ * The shortest GLSL literal of a finite float that has the same value when rounded to the given mantissa bits.
+ * Used for literals consumed by mediump or lowp expressions, where the other digits are lost.
+ */
+static std::string _floatToGlslReduced(float value, int mantissaBits) {
+  const float absValue = std::abs(value);
+  const double target = _roundToMantissaBits(absValue, mantissaBits);
+  const int32_t firstExponent = (int32_t)std::floor(std::log10((double)absValue));
+  for (int32_t digitsCount = 1; digitsCount < 9; ++digitsCount) {
+    const int32_t exponent = firstExponent - digitsCount + 1;
+    const double scale = std::pow(10.0, std::abs(exponent));
+    const double nearest = std::nearbyint(exponent < 0 ? absValue * scale : absValue / scale);
+    // The nearest decimal may round the other way at low precision, its neighbours are tried too.
+    for (const double digits : {nearest, nearest + 1, nearest - 1}) {
+      const double candidate = exponent < 0 ? digits / scale : digits * scale;
+      // The literal is first converted to a float by the GLSL compiler, then to the lower precision.
+      if (digits > 0 && _roundToMantissaBits((float)candidate, mantissaBits) == target) {
+        SpglslFloatDecimal decimal{(uint32_t)digits, exponent};
+        while (decimal.digits % 10 == 0) {
+          decimal.digits /= 10;
+          ++decimal.exponent;
+        }
+        return _decimalToGlsl(value, decimal, false);
+      }
+    }
   }
+  return _floatToGlslShortest(value);
 }
 
-std::string floatToGlsl(float value, bool needsParentheses, bool needsFloat) {
+/** A GLSL expression that evaluates exactly to the given value, or an empty string */
+static std::string_view _findKnownExpression(float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  const SpglslKnownFloatExpression * begin = spglslKnownFloatExpressions;
+  const SpglslKnownFloatExpression * end = begin + spglslKnownFloatExpressionsCount;
+  const SpglslKnownFloatExpression * found = std::lower_bound(
+      begin, end, bits, [](const SpglslKnownFloatExpression & item, uint32_t key) { return item.bits < key; });
+  return found != end && found->bits == bits ? found->expression : std::string_view();
+}
+
+std::string floatToGlsl(float value,
+    bool needsParentheses,
+    bool needsFloat,
+    SpglslFloatLiteralCache * cache,
+    int mantissaBits) {
   if (floatIsNaN(value)) {
     return needsParentheses ? ParentesizedNaN : NaN;
   }
@@ -151,37 +216,25 @@ std::string floatToGlsl(float value, bool needsParentheses, bool needsFloat) {
 
   std::string result;
 
-  auto cached = _floatToGlslCache.find(value);
-  if (cached != _floatToGlslCache.end()) {
-    result = cached->second;
+  std::string_view cached;
+  if (mantissaBits < FLOAT_MANTISSA_BITS_HIGHP && absValue >= FLOAT_MEDIUMP_MIN && absValue <= FLOAT_MEDIUMP_MAX) {
+    result = _floatToGlslReduced(value, mantissaBits);
+  } else if (cache && cache->find(value, cached)) {
+    result = cached;
   } else {
-    auto s1 = _floatToGlslInner(value, false);
-    auto s2 = _floatToGlslInner(value, true);
-    result = s1.size() <= s2.size() ? s1 : s2;
-
-    if (_floatToGlslCache.size() > 8000) {
-      for (auto p : _floatToGlslCache) {
-        _floatToGlslCache.erase(p.first);
-        if (_floatToGlslCache.size() <= 4000) {
-          break;
-        }
-      }
+    result = _floatToGlslShortest(value);
+    if (cache) {
+      cache->add(value, result);
     }
-
-    _floatToGlslCache[value] = result;
   }
 
   if (!needsFloat && result[result.size() - 1] == '.') {
     result.erase(result.size() - 1, 1);
   }
 
-  if (_knownConversions.empty()) {
-    _initKnownConversions();
-  }
-
-  auto knownConversion = _knownConversions.find(result);
-  if (knownConversion != _knownConversions.end() && knownConversion->second.size() <= result.size()) {
-    return knownConversion->second;
+  const std::string_view knownExpression = _findKnownExpression(value);
+  if (!knownExpression.empty() && knownExpression.size() <= result.size()) {
+    return std::string(knownExpression);
   }
 
   return result;
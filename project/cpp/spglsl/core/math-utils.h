@@ -3,6 +3,8 @@
 
 #include <string>
 
+class SpglslFloatLiteralCache;
+
 bool floatIsNaN(float value);
 bool floatIsInfinity(float value);
 
@@ -26,6 +28,27 @@ inline std::string uint32ToGlsl(uint32_t value) {
   return result += 'u';
 }
 
-std::string floatToGlsl(float value, bool needsParentheses, bool needsFloat = true);
+/** Mantissa bits of highp floats, literals keep the full float precision */
+constexpr int FLOAT_MANTISSA_BITS_HIGHP = 23;
+
+/** Mantissa bits of mediump floats, as half precision floats */
+constexpr int FLOAT_MANTISSA_BITS_MEDIUMP = 10;
+
+/** Mantissa bits of lowp floats, GLSL ES requires a relative precision of 2^-8 */
+constexpr int FLOAT_MANTISSA_BITS_LOWP = 8;
+
+/** Range of half precision floats, literals outside of it are always written with full precision */
+constexpr float FLOAT_MEDIUMP_MIN = 6.103515625e-05f;
+constexpr float FLOAT_MEDIUMP_MAX = 65504.0f;
+
+/**
+ * Shortest GLSL literal of a float, the cache is optional and avoids formatting the same value again.
+ * With less than FLOAT_MANTISSA_BITS_HIGHP mantissa bits the literal is only as precise as needed at that precision.
+ */
+std::string floatToGlsl(float value,
+    bool needsParentheses,
+    bool needsFloat = true,
+    SpglslFloatLiteralCache * cache = nullptr,
+    int mantissaBits = FLOAT_MANTISSA_BITS_HIGHP);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,104 @@
+#include "string-set.h"
+
+#include <cstring>
+#include <utility>
+
+uint64_t SpglslStringSet::_hash(std::string_view value) {
+  uint64_t h = 0xcbf29ce484222325ull;
+  for (char c : value) {
+    h = (h ^ (uint8_t)c) * 0x100000001b3ull;
+  }
+  return h ^ (h >> 32);
+}
+
+bool SpglslStringSet::has(std::string_view value) const {
+  if (value.empty()) {
+    return this->_hasEmpty;
+  }
+  const size_t capacity = this->_slots.size();
+  if (capacity == 0) {
+    return false;
+  }
+  for (size_t i = (size_t)_hash(value) & (capacity - 1);; i = (i + 1) & (capacity - 1)) {
+    const std::string_view & slot = this->_slots[i];
+    if (slot.empty()) {
+      return false;
+    }
+    if (slot == value) {
+      return true;
+    }
+  }
+}
+
+bool SpglslStringSet::add(std::string_view value) {
+  if (value.empty()) {
+    if (this->_hasEmpty) {
+      return false;
+    }
+    this->_hasEmpty = true;
+    ++this->_size;
+    return true;
+  }
+  // Keeps the load factor under one half, so the probe sequences stay short.
+  if ((this->_size + 1) * 2 > this->_slots.size()) {
+    this->_grow();
+  }
+  const size_t capacity = this->_slots.size();
+  for (size_t i = (size_t)_hash(value) & (capacity - 1);; i = (i + 1) & (capacity - 1)) {
+    std::string_view & slot = this->_slots[i];
+    if (slot.empty()) {
+      slot = this->_intern(value);
+      ++this->_size;
+      return true;
+    }
+    if (slot == value) {
+      return false;
+    }
+  }
+}
+
+void SpglslStringSet::clear() {
+  this->_size = 0;
+  this->_hasEmpty = false;
+  this->_slots.clear();
+  this->_chunks.clear();
+  this->_chunkUsed = ARENA_CHUNK_SIZE;
+}
+
+std::string_view SpglslStringSet::_intern(std::string_view value) {
+  const size_t length = value.size();
+  char * data;
+  if (length > ARENA_CHUNK_SIZE / 4) {
+    // Long strings get their own chunk, the current chunk can still be filled.
+    this->_chunks.emplace_back(new char[length]);
+    data = this->_chunks.back().get();
+    if (this->_chunks.size() > 1) {
+      std::swap(this->_chunks[this->_chunks.size() - 1], this->_chunks[this->_chunks.size() - 2]);
+    }
+  } else {
+    if (this->_chunkUsed + length > ARENA_CHUNK_SIZE) {
+      this->_chunks.emplace_back(new char[ARENA_CHUNK_SIZE]);
+      this->_chunkUsed = 0;
+    }
+    data = this->_chunks.back().get() + this->_chunkUsed;
+    this->_chunkUsed += length;
+  }
+  memcpy(data, value.data(), length);
+  return std::string_view(data, length);
+}
+
+void SpglslStringSet::_grow() {
+  std::vector<std::string_view> old;
+  old.swap(this->_slots);
+  this->_slots.resize(old.empty() ? 32 : old.size() * 2);
+  const size_t capacity = this->_slots.size();
+  for (const std::string_view & value : old) {
+    if (!value.empty()) {
+      size_t i = (size_t)_hash(value) & (capacity - 1);
+      while (!this->_slots[i].empty()) {
+        i = (i + 1) & (capacity - 1);
+      }
+      this->_slots[i] = value;
+    }
+  }
+}
@@ -0,0 +1,44 @@
+#ifndef _SPGLSL_STRING_SET_H_
+#define _SPGLSL_STRING_SET_H_
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "non-copyable.h"
+
+/**
+ * A small set of strings with open addressing and linear probing.
+ * Added strings are copied in an internal arena, lookups do not allocate.
+ */
+class SpglslStringSet : NonCopyable {
+ public:
+  SpglslStringSet() = default;
+
+  inline size_t size() const {
+    return this->_size;
+  }
+
+  bool has(std::string_view value) const;
+
+  /** Adds a string, returns false if it was already in the set */
+  bool add(std::string_view value);
+
+  void clear();
+
+ private:
+  static constexpr size_t ARENA_CHUNK_SIZE = 4096;
+
+  size_t _size = 0;
+  bool _hasEmpty = false;
+  std::vector<std::string_view> _slots;
+  std::vector<std::unique_ptr<char[]>> _chunks;
+  size_t _chunkUsed = ARENA_CHUNK_SIZE;
+
+  static uint64_t _hash(std::string_view value);
+  std::string_view _intern(std::string_view value);
+  void _grow();
+};
+
+#endif
@@ -4,6 +4,15 @@
 #include <stdlib.h>
 #include <string.h>
 
+/* Vectorized backends, selected at build time. */
+#if defined(__wasm_simd128__)
+#  include <wasm_simd128.h>
+#  define HIGHWAYHASH_SIMD128 1
+#elif (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#  include <immintrin.h>
+#  define HIGHWAYHASH_AVX2 1
+#endif
+
 namespace highwayhash {
 
   /*
@@ -71,6 +80,125 @@ namespace highwayhash {
     Update(lanes, state);
   }
 
+  static void UpdatePacketsScalar(const uint8_t * packets, size_t count, HighwayHashState * state) {
+    size_t i;
+    for (i = 0; i < count; ++i) {
+      HighwayHashUpdatePacket(packets + i * 32, state);
+    }
+  }
+
+#if defined(HIGHWAYHASH_AVX2)
+
+  /* Same as Update, all the four lanes in a single 256 bits register. */
+  __attribute__((target("avx2"))) static void UpdatePacketsAVX2(const uint8_t * packets,
+      size_t count,
+      HighwayHashState * state) {
+    const __m256i zipperMask = _mm256_set_epi64x(
+        0x070806090D0A040Bll, 0x000F010E05020C03ll, 0x070806090D0A040Bll, 0x000F010E05020C03ll);
+    __m256i v0 = _mm256_loadu_si256((const __m256i *)state->v0);
+    __m256i v1 = _mm256_loadu_si256((const __m256i *)state->v1);
+    __m256i mul0 = _mm256_loadu_si256((const __m256i *)state->mul0);
+    __m256i mul1 = _mm256_loadu_si256((const __m256i *)state->mul1);
+    size_t i;
+    for (i = 0; i < count; ++i) {
+      const __m256i packet = _mm256_loadu_si256((const __m256i *)(packets + i * 32));
+      v1 = _mm256_add_epi64(v1, _mm256_add_epi64(mul0, packet));
+      mul0 = _mm256_xor_si256(mul0, _mm256_mul_epu32(v1, _mm256_srli_epi64(v0, 32)));
+      v0 = _mm256_add_epi64(v0, mul1);
+      mul1 = _mm256_xor_si256(mul1, _mm256_mul_epu32(v0, _mm256_srli_epi64(v1, 32)));
+      v0 = _mm256_add_epi64(v0, _mm256_shuffle_epi8(v1, zipperMask));
+      v1 = _mm256_add_epi64(v1, _mm256_shuffle_epi8(v0, zipperMask));
+    }
+    _mm256_storeu_si256((__m256i *)state->v0, v0);
+    _mm256_storeu_si256((__m256i *)state->v1, v1);
+    _mm256_storeu_si256((__m256i *)state->mul0, mul0);
+    _mm256_storeu_si256((__m256i *)state->mul1, mul1);
+  }
+
+  static int HasAVX2() {
+    static const int hasAVX2 = __builtin_cpu_supports("avx2") ? 1 : 0;
+    return hasAVX2;
+  }
+
+#endif
+
+#if defined(HIGHWAYHASH_SIMD128)
+
+  /* Same as Update, the four lanes are split in two 128 bits registers. */
+  static void UpdatePacketsSIMD128(const uint8_t * packets, size_t count, HighwayHashState * state) {
+    const v128_t low32 = wasm_u64x2_splat(0xffffffffull);
+    v128_t v0a = wasm_v128_load(state->v0), v0b = wasm_v128_load(state->v0 + 2);
+    v128_t v1a = wasm_v128_load(state->v1), v1b = wasm_v128_load(state->v1 + 2);
+    v128_t mul0a = wasm_v128_load(state->mul0), mul0b = wasm_v128_load(state->mul0 + 2);
+    v128_t mul1a = wasm_v128_load(state->mul1), mul1b = wasm_v128_load(state->mul1 + 2);
+    size_t i;
+    for (i = 0; i < count; ++i) {
+      const uint8_t * packet = packets + i * 32;
+      v1a = wasm_i64x2_add(v1a, wasm_i64x2_add(mul0a, wasm_v128_load(packet)));
+      v1b = wasm_i64x2_add(v1b, wasm_i64x2_add(mul0b, wasm_v128_load(packet + 16)));
+      mul0a = wasm_v128_xor(mul0a, wasm_i64x2_mul(wasm_v128_and(v1a, low32), wasm_u64x2_shr(v0a, 32)));
+      mul0b = wasm_v128_xor(mul0b, wasm_i64x2_mul(wasm_v128_and(v1b, low32), wasm_u64x2_shr(v0b, 32)));
+      v0a = wasm_i64x2_add(v0a, mul1a);
+      v0b = wasm_i64x2_add(v0b, mul1b);
+      mul1a = wasm_v128_xor(mul1a, wasm_i64x2_mul(wasm_v128_and(v0a, low32), wasm_u64x2_shr(v1a, 32)));
+      mul1b = wasm_v128_xor(mul1b, wasm_i64x2_mul(wasm_v128_and(v0b, low32), wasm_u64x2_shr(v1b, 32)));
+      v0a = wasm_i64x2_add(v0a, wasm_i8x16_shuffle(v1a, v1a, 3, 12, 2, 5, 14, 1, 15, 0, 11, 4, 10, 13, 9, 6, 8, 7));
+      v0b = wasm_i64x2_add(v0b, wasm_i8x16_shuffle(v1b, v1b, 3, 12, 2, 5, 14, 1, 15, 0, 11, 4, 10, 13, 9, 6, 8, 7));
+      v1a = wasm_i64x2_add(v1a, wasm_i8x16_shuffle(v0a, v0a, 3, 12, 2, 5, 14, 1, 15, 0, 11, 4, 10, 13, 9, 6, 8, 7));
+      v1b = wasm_i64x2_add(v1b, wasm_i8x16_shuffle(v0b, v0b, 3, 12, 2, 5, 14, 1, 15, 0, 11, 4, 10, 13, 9, 6, 8, 7));
+    }
+    wasm_v128_store(state->v0, v0a);
+    wasm_v128_store(state->v0 + 2, v0b);
+    wasm_v128_store(state->v1, v1a);
+    wasm_v128_store(state->v1 + 2, v1b);
+    wasm_v128_store(state->mul0, mul0a);
+    wasm_v128_store(state->mul0 + 2, mul0b);
+    wasm_v128_store(state->mul1, mul1a);
+    wasm_v128_store(state->mul1 + 2, mul1b);
+  }
+
+#endif
+
+  void HighwayHashUpdatePackets(const uint8_t * packets, size_t count, HighwayHashState * state) {
+#if defined(HIGHWAYHASH_SIMD128)
+    UpdatePacketsSIMD128(packets, count, state);
+#elif defined(HIGHWAYHASH_AVX2)
+    if (HasAVX2()) {
+      UpdatePacketsAVX2(packets, count, state);
+    } else {
+      UpdatePacketsScalar(packets, count, state);
+    }
+#else
+    UpdatePacketsScalar(packets, count, state);
+#endif
+  }
+
+  int HighwayHashUpdatePacketsWith(HighwayHashBackend backend,
+      const uint8_t * packets,
+      size_t count,
+      HighwayHashState * state) {
+    switch (backend) {
+      case HighwayHashBackendScalar:
+        UpdatePacketsScalar(packets, count, state);
+        return 1;
+#if defined(HIGHWAYHASH_AVX2)
+      case HighwayHashBackendAVX2:
+        if (!HasAVX2()) {
+          return 0;
+        }
+        UpdatePacketsAVX2(packets, count, state);
+        return 1;
+#endif
+#if defined(HIGHWAYHASH_SIMD128)
+      case HighwayHashBackendSIMD128:
+        UpdatePacketsSIMD128(packets, count, state);
+        return 1;
+#endif
+      default:
+        return 0;
+    }
+  }
+
   static void Rotate32By(uint64_t count, uint64_t lanes[4]) {
     int i;
     for (i = 0; i < 4; ++i) {
@@ -170,8 +298,9 @@ namespace highwayhash {
   static void ProcessAll(const uint8_t * data, size_t size, const uint64_t key[4], HighwayHashState * state) {
     size_t i;
     HighwayHashReset(key, state);
-    for (i = 0; i + 32 <= size; i += 32) {
-      HighwayHashUpdatePacket(data + i, state);
+    i = size & ~(size_t)31;
+    if (i != 0) {
+      HighwayHashUpdatePackets(data, size / 32, state);
     }
     if ((size & 31) != 0)
       HighwayHashUpdateRemainder(data + i, size & 31, state);
@@ -219,10 +348,10 @@ namespace highwayhash {
         state->num = 0;
       }
     }
-    while (num >= 32) {
-      HighwayHashUpdatePacket(bytes, &state->state);
-      num -= 32;
-      bytes += 32;
+    if (num >= 32) {
+      HighwayHashUpdatePackets(bytes, num / 32, &state->state);
+      bytes += num & ~(size_t)31;
+      num &= 31;
     }
     for (i = 0; i < num; i++) {
       state->packet[state->num] = bytes[i];
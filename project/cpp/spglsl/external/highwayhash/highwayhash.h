@@ -21,6 +21,15 @@ namespace highwayhash {
   static void HighwayHashReset(const uint64_t key[4], HighwayHashState * state);
   /* Takes a packet of 32 bytes */
   void HighwayHashUpdatePacket(const uint8_t * packet, HighwayHashState * state);
+  /* Takes count consecutive packets of 32 bytes, uses AVX2 or wasm SIMD128 when available */
+  void HighwayHashUpdatePackets(const uint8_t * packets, size_t count, HighwayHashState * state);
+  /* Backends of HighwayHashUpdatePackets, every backend produces the same state */
+  typedef enum { HighwayHashBackendScalar, HighwayHashBackendAVX2, HighwayHashBackendSIMD128 } HighwayHashBackend;
+  /* Same as HighwayHashUpdatePackets with the given backend, for tests. Returns 0 if the backend is not available */
+  int HighwayHashUpdatePacketsWith(HighwayHashBackend backend,
+      const uint8_t * packets,
+      size_t count,
+      HighwayHashState * state);
   /* Adds the final 1..31 bytes, do not use if 0 remain */
   void HighwayHashUpdateRemainder(const uint8_t * bytes, size_t size_mod32, HighwayHashState * state);
   /* Compute final hash value. Makes state invalid. */
@@ -0,0 +1,109 @@
+#include "spglsl-angle-ast-hash-cache.h"
+
+#include <angle/src/common/debug.h>
+
+AngleAstHashCache::AngleAstHashCache(sh::TSymbolTable * symbolTable) : _hasher(symbolTable, this) {
+}
+
+const AngleAstHashCache::HashValue & AngleAstHashCache::getHash(sh::TIntermNode * node) {
+  return this->_update(node, true).hash;
+}
+
+const AngleAstHashCache::HashValue & AngleAstHashCache::refreshHash(sh::TIntermNode * node) {
+  return this->_update(node, false).hash;
+}
+
+const AngleAstHashCache::HashValue * AngleAstHashCache::findHash(const sh::TIntermNode * node) const {
+  auto found = this->_entries.find(node);
+  if (found == this->_entries.end() || found->second.version == 0) {
+    return nullptr;
+  }
+  return &found->second.hash;
+}
+
+bool AngleAstHashCache::computeNodeHashChanged(sh::TIntermNode * root, HashValue & hashValue) {
+  const HashValue & hash = this->getHash(root);
+  if (hash != hashValue) {
+    hashValue = hash;
+    return true;
+  }
+  return false;
+}
+
+bool AngleAstHashCache::nodesAreTheSame(sh::TIntermNode * a, sh::TIntermNode * b) {
+  if (a == b) {
+    return true;
+  }
+  if (!a || !b) {
+    return false;
+  }
+  if (a->getChildCount() != b->getChildCount()) {
+    return false;
+  }
+  const HashValue * hashA = this->findHash(a);
+  if (!hashA) {
+    hashA = &this->refreshHash(a);
+  }
+  const HashValue * hashB = this->findHash(b);
+  if (!hashB) {
+    hashB = &this->refreshHash(b);
+  }
+  return *hashA == *hashB;
+}
+
+void AngleAstHashCache::invalidate(const sh::TIntermNode * node) {
+  auto found = this->_entries.find(node);
+  if (found != this->_entries.end()) {
+    found->second.version = 0;
+  }
+}
+
+void AngleAstHashCache::clear() {
+  this->_entries.clear();
+}
+
+const AngleAstHashCache::Entry & AngleAstHashCache::_update(sh::TIntermNode * node, bool validateChildren) {
+  // References to unordered_map values stay valid when other entries are inserted.
+  Entry & entry = this->_entries[node];
+  bool dirty = entry.version == 0;
+
+  size_t childCount = node->getChildCount();
+  if (entry.children.size() != childCount) {
+    entry.children.resize(childCount);
+    dirty = true;
+  }
+
+  for (size_t i = 0; i < childCount; ++i) {
+    sh::TIntermNode * child = node->getChildNode(i);
+    uint32_t childVersion = 0;
+    if (child) {
+      auto found = validateChildren ? this->_entries.end() : this->_entries.find(child);
+      if (found != this->_entries.end() && found->second.version != 0) {
+        childVersion = found->second.version;
+      } else {
+        childVersion = this->_update(child, true).version;
+      }
+    }
+    auto & cachedChild = entry.children[i];
+    if (cachedChild.first != child || cachedChild.second != childVersion) {
+      cachedChild.first = child;
+      cachedChild.second = childVersion;
+      dirty = true;
+    }
+  }
+
+  if (dirty) {
+    this->_hasher.computeShallowNodeHash(node, entry.hash);
+    entry.version = ++this->_versionCounter;
+  }
+#if !defined(NDEBUG)
+  else if (validateChildren) {
+    // A node changed in place without calling invalidate() would keep a stale hash.
+    HashValue expected;
+    this->_hasher.computeShallowNodeHash(node, expected);
+    ASSERT(expected == entry.hash);
+  }
+#endif
+
+  return entry;
+}
@@ -0,0 +1,77 @@
+#ifndef _SPGLSL_ANGLE_AST_HASH_CACHE_H_
+#define _SPGLSL_ANGLE_AST_HASH_CACHE_H_
+
+#include <unordered_map>
+#include <vector>
+
+#include "../../core/non-copyable.h"
+#include "spglsl-angle-ast-hasher.h"
+
+/**
+ * Merkle style side table of node hashes.
+ * The hash of a node is computed from the node own data and the cached hashes of its children,
+ * so only the nodes on the path from a modified subtree to the root get rehashed.
+ * A node is rehashed when its list of children changed or one of its children got a new hash.
+ * Passes call validate() on the root once per iteration, then nodesAreTheSame() only reads the cached hashes.
+ * Passes must not change the data of a node in place without replacing it, debug builds assert it in validate().
+ * Passes that edit the children of a node in place call invalidate() on it, its hash is recomputed when queried.
+ * Hashes are 64 bits xxhash, they are only compared in memory.
+ */
+class AngleAstHashCache : NonCopyable {
+ public:
+  typedef AngleAstFastHasher::HashValue HashValue;
+
+  explicit AngleAstHashCache(sh::TSymbolTable * symbolTable = nullptr);
+
+  /** Gets the hash of a node, rehashing only what changed since the last query */
+  const HashValue & getHash(sh::TIntermNode * node);
+
+  /** Walks the whole tree and rehashes what changed since the last validation */
+  inline void validate(sh::TIntermNode * root) {
+    if (root) {
+      this->getHash(root);
+    }
+  }
+
+  /**
+   * Rehashes a node trusting the cached hashes of its children, without walking the subtree.
+   * Used to update the path from a modified node to the root.
+   */
+  const HashValue & refreshHash(sh::TIntermNode * node);
+
+  /** Gets the hash of a node without validating it, nullptr if the node was never hashed */
+  const HashValue * findHash(const sh::TIntermNode * node) const;
+
+  bool computeNodeHashChanged(sh::TIntermNode * root, HashValue & hashValue);
+
+  /**
+   * Compares two nodes by their cached hashes, O(1) for the nodes hashed by the last validate().
+   * Nodes created after it are hashed trusting the cached hashes of their children.
+   */
+  bool nodesAreTheSame(sh::TIntermNode * a, sh::TIntermNode * b);
+
+  /** Forces a node to be rehashed, its ancestors get rehashed at the next query */
+  void invalidate(const sh::TIntermNode * node);
+
+  void clear();
+
+  inline size_t size() const {
+    return this->_entries.size();
+  }
+
+ private:
+  struct Entry {
+    HashValue hash;
+    /** Incremented every time the node is rehashed, 0 if the node needs to be rehashed */
+    uint32_t version = 0;
+    std::vector<std::pair<const sh::TIntermNode *, uint32_t>> children;
+  };
+
+  std::unordered_map<const sh::TIntermNode *, Entry> _entries;
+  AngleAstFastHasher _hasher;
+  uint32_t _versionCounter = 0;
+
+  const Entry & _update(sh::TIntermNode * node, bool validateChildren);
+};
+
+#endif
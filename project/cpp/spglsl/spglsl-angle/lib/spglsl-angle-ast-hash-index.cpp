@@ -0,0 +1,188 @@
+#include "spglsl-angle-ast-hash-index.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+AngleAstHashIndex::AngleAstHashIndex(AngleAstHashCache & hashCache) : _hashCache(hashCache) {
+}
+
+void AngleAstHashIndex::build(sh::TIntermNode * root) {
+  this->_nodesByHash.clear();
+  this->_nodes.clear();
+  if (root) {
+    this->_hashCache.getHash(root);
+    this->_add(root, nullptr);
+  }
+}
+
+void AngleAstHashIndex::addSubtree(sh::TIntermNode * node, sh::TIntermNode * parent) {
+  if (!node) {
+    return;
+  }
+  this->removeSubtree(node);
+  this->_hashCache.getHash(node);
+  size_t size = this->_add(node, parent);
+  while (parent) {
+    auto found = this->_nodes.find(parent);
+    if (found == this->_nodes.end()) {
+      break;
+    }
+    found->second.size += size;
+    this->_rehash(parent);
+    parent = found->second.parent;
+  }
+}
+
+void AngleAstHashIndex::removeSubtree(sh::TIntermNode * node) {
+  auto found = this->_nodes.find(node);
+  if (found == this->_nodes.end()) {
+    return;
+  }
+  sh::TIntermNode * parent = found->second.parent;
+  size_t size = found->second.size;
+
+  std::vector<sh::TIntermNode *> stack{node};
+  while (!stack.empty()) {
+    sh::TIntermNode * current = stack.back();
+    stack.pop_back();
+    auto entry = this->_nodes.find(current);
+    if (entry == this->_nodes.end()) {
+      continue;
+    }
+    this->_unlink(current, entry->second.hash);
+    this->_nodes.erase(entry);
+    for (size_t i = 0, count = current->getChildCount(); i < count; ++i) {
+      sh::TIntermNode * child = current->getChildNode(i);
+      auto childEntry = child ? this->_nodes.find(child) : this->_nodes.end();
+      if (childEntry != this->_nodes.end() && childEntry->second.parent == current) {
+        stack.push_back(child);
+      }
+    }
+  }
+
+  while (parent) {
+    auto parentEntry = this->_nodes.find(parent);
+    if (parentEntry == this->_nodes.end()) {
+      break;
+    }
+    parentEntry->second.size -= std::min(size, parentEntry->second.size);
+    this->_rehash(parent);
+    parent = parentEntry->second.parent;
+  }
+}
+
+void AngleAstHashIndex::replaceNode(sh::TIntermNode * oldNode, sh::TIntermNode * newNode) {
+  auto found = this->_nodes.find(oldNode);
+  sh::TIntermNode * parent = found != this->_nodes.end() ? found->second.parent : nullptr;
+  this->removeSubtree(oldNode);
+  this->addSubtree(newNode, parent);
+}
+
+size_t AngleAstHashIndex::subtreeSize(const sh::TIntermNode * node) const {
+  auto found = this->_nodes.find(node);
+  return found != this->_nodes.end() ? found->second.size : 0;
+}
+
+std::vector<sh::TIntermNode *> AngleAstHashIndex::duplicatesOf(sh::TIntermNode * node) const {
+  std::vector<sh::TIntermNode *> result;
+  auto found = this->_nodes.find(node);
+  if (found == this->_nodes.end()) {
+    return result;
+  }
+  auto group = this->_nodesByHash.find(found->second.hash);
+  if (group != this->_nodesByHash.end()) {
+    for (sh::TIntermNode * duplicate : group->second) {
+      if (duplicate != node) {
+        result.push_back(duplicate);
+      }
+    }
+  }
+  return result;
+}
+
+std::vector<std::vector<sh::TIntermNode *>> AngleAstHashIndex::largestRepeatedSubtrees(size_t minSubtreeSize) const {
+  std::vector<const std::vector<sh::TIntermNode *> *> groups;
+  for (const auto & kv : this->_nodesByHash) {
+    if (kv.second.size() > 1 && this->subtreeSize(kv.second.front()) >= minSubtreeSize) {
+      groups.push_back(&kv.second);
+    }
+  }
+
+  std::stable_sort(groups.begin(), groups.end(), [this](const auto * a, const auto * b) {
+    return this->subtreeSize(a->front()) > this->subtreeSize(b->front());
+  });
+
+  std::vector<std::vector<sh::TIntermNode *>> result;
+  std::unordered_set<const sh::TIntermNode *> reported;
+  for (const auto * group : groups) {
+    bool contained = true;
+    for (sh::TIntermNode * node : *group) {
+      bool hasReportedAncestor = false;
+      for (auto found = this->_nodes.find(node); found != this->_nodes.end();) {
+        sh::TIntermNode * parent = found->second.parent;
+        if (!parent) {
+          break;
+        }
+        if (reported.count(parent)) {
+          hasReportedAncestor = true;
+          break;
+        }
+        found = this->_nodes.find(parent);
+      }
+      if (!hasReportedAncestor) {
+        contained = false;
+        break;
+      }
+    }
+    // Nodes are reported even when skipped, their descendants are contained as well.
+    reported.insert(group->begin(), group->end());
+    if (!contained) {
+      result.push_back(*group);
+    }
+  }
+  return result;
+}
+
+size_t AngleAstHashIndex::_add(sh::TIntermNode * node, sh::TIntermNode * parent) {
+  if (!node) {
+    return 0;
+  }
+  size_t size = 1;
+  for (size_t i = 0, count = node->getChildCount(); i < count; ++i) {
+    size += this->_add(node->getChildNode(i), node);
+  }
+  // The subtree was already validated by the caller.
+  const AngleAstHashCache::HashValue & hash = *this->_hashCache.findHash(node);
+  this->_nodes[node] = NodeEntry{hash, parent, size};
+  this->_nodesByHash[hash].push_back(node);
+  return size;
+}
+
+void AngleAstHashIndex::_unlink(const sh::TIntermNode * node, const AngleAstHashCache::HashValue & hash) {
+  auto group = this->_nodesByHash.find(hash);
+  if (group == this->_nodesByHash.end()) {
+    return;
+  }
+  auto & nodes = group->second;
+  auto found = std::find(nodes.begin(), nodes.end(), node);
+  if (found != nodes.end()) {
+    *found = nodes.back();
+    nodes.pop_back();
+  }
+  if (nodes.empty()) {
+    this->_nodesByHash.erase(group);
+  }
+}
+
+void AngleAstHashIndex::_rehash(sh::TIntermNode * node) {
+  auto found = this->_nodes.find(node);
+  if (found == this->_nodes.end()) {
+    return;
+  }
+  const AngleAstHashCache::HashValue & hash = this->_hashCache.refreshHash(node);
+  if (hash != found->second.hash) {
+    this->_unlink(node, found->second.hash);
+    found->second.hash = hash;
+    this->_nodesByHash[hash].push_back(node);
+  }
+}
@@ -0,0 +1,61 @@
+#ifndef _SPGLSL_ANGLE_AST_HASH_INDEX_H_
+#define _SPGLSL_ANGLE_AST_HASH_INDEX_H_
+
+#include <unordered_map>
+#include <vector>
+
+#include "spglsl-angle-ast-hash-cache.h"
+
+/**
+ * Hash consing index, maps subtree hashes to the list of structurally identical nodes.
+ * Passes that replace nodes keep it up to date with replaceNode(), or rebuild it.
+ */
+class AngleAstHashIndex : NonCopyable {
+ public:
+  explicit AngleAstHashIndex(AngleAstHashCache & hashCache);
+
+  /** Clears the index and indexes all the nodes in the given tree */
+  void build(sh::TIntermNode * root);
+
+  /** Indexes a subtree. parent is the node that contains it, if any */
+  void addSubtree(sh::TIntermNode * node, sh::TIntermNode * parent = nullptr);
+
+  /** Removes a subtree from the index */
+  void removeSubtree(sh::TIntermNode * node);
+
+  /** Replaces an indexed subtree with a new one and rehashes its ancestors */
+  void replaceNode(sh::TIntermNode * oldNode, sh::TIntermNode * newNode);
+
+  inline bool isIndexed(const sh::TIntermNode * node) const {
+    return this->_nodes.find(node) != this->_nodes.end();
+  }
+
+  /** Number of nodes in an indexed subtree, 0 if the node is not indexed */
+  size_t subtreeSize(const sh::TIntermNode * node) const;
+
+  /** All the other indexed nodes that are structurally identical to the given node */
+  std::vector<sh::TIntermNode *> duplicatesOf(sh::TIntermNode * node) const;
+
+  /**
+   * Groups of identical subtrees that appear more than once, largest subtrees first.
+   * Groups that are entirely contained in a larger reported group are skipped.
+   */
+  std::vector<std::vector<sh::TIntermNode *>> largestRepeatedSubtrees(size_t minSubtreeSize = 2) const;
+
+ private:
+  struct NodeEntry {
+    AngleAstHashCache::HashValue hash;
+    sh::TIntermNode * parent;
+    size_t size;
+  };
+
+  AngleAstHashCache & _hashCache;
+  std::unordered_map<AngleAstHashCache::HashValue, std::vector<sh::TIntermNode *>> _nodesByHash;
+  std::unordered_map<const sh::TIntermNode *, NodeEntry> _nodes;
+
+  size_t _add(sh::TIntermNode * node, sh::TIntermNode * parent);
+  void _unlink(const sh::TIntermNode * node, const AngleAstHashCache::HashValue & hash);
+  void _rehash(sh::TIntermNode * node);
+};
+
+#endif
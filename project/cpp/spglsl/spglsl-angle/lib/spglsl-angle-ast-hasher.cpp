@@ -1,4 +1,5 @@
 #include "spglsl-angle-ast-hasher.h"
+#include "spglsl-angle-ast-hash-cache.h"
 #include "spglsl-angle-node-utils.h"
 #include "spglsl-angle-operator-precedence.h"
 
@@ -42,31 +43,49 @@ enum WriteHeaders {
   SYMBOLREF,
   TYPEREF_BUILTIN,
   TYPEREF_STRUCT,
-  TYPEREF_IFACE
+  TYPEREF_IFACE,
+  CACHED_NODE,
+  UNKNOWN_NODE
 };
 
-AngleAstHasher::AngleAstHasher(TSymbolTable * symbolTable) : sh::TIntermTraverser(true, true, true, symbolTable) {
+template <typename HashPolicy>
+AngleAstHasherT<HashPolicy>::AngleAstHasherT(TSymbolTable * symbolTable, AngleAstHashCache * cache) :
+    sh::TIntermTraverser(true, false, false, symbolTable), _cache(cache) {
 }
 
-SpglslHashValue AngleAstHasher::computeNodeHash(sh::TIntermNode * root) {
+template <typename HashPolicy>
+typename AngleAstHasherT<HashPolicy>::HashValue AngleAstHasherT<HashPolicy>::computeNodeHash(sh::TIntermNode * root) {
   this->resetHash();
   this->traverseNode(root);
   return this->digest();
 }
 
-SpglslHashValue & AngleAstHasher::computeNodeHash(sh::TIntermNode * root, SpglslHashValue & output) {
+template <typename HashPolicy>
+typename AngleAstHasherT<HashPolicy>::HashValue & AngleAstHasherT<HashPolicy>::computeNodeHash(sh::TIntermNode * root,
+    HashValue & output) {
   this->resetHash();
   this->traverseNode(root);
   return this->digest(output);
 }
 
-bool AngleAstHasher::computeNodeHashChanged(sh::TIntermNode * root, SpglslHashValue & hashValue) {
+template <typename HashPolicy>
+bool AngleAstHasherT<HashPolicy>::computeNodeHashChanged(sh::TIntermNode * root, HashValue & hashValue) {
   this->resetHash();
   this->traverseNode(root);
   return this->digestChanged(hashValue);
 }
 
-bool AngleAstHasher::nodesAreTheSame(sh::TIntermNode * a, sh::TIntermNode * b) {
+template <typename HashPolicy>
+typename AngleAstHasherT<HashPolicy>::HashValue & AngleAstHasherT<HashPolicy>::computeShallowNodeHash(
+    sh::TIntermNode * node,
+    HashValue & output) {
+  this->resetHash();
+  node->traverse(this);
+  return this->digest(output);
+}
+
+template <typename HashPolicy>
+bool AngleAstHasherT<HashPolicy>::nodesAreTheSame(sh::TIntermNode * a, sh::TIntermNode * b) {
   if (a == b) {
     return true;
   }
@@ -79,17 +98,21 @@ bool AngleAstHasher::nodesAreTheSame(sh::TIntermNode * a, sh::TIntermNode * b) {
   return this->computeNodeHash(a) == this->computeNodeHash(b);
 }
 
-AngleAstHasher & AngleAstHasher::writeDirective(sh::PreprocessorDirective directive, const char * command) {
+template <typename HashPolicy>
+AngleAstHasherT<HashPolicy> & AngleAstHasherT<HashPolicy>::writeDirective(sh::PreprocessorDirective directive,
+    const char * command) {
   this->begin(DIRECTIVE).write(command).end();
   return *this;
 }
 
-AngleAstHasher & AngleAstHasher::writeTMemoryQualifier(const sh::TMemoryQualifier & q) {
+template <typename HashPolicy>
+AngleAstHasherT<HashPolicy> & AngleAstHasherT<HashPolicy>::writeTMemoryQualifier(const sh::TMemoryQualifier & q) {
   this->begin(MEMORYQUALIFIER).writeStruct(q).end();
   return *this;
 }
 
-AngleAstHasher & AngleAstHasher::writeTTypeLayoutQualifier(const sh::TType & type) {
+template <typename HashPolicy>
+AngleAstHasherT<HashPolicy> & AngleAstHasherT<HashPolicy>::writeTTypeLayoutQualifier(const sh::TType & type) {
   this->begin(LAYOUT);
   if (type.getBasicType() == sh::EbtInterfaceBlock && type.getInterfaceBlock()) {
     auto blockStorage = type.getInterfaceBlock()->blockStorage();
@@ -112,7 +135,8 @@ AngleAstHasher & AngleAstHasher::writeTTypeLayoutQualifier(const sh::TType & typ
   return *this;
 }
 
-const sh::TConstantUnion * AngleAstHasher::writeConstantUnion(const sh::TType * type,
+template <typename HashPolicy>
+const sh::TConstantUnion * AngleAstHasherT<HashPolicy>::writeConstantUnion(const sh::TType * type,
     const sh::TConstantUnion * pConstUnion) {
   if (!type) {
     return nullptr;
@@ -146,7 +170,9 @@ const sh::TConstantUnion * AngleAstHasher::writeConstantUnion(const sh::TType *
   return pConstUnion;
 }
 
-AngleAstHasher & AngleAstHasher::writeVariableType(const sh::TType & type, bool isFunctionArgument) {
+template <typename HashPolicy>
+AngleAstHasherT<HashPolicy> & AngleAstHasherT<HashPolicy>::writeVariableType(const sh::TType & type,
+    bool isFunctionArgument) {
   this->begin(VARIABLE_TYPE);
   this->write(type.isInvariant()).write(type.isPrecise());
   auto qualifier = type.getQualifier();
@@ -156,11 +182,13 @@ AngleAstHasher & AngleAstHasher::writeVariableType(const sh::TType & type, bool
     this->writeTMemoryQualifier(type.getMemoryQualifier());
   }
   if (type.getBasicType() == sh::EbtStruct && type.getStruct()) {
-    this->write('0').write(type.getStruct()->uniqueId().get());
+    this->write('0');
+    this->writeSymbolIdentity(*type.getStruct());
   } else if (type.getBasicType() == sh::EbtInterfaceBlock && type.getInterfaceBlock()) {
-    this->write('1').write(type.getInterfaceBlock()->uniqueId().get());
+    this->write('1');
+    this->writeSymbolIdentity(*type.getInterfaceBlock());
   } else {
-    this->write('2').write(type.getInterfaceBlock()->uniqueId().get());
+    this->write('2');
     this->write(type.getPrecision());
     this->writeTypeRef(type);
   }
@@ -168,7 +196,8 @@ AngleAstHasher & AngleAstHasher::writeVariableType(const sh::TType & type, bool
   return *this;
 }
 
-AngleAstHasher & AngleAstHasher::writeVariableDeclarationSymbol(sh::TIntermNode & child) {
+template <typename HashPolicy>
+AngleAstHasherT<HashPolicy> & AngleAstHasherT<HashPolicy>::writeVariableDeclarationSymbol(sh::TIntermNode & child) {
   sh::TIntermSymbol * childSym = child.getAsSymbolNode();
   if (!childSym) {
     this->traverseNode(&child);
@@ -182,7 +211,8 @@ AngleAstHasher & AngleAstHasher::writeVariableDeclarationSymbol(sh::TIntermNode
   return *this;
 }
 
-AngleAstHasher & AngleAstHasher::writeArraySizes(const TType & type) {
+template <typename HashPolicy>
+AngleAstHasherT<HashPolicy> & AngleAstHasherT<HashPolicy>::writeArraySizes(const TType & type) {
   if (!type.isArray()) {
     this->write(-1);
   } else {
@@ -195,15 +225,18 @@ AngleAstHasher & AngleAstHasher::writeArraySizes(const TType & type) {
   return *this;
 }
 
-void AngleAstHasher::visitSymbol(sh::TIntermSymbol * node) {
+template <typename HashPolicy>
+void AngleAstHasherT<HashPolicy>::visitSymbol(sh::TIntermSymbol * node) {
   this->writeSymbolRef(node->variable());
 }
 
-void AngleAstHasher::visitConstantUnion(sh::TIntermConstantUnion * node) {
+template <typename HashPolicy>
+void AngleAstHasherT<HashPolicy>::visitConstantUnion(sh::TIntermConstantUnion * node) {
   this->writeConstantUnion(&node->getType(), node->getConstantValue());
 }
 
-void AngleAstHasher::visitFunctionPrototype(sh::TIntermFunctionPrototype * node) {
+template <typename HashPolicy>
+void AngleAstHasherT<HashPolicy>::visitFunctionPrototype(sh::TIntermFunctionPrototype * node) {
   this->begin(FUNCTION_PROTOTYPE);
   const sh::TType & type = node->getType();
   const auto * proto = node->getFunction();
@@ -219,17 +252,22 @@ void AngleAstHasher::visitFunctionPrototype(sh::TIntermFunctionPrototype * node)
   this->end();
 }
 
-void AngleAstHasher::visitPreprocessorDirective(sh::TIntermPreprocessorDirective * node) {
+template <typename HashPolicy>
+void AngleAstHasherT<HashPolicy>::visitPreprocessorDirective(sh::TIntermPreprocessorDirective * node) {
   this->writeDirective(node->getDirective(), node->getCommand().data());
 }
 
-bool AngleAstHasher::visitSwizzle(sh::Visit visit, sh::TIntermSwizzle * node) {
+template <typename HashPolicy>
+bool AngleAstHasherT<HashPolicy>::visitSwizzle(sh::Visit visit, sh::TIntermSwizzle * node) {
   const auto & offsets = node->getSwizzleOffsets();
-  this->begin(SWIZZLE).writePtr(&offsets[0], offsets.size()).end();
-  return true;
+  this->begin(SWIZZLE).writePtr(&offsets[0], offsets.size());
+  this->traverseNode(node->getOperand());
+  this->end();
+  return false;
 }
 
-bool AngleAstHasher::visitBinary(sh::Visit visit, sh::TIntermBinary * node) {
+template <typename HashPolicy>
+bool AngleAstHasherT<HashPolicy>::visitBinary(sh::Visit visit, sh::TIntermBinary * node) {
   switch (node->getOp()) {
     case EOpIndexDirect:
     case EOpIndexIndirect:
@@ -240,43 +278,33 @@ bool AngleAstHasher::visitBinary(sh::Visit visit, sh::TIntermBinary * node) {
       return false;
 
     case EOpIndexDirectStruct: {
-      if (visit == sh::PreVisit) {
-        this->begin(DOTOPERATOR);
-        const sh::TStructure * structure = node->getLeft() ? node->getLeft()->getType().getStruct() : nullptr;
-        if (structure) {
-          this->traverseWithParentheses(node, 0);
-          sh::TIntermConstantUnion * indexNode = nodeGetAsConstantUnion(node->getRight());
-          const int fieldIndex = indexNode ? indexNode->getIConst(0) : -1;
-          if (fieldIndex >= 0 && fieldIndex < structure->fields().size()) {
-            this->write(fieldIndex);
-          } else {
-            this->traverseNode(node->getRight());
-          }
-          this->end();
-          return false;
-        }
+      this->begin(DOTOPERATOR);
+      this->traverseWithParentheses(node, 0);
+      const sh::TStructure * structure = node->getLeft() ? node->getLeft()->getType().getStruct() : nullptr;
+      sh::TIntermConstantUnion * indexNode = nodeGetAsConstantUnion(node->getRight());
+      const int fieldIndex = indexNode ? indexNode->getIConst(0) : -1;
+      if (structure && fieldIndex >= 0 && fieldIndex < structure->fields().size()) {
+        this->write(fieldIndex);
+      } else {
+        this->traverseNode(node->getRight());
       }
-      return true;
+      this->end();
+      return false;
     }
 
     case EOpIndexDirectInterfaceBlock: {
-      if (visit == sh::PreVisit) {
-        this->begin(DOTOPERATOR);
-        const sh::TInterfaceBlock * iface = node->getLeft() ? node->getLeft()->getType().getInterfaceBlock() : nullptr;
-        if (iface) {
-          this->traverseWithParentheses(node, 0);
-          sh::TIntermConstantUnion * indexNode = nodeGetAsConstantUnion(node->getRight());
-          const int fieldIndex = indexNode ? indexNode->getIConst(0) : -1;
-          if (fieldIndex >= 0 && fieldIndex < iface->fields().size()) {
-            this->write(fieldIndex);
-          } else {
-            this->traverseNode(node->getRight());
-          }
-          this->end();
-          return false;
-        }
+      this->begin(DOTOPERATOR);
+      this->traverseWithParentheses(node, 0);
+      const sh::TInterfaceBlock * iface = node->getLeft() ? node->getLeft()->getType().getInterfaceBlock() : nullptr;
+      sh::TIntermConstantUnion * indexNode = nodeGetAsConstantUnion(node->getRight());
+      const int fieldIndex = indexNode ? indexNode->getIConst(0) : -1;
+      if (iface && fieldIndex >= 0 && fieldIndex < iface->fields().size()) {
+        this->write(fieldIndex);
+      } else {
+        this->traverseNode(node->getRight());
       }
-      return true;
+      this->end();
+      return false;
     }
     default: break;
   }
@@ -294,7 +322,8 @@ bool AngleAstHasher::visitBinary(sh::Visit visit, sh::TIntermBinary * node) {
   return false;
 }
 
-bool AngleAstHasher::visitUnary(sh::Visit visit, sh::TIntermUnary * node) {
+template <typename HashPolicy>
+bool AngleAstHasherT<HashPolicy>::visitUnary(sh::Visit visit, sh::TIntermUnary * node) {
   if (!opIsBuiltinUnaryFunction(node->getOp())) {
     this->begin(UNARYOPERATOR_BULTIN);
     this->write(node->getOp());
@@ -302,16 +331,15 @@ bool AngleAstHasher::visitUnary(sh::Visit visit, sh::TIntermUnary * node) {
     this->end();
     return false;
   }
-  if (visit == sh::PreVisit) {
-    this->begin(UNARYOPERATOR);
-    this->write(node->getOp());
-  } else if (visit == sh::PostVisit) {
-    this->end();
-  }
-  return true;
+  this->begin(UNARYOPERATOR);
+  this->write(node->getOp());
+  this->traverseNode(node->getOperand());
+  this->end();
+  return false;
 }
 
-bool AngleAstHasher::visitTernary(sh::Visit visit, sh::TIntermTernary * node) {
+template <typename HashPolicy>
+bool AngleAstHasherT<HashPolicy>::visitTernary(sh::Visit visit, sh::TIntermTernary * node) {
   this->begin(TERNARYOPERATOR);
   this->traverseWithParentheses(node, 0);
   this->traverseWithParentheses(node, 1);
@@ -320,7 +348,8 @@ bool AngleAstHasher::visitTernary(sh::Visit visit, sh::TIntermTernary * node) {
   return false;
 }
 
-bool AngleAstHasher::visitIfElse(sh::Visit visit, sh::TIntermIfElse * node) {
+template <typename HashPolicy>
+bool AngleAstHasherT<HashPolicy>::visitIfElse(sh::Visit visit, sh::TIntermIfElse * node) {
   this->begin(IFELSEBLOCK);
   this->traverseNode(node->getCondition());
   this->traverseCodeBlock(node->getTrueBlock(), false);
@@ -331,95 +360,104 @@ bool AngleAstHasher::visitIfElse(sh::Visit visit, sh::TIntermIfElse * node) {
   return false;
 }
 
-bool AngleAstHasher::visitFunctionDefinition(sh::Visit visit, sh::TIntermFunctionDefinition * node) {
+template <typename HashPolicy>
+bool AngleAstHasherT<HashPolicy>::visitFunctionDefinition(sh::Visit visit, sh::TIntermFunctionDefinition * node) {
   this->traverseNode(node->getFunctionPrototype());
   this->traverseNode(node->getBody());
   return false;
 }
 
-bool AngleAstHasher::visitAggregate(sh::Visit visit, sh::TIntermAggregate * node) {
-  if (visit == sh::PreVisit) {
-    this->begin(AGGREGATE);
-    switch (node->getOp()) {
-      case sh::EOpCallInternalRawFunction:
-      case sh::EOpCallFunctionInAST:
-        this->write('.');
-        this->writeSymbolRef(*node->getFunction());
-        break;
-
-      case sh::EOpConstruct: {
-        const auto & type = node->getType();
-        this->write('@');
-        this->writeTypeRef(type);
-        this->writeArraySizes(type);
-        break;
-      }
+template <typename HashPolicy>
+bool AngleAstHasherT<HashPolicy>::visitAggregate(sh::Visit visit, sh::TIntermAggregate * node) {
+  this->begin(AGGREGATE);
+  switch (node->getOp()) {
+    case sh::EOpCallInternalRawFunction:
+    case sh::EOpCallFunctionInAST:
+      this->write('.');
+      this->writeSymbolRef(*node->getFunction());
+      break;
+
+    case sh::EOpConstruct: {
+      const auto & type = node->getType();
+      this->write('@');
+      this->writeTypeRef(type);
+      this->writeArraySizes(type);
+      break;
+    }
 
-      default:
-        const auto * fn = node->getFunction();
-        this->write('#');
-        if (fn) {
-          this->write(node->getFunction()->name().data());
-        } else {
-          this->write(node->getOp());
-        }
-        break;
+    default:
+      const auto * fn = node->getFunction();
+      this->write('#');
+      if (fn) {
+        this->write(node->getFunction()->name().data());
+      } else {
+        this->write(node->getOp());
+      }
+      break;
+  }
+  for (size_t i = 0, count = node->getChildCount(); i < count; ++i) {
+    if (i != 0) {
+      this->write(',');
     }
-  } else if (visit == sh::PostVisit) {
-    this->end();
+    this->traverseNode(node->getChildNode(i));
   }
-  return true;
+  this->end();
+  return false;
 }
 
-void AngleAstHasher::traverseCodeBlock(sh::TIntermBlock * node) {
+template <typename HashPolicy>
+void AngleAstHasherT<HashPolicy>::traverseCodeBlock(sh::TIntermBlock * node) {
   this->begin(CODEBLOCK);
   this->traverseNode(node);
   this->end();
 }
 
-bool AngleAstHasher::visitSwitch(sh::Visit visit, sh::TIntermSwitch * node) {
-  if (visit == sh::PreVisit) {
-    this->begin(SWITCH);
-  } else if (visit == sh::InVisit) {
-    this->write('@');
-  } else {
-    this->end();
-  }
-  return true;
+template <typename HashPolicy>
+bool AngleAstHasherT<HashPolicy>::visitSwitch(sh::Visit visit, sh::TIntermSwitch * node) {
+  this->begin(SWITCH);
+  this->traverseNode(node->getInit());
+  this->write('@');
+  this->traverseNode(node->getStatementList());
+  this->end();
+  return false;
 }
 
-bool AngleAstHasher::visitCase(sh::Visit visit, sh::TIntermCase * node) {
-  if (visit == sh::PreVisit) {
-    if (!node->getCondition()) {
-      this->write('D');
-      return false;
-    }
-    this->write('C');
-  } else if (visit == sh::PostVisit) {
-    this->write(':');
+template <typename HashPolicy>
+bool AngleAstHasherT<HashPolicy>::visitCase(sh::Visit visit, sh::TIntermCase * node) {
+  if (!node->getCondition()) {
+    this->write('D');
+    return false;
   }
-  return true;
+  this->write('C');
+  this->traverseNode(node->getCondition());
+  this->write(':');
+  return false;
 }
 
-bool AngleAstHasher::visitBlock(sh::Visit visit, sh::TIntermBlock * node) {
-  if (visit == sh::PreVisit) {
-    this->begin(BLOCK);
-  } else if (visit == sh::InVisit) {
-    this->write(';');
-  } else {
-    this->end();
+template <typename HashPolicy>
+bool AngleAstHasherT<HashPolicy>::visitBlock(sh::Visit visit, sh::TIntermBlock * node) {
+  this->begin(BLOCK);
+  for (size_t i = 0, count = node->getChildCount(); i < count; ++i) {
+    if (i != 0) {
+      this->write(';');
+    }
+    this->traverseNode(node->getChildNode(i));
   }
-  return true;
+  this->end();
+  return false;
 }
 
-bool AngleAstHasher::visitGlobalQualifierDeclaration(sh::Visit visit, sh::TIntermGlobalQualifierDeclaration * node) {
+template <typename HashPolicy>
+bool AngleAstHasherT<HashPolicy>::visitGlobalQualifierDeclaration(sh::Visit visit,
+    sh::TIntermGlobalQualifierDeclaration * node) {
   this->begin(node->isPrecise() ? GLOBALQUALIFIERPRECISE : GLOBALQUALIFIERINVARIANT);
   this->writeSymbolRef(node->getSymbol()->variable());
   this->end();
   return false;
 }
 
-bool AngleAstHasher::visitDeclaration(sh::Visit visit, sh::TIntermDeclaration * node) {
+template <typename HashPolicy>
+bool AngleAstHasherT<HashPolicy>::visitDeclaration(sh::Visit visit, sh::TIntermDeclaration * node) {
   this->begin(DECLARATION);
   size_t childCount = node->getChildCount();
   this->write(childCount);
@@ -438,13 +476,15 @@ bool AngleAstHasher::visitDeclaration(sh::Visit visit, sh::TIntermDeclaration *
   return false;
 }
 
-void AngleAstHasher::traverseCodeBlock(sh::TIntermBlock * body, bool allowIf) {
+template <typename HashPolicy>
+void AngleAstHasherT<HashPolicy>::traverseCodeBlock(sh::TIntermBlock * body, bool allowIf) {
   this->begin(allowIf ? CODEBLOCK_ALLOWIF_TRUE : CODEBLOCK_ALLOWIF_FALSE);
   this->traverseNode(body);
   this->end();
 }
 
-bool AngleAstHasher::visitLoop(sh::Visit visit, sh::TIntermLoop * node) {
+template <typename HashPolicy>
+bool AngleAstHasherT<HashPolicy>::visitLoop(sh::Visit visit, sh::TIntermLoop * node) {
   sh::TIntermBlock * body = node->getBody();
   sh::TLoopType loopType = node->getType();
   switch (loopType) {
@@ -478,42 +518,66 @@ bool AngleAstHasher::visitLoop(sh::Visit visit, sh::TIntermLoop * node) {
       return false;
     }
 
-    default: return true;
+    default:
+      this->begin(UNKNOWN_NODE);
+      for (size_t i = 0, count = node->getChildCount(); i < count; ++i) {
+        this->traverseNode(node->getChildNode(i));
+      }
+      this->end();
+      return false;
   }
 }
 
-bool AngleAstHasher::visitBranch(sh::Visit visit, sh::TIntermBranch * node) {
-  if (visit == sh::PreVisit) {
-    this->begin(BRANCH);
-    this->write(node->getFlowOp());
-  } else if (visit == sh::PostVisit) {
-    this->end();
-  }
-  return true;
+template <typename HashPolicy>
+bool AngleAstHasherT<HashPolicy>::visitBranch(sh::Visit visit, sh::TIntermBranch * node) {
+  this->begin(BRANCH);
+  this->write(node->getFlowOp());
+  this->traverseNode(node->getExpression());
+  this->end();
+  return false;
 }
 
-AngleAstHasher & AngleAstHasher::traverseNode(sh::TIntermNode * node) {
+template <typename HashPolicy>
+AngleAstHasherT<HashPolicy> & AngleAstHasherT<HashPolicy>::traverseNode(sh::TIntermNode * node) {
   if (node) {
-    node->traverse(this);
+    const auto * cached = this->_cache ? this->_cache->findHash(node) : nullptr;
+    if (cached) {
+      this->begin(CACHED_NODE).writeStruct(*cached).end();
+    } else {
+      node->traverse(this);
+    }
   }
   return *this;
 }
 
-void AngleAstHasher::traverseWithParentheses(sh::TIntermNode * node, int operandIndex) {
+template <typename HashPolicy>
+void AngleAstHasherT<HashPolicy>::traverseWithParentheses(sh::TIntermNode * node, int operandIndex) {
   if (node) {
     sh::TIntermNode * child = node->getChildNode(operandIndex);
     this->traverseNode(child);
   }
 }
 
-AngleAstHasher & AngleAstHasher::writeSymbolRef(const sh::TSymbol & symbol) {
+template <typename HashPolicy>
+AngleAstHasherT<HashPolicy> & AngleAstHasherT<HashPolicy>::writeSymbolRef(const sh::TSymbol & symbol) {
   this->begin(SYMBOLREF);
-  this->write(symbol.uniqueId().get());
+  this->writeSymbolIdentity(symbol);
   this->end();
   return *this;
 }
 
-AngleAstHasher & AngleAstHasher::writeTypeRef(const sh::TType & type) {
+template <typename HashPolicy>
+AngleAstHasherT<HashPolicy> & AngleAstHasherT<HashPolicy>::writeSymbolIdentity(const sh::TSymbol & symbol) {
+  if (this->hashSymbolNames) {
+    this->write(symbol.name().data());
+  } else {
+    this->write(symbol.uniqueId().get());
+  }
+  return *this;
+}
+
+template <typename HashPolicy>
+AngleAstHasherT<HashPolicy> & AngleAstHasherT<HashPolicy>::writeTypeRef(const sh::TType & type) {
   if (type.getBasicType() == sh::EbtStruct && type.getStruct()) {
     this->begin(TYPEREF_STRUCT);
     this->writeSymbolRef(*type.getStruct());
@@ -527,3 +591,6 @@ AngleAstHasher & AngleAstHasher::writeTypeRef(const sh::TType & type) {
   this->end();
   return *this;
 }
+
+template class AngleAstHasherT<SpglslHighwayHash256Policy>;
+template class AngleAstHasherT<SpglslXXHash64Policy>;
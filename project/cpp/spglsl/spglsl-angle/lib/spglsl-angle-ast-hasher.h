@@ -4,11 +4,26 @@
 #include <angle/src/compiler/translator/tree_util/IntermTraverse.h>
 #include "../../core/hash-stream.h"
 
-class AngleAstHasher : public sh::TIntermTraverser, public SpglslHasher {
+class AngleAstHashCache;
+
+template <typename HashPolicy>
+class AngleAstHasherT : public sh::TIntermTraverser, public SpglslHasherT<HashPolicy> {
  public:
-  explicit AngleAstHasher(sh::TSymbolTable * symbolTable = nullptr);
+  typedef typename HashPolicy::HashValue HashValue;
+
+  /**
+   * When a cache is given, children that have an entry in the cache
+   * are written as their cached hash instead of being traversed.
+   */
+  explicit AngleAstHasherT(sh::TSymbolTable * symbolTable = nullptr, AngleAstHashCache * cache = nullptr);
 
-  AngleAstHasher & traverseNode(sh::TIntermNode * node);
+  /**
+   * If true, symbols are hashed by name instead of by unique id.
+   * The hash is then stable across compilations, but different symbols with the same name are not distinguished.
+   */
+  bool hashSymbolNames = false;
+
+  AngleAstHasherT & traverseNode(sh::TIntermNode * node);
 
   void visitSymbol(sh::TIntermSymbol * node) override;
   void visitConstantUnion(sh::TIntermConstantUnion * node) override;
@@ -29,24 +44,36 @@ class AngleAstHasher : public sh::TIntermTraverser, public SpglslHasher {
   bool visitBranch(sh::Visit visit, sh::TIntermBranch * node) override;
   void visitPreprocessorDirective(sh::TIntermPreprocessorDirective * node) override;
 
-  SpglslHashValue computeNodeHash(sh::TIntermNode * root);
-  SpglslHashValue & computeNodeHash(sh::TIntermNode * root, SpglslHashValue & output);
-  bool computeNodeHashChanged(sh::TIntermNode * root, SpglslHashValue & hashValue);
+  HashValue computeNodeHash(sh::TIntermNode * root);
+  HashValue & computeNodeHash(sh::TIntermNode * root, HashValue & output);
+  bool computeNodeHashChanged(sh::TIntermNode * root, HashValue & hashValue);
   bool nodesAreTheSame(sh::TIntermNode * a, sh::TIntermNode * b);
 
+  /** Hashes the given node without looking up the cache for the node itself */
+  HashValue & computeShallowNodeHash(sh::TIntermNode * node, HashValue & output);
+
  private:
-  AngleAstHasher & writeDirective(sh::PreprocessorDirective directive, const char * command);
-  AngleAstHasher & writeTMemoryQualifier(const sh::TMemoryQualifier & q);
-  AngleAstHasher & writeTTypeLayoutQualifier(const sh::TType & type);
+  AngleAstHashCache * _cache;
+
+  AngleAstHasherT & writeDirective(sh::PreprocessorDirective directive, const char * command);
+  AngleAstHasherT & writeTMemoryQualifier(const sh::TMemoryQualifier & q);
+  AngleAstHasherT & writeTTypeLayoutQualifier(const sh::TType & type);
   const sh::TConstantUnion * writeConstantUnion(const sh::TType * type, const sh::TConstantUnion * pConstUnion);
-  AngleAstHasher & writeVariableType(const sh::TType & type, bool isFunctionArgument);
-  AngleAstHasher & writeVariableDeclarationSymbol(sh::TIntermNode & child);
-  AngleAstHasher & writeArraySizes(const sh::TType & type);
+  AngleAstHasherT & writeVariableType(const sh::TType & type, bool isFunctionArgument);
+  AngleAstHasherT & writeVariableDeclarationSymbol(sh::TIntermNode & child);
+  AngleAstHasherT & writeArraySizes(const sh::TType & type);
   void traverseCodeBlock(sh::TIntermBlock * node);
   void traverseCodeBlock(sh::TIntermBlock * body, bool allowIf);
   void traverseWithParentheses(sh::TIntermNode * node, int operandIndex);
-  AngleAstHasher & writeSymbolRef(const sh::TSymbol & symbol);
-  AngleAstHasher & writeTypeRef(const sh::TType & type);
+  AngleAstHasherT & writeSymbolRef(const sh::TSymbol & symbol);
+  AngleAstHasherT & writeSymbolIdentity(const sh::TSymbol & symbol);
+  AngleAstHasherT & writeTypeRef(const sh::TType & type);
 };
 
+/** HighwayHash 256 bits, for hashes that are persisted */
+typedef AngleAstHasherT<SpglslHighwayHash256Policy> AngleAstHasher;
+
+/** xxhash 64 bits, for in memory change detection and equality checks */
+typedef AngleAstHasherT<SpglslXXHash64Policy> AngleAstFastHasher;
+
 #endif
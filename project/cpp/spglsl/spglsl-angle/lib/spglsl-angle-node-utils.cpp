@@ -467,6 +467,59 @@ bool isIntermNodeSingleStatement(sh::TIntermNode * node) {
   return true;
 }
 
+static inline sh::TPrecision _maxPrecision(sh::TPrecision a, sh::TIntermNode * node) {
+  sh::TIntermTyped * typed = node ? node->getAsTyped() : nullptr;
+  return typed && typed->getPrecision() > a ? typed->getPrecision() : a;
+}
+
+sh::TPrecision nodeGetConsumingPrecision(sh::TIntermNode * parent, sh::TIntermTyped * node) {
+  // An operation is evaluated at the highest precision of its operands, constants do not have a precision.
+  if (!parent) {
+    return sh::EbpUndefined;
+  }
+
+  sh::TIntermAggregate * aggregate = parent->getAsAggregate();
+  if (aggregate) {
+    const sh::TIntermSequence & arguments = *aggregate->getSequence();
+    const sh::TFunction * function = aggregate->getFunction();
+    const sh::TStructure * structure =
+        aggregate->getOp() == sh::EOpConstruct ? aggregate->getType().getStruct() : nullptr;
+    for (size_t i = 0; i < arguments.size(); ++i) {
+      if (arguments[i] != node) {
+        continue;
+      }
+      if (function && aggregate->getOp() == sh::EOpCallFunctionInAST && i < function->getParamCount()) {
+        return function->getParam(i)->getType().getPrecision();
+      }
+      if (structure) {
+        return i < structure->fields().size() ? structure->fields()[i]->type()->getPrecision() : sh::EbpUndefined;
+      }
+    }
+    sh::TPrecision precision = _maxPrecision(sh::EbpUndefined, aggregate);
+    for (sh::TIntermNode * argument : arguments) {
+      precision = _maxPrecision(precision, argument);
+    }
+    return precision;
+  }
+
+  sh::TIntermBinary * binary = parent->getAsBinaryNode();
+  if (binary) {
+    return _maxPrecision(_maxPrecision(_maxPrecision(sh::EbpUndefined, binary), binary->getLeft()), binary->getRight());
+  }
+
+  sh::TIntermUnary * unary = parent->getAsUnaryNode();
+  if (unary) {
+    return _maxPrecision(sh::EbpUndefined, unary);
+  }
+
+  sh::TIntermTernary * ternary = parent->getAsTernaryNode();
+  if (ternary && node != ternary->getCondition()) {
+    return _maxPrecision(sh::EbpUndefined, ternary);
+  }
+
+  return sh::EbpUndefined;
+}
+
 AngleNodeKind nodeGetKind(const sh::TIntermNode * node) {
   if (node == nullptr) {
     return AngleNodeKind::TNull;
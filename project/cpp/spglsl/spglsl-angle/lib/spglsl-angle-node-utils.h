@@ -122,6 +122,9 @@ sh::TConstantUnion * CreateConstantUnionFillFromScalar(const sh::TType & type,
 sh::TIntermConstantUnion * nodeCreateConstantUnionFillFromScalar(const sh::TType & type,
     const sh::TConstantUnion & constant = sh::TConstantUnion());
 
+/** The precision of the expression that uses a constant child of the given parent, undefined if it cannot be known */
+sh::TPrecision nodeGetConsumingPrecision(sh::TIntermNode * parent, sh::TIntermTyped * node);
+
 bool nodeConstantUnionIsAllZero(sh::TIntermNode * node);
 bool nodeConstantUnionIsAllOne(sh::TIntermNode * node);
 
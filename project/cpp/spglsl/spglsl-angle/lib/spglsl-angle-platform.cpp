@@ -0,0 +1,29 @@
+#include <angle/src/common/debug.h>
+
+// ANGLE platform functions, there is no debugger and the ANGLE logs are not written.
+
+namespace angle {
+  bool IsDebuggerAttached() {
+    return false;
+  }
+
+  void BreakDebugger() {
+  }
+};
+
+namespace gl {
+  namespace priv {
+    bool ShouldCreatePlatformLogMessage(int severity) {
+      return false;
+    }
+  }
+  
+  LogMessage::LogMessage(const char *file, const char *function, int line, LogSeverity severity) :
+    mFile(file), mFunction(function), mLine(line), mSeverity(severity)
+  {
+  }
+
+
+  LogMessage::~LogMessage() {
+  }
+};
\ No newline at end of file
@@ -0,0 +1,199 @@
+#include "spglsl-glsl-macros.h"
+
+#include <algorithm>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "../../core/string-set.h"
+#include "../symbols/spglsl-symbol-info.h"
+
+/** Length of "#define " + " " + "\n" */
+static constexpr size_t DEFINE_OVERHEAD = 10;
+
+static inline bool _isIdentifierStart(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+static inline bool _isIdentifierChar(char c) {
+  return _isIdentifierStart(c) || (c >= '0' && c <= '9');
+}
+
+static inline bool _isDigit(char c) {
+  return c >= '0' && c <= '9';
+}
+
+/** Length of the leading lines that are directives or empty, #version and #extension must stay before the aliases */
+static size_t _directivesHeaderLength(const std::string & source) {
+  size_t result = 0;
+  size_t i = 0;
+  const size_t length = source.length();
+  while (i < length) {
+    size_t lineStart = i;
+    while (i < length && (source[i] == ' ' || source[i] == '\t' || source[i] == '\r')) {
+      ++i;
+    }
+    if (i < length && source[i] != '#' && source[i] != '\n') {
+      break;
+    }
+    i = source.find('\n', lineStart);
+    if (i == std::string::npos) {
+      break;
+    }
+    result = ++i;
+  }
+  return result;
+}
+
+/**
+ * Collects the identifiers and keywords outside of the preprocessor directives.
+ * All the names in the text, including the ones in the directives, are added to usedNames.
+ */
+static void _tokenize(const std::string & source, std::vector<std::string_view> & tokens, SpglslStringSet & usedNames) {
+  const char * text = source.data();
+  const size_t length = source.length();
+  bool isLineStart = true;
+  bool isDirective = false;
+  size_t i = 0;
+  while (i < length) {
+    const char c = text[i];
+    if (c == '\n') {
+      isLineStart = true;
+      isDirective = false;
+      ++i;
+      continue;
+    }
+    if (c == ' ' || c == '\t' || c == '\r') {
+      ++i;
+      continue;
+    }
+    if (c == '#' && isLineStart) {
+      isDirective = true;
+    }
+    isLineStart = false;
+
+    if (_isDigit(c) || (c == '.' && i + 1 < length && _isDigit(text[i + 1]))) {
+      // A number, suffixes and exponents are not names, "1e5", "2u", "0x1F"
+      ++i;
+      while (i < length &&
+          (_isIdentifierChar(text[i]) || text[i] == '.' ||
+              ((text[i] == '+' || text[i] == '-') && (text[i - 1] == 'e' || text[i - 1] == 'E')))) {
+        ++i;
+      }
+      continue;
+    }
+
+    if (_isIdentifierStart(c)) {
+      size_t start = i++;
+      while (i < length && _isIdentifierChar(text[i])) {
+        ++i;
+      }
+      std::string_view name(text + start, i - start);
+      usedNames.add(name);
+      if (!isDirective) {
+        tokens.push_back(name);
+      }
+      continue;
+    }
+
+    ++i;
+  }
+}
+
+/** Generates the candidate alias names, shortest first, without underscores to never form reserved "__" names */
+static std::string _aliasName(size_t index) {
+  static constexpr char CHARS[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+  static constexpr size_t FIRST_CHARS_COUNT = 52;
+  static constexpr size_t CHARS_COUNT = 62;
+  std::string result(1, CHARS[index % FIRST_CHARS_COUNT]);
+  index /= FIRST_CHARS_COUNT;
+  while (index != 0) {
+    --index;
+    result.push_back(CHARS[index % CHARS_COUNT]);
+    index /= CHARS_COUNT;
+  }
+  return result;
+}
+
+size_t spglslDefineMacros(const std::string & source, std::string & output) {
+  output.clear();
+
+  std::vector<std::string_view> tokens;
+  SpglslStringSet usedNames;
+  _tokenize(source, tokens, usedNames);
+
+  std::unordered_map<std::string_view, uint32_t> frequencies;
+  for (const auto & token : tokens) {
+    ++frequencies[token];
+  }
+
+  std::vector<std::pair<std::string_view, uint32_t>> candidates;
+  for (const auto & kv : frequencies) {
+    if (kv.second > 1 && kv.first.length() > 1) {
+      candidates.emplace_back(kv);
+    }
+  }
+
+  // The tokens that take more space get the shortest aliases
+  std::sort(candidates.begin(), candidates.end(), [](const auto & a, const auto & b) {
+    size_t sizeA = a.first.length() * a.second;
+    size_t sizeB = b.first.length() * b.second;
+    return sizeA != sizeB ? sizeA > sizeB : a.first < b.first;
+  });
+
+  std::unordered_map<std::string_view, std::string> aliases;
+  std::string defines;
+  size_t aliasIndex = 0;
+  std::string alias;
+  for (const auto & candidate : candidates) {
+    if (alias.empty()) {
+      do {
+        alias = _aliasName(aliasIndex++);
+      } while (usedNames.has(alias) || spglslIsWordReserved(alias));
+    }
+
+    const size_t tokenLength = candidate.first.length();
+    if (alias.length() >= tokenLength) {
+      continue;
+    }
+    const size_t saved = candidate.second * (tokenLength - alias.length());
+    const size_t cost = DEFINE_OVERHEAD + alias.length() + tokenLength;
+    if (saved <= cost) {
+      continue;
+    }
+
+    defines.append("#define ").append(alias).append(" ").append(candidate.first).append("\n");
+    aliases.emplace(candidate.first, std::move(alias));
+    alias.clear();
+  }
+
+  if (aliases.empty()) {
+    return 0;
+  }
+
+  const size_t headerLength = _directivesHeaderLength(source);
+  output.reserve(source.length());
+  output.append(source, 0, headerLength);
+  output.append(defines);
+
+  size_t position = headerLength;
+  for (const auto & token : tokens) {
+    const size_t start = (size_t)(token.data() - source.data());
+    if (start < position) {
+      continue;
+    }
+    auto found = aliases.find(token);
+    if (found != aliases.end()) {
+      output.append(source, position, start - position);
+      output.append(found->second);
+      position = start + token.length();
+    }
+  }
+  output.append(source, position, std::string::npos);
+
+  if (output.length() >= source.length()) {
+    output.clear();
+    return 0;
+  }
+  return source.length() - output.length();
+}
@@ -13,6 +13,45 @@ struct SpglslGlslPrecisions {
 
   sh::TPrecision defaultFloatPrecision = sh::EbpUndefined;
   sh::TPrecision defaultIntPrecision = sh::EbpUndefined;
+
+  /** Gets the precision keyword that needs to be written before a type, nullptr if the default precision applies */
+  inline const char * getTypePrecisionString(const sh::TType & type) const {
+    sh::TPrecision precision = type.getPrecision();
+    if (precision == sh::EbpUndefined) {
+      return nullptr;
+    }
+    switch (type.getBasicType()) {
+      case sh::EbtStruct:
+      case sh::EbtInterfaceBlock:
+      case sh::EbtVoid:
+      case sh::EbtAtomicCounter:
+      case sh::EbtBool: return nullptr;
+
+      case sh::EbtInt:
+      case sh::EbtUInt:
+        if (this->intPrecision != sh::EbpUndefined) {
+          if (precision == this->intPrecision) {
+            return nullptr;
+          }
+        } else if (precision == this->defaultIntPrecision) {
+          return nullptr;
+        }
+        break;
+
+      case sh::EbtFloat:
+        if (this->floatPrecision != sh::EbpUndefined) {
+          if (precision == this->floatPrecision) {
+            return nullptr;
+          }
+        } else if (precision == this->defaultFloatPrecision) {
+          return nullptr;
+        }
+        break;
+
+      default: break;
+    }
+    return sh::getPrecisionString(precision);
+  }
 };
 
 #endif
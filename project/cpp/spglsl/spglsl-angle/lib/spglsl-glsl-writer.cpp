@@ -37,10 +37,9 @@ SpglslAngleLayoutNeeds::SpglslAngleLayoutNeeds(const sh::TType & type) : layoutQ
 
 ///////////// SpglslGlslWriter /////////////
 
-SpglslGlslWriter::SpglslGlslWriter(std::ostream & out, const SpglslGlslPrecisions & precisions, bool beautify) :
+SpglslGlslWriter::SpglslGlslWriter(std::string & out, const SpglslGlslPrecisions & precisions, bool beautify) :
     out(out), beautify(beautify), _indentLevel(0), _lastCh('\n'), _lastLastCh('\n'), _size(0), precisions(precisions) {
   this->_tmpChar[1] = '\0';
-  out.imbue(std::locale::classic());
 }
 
 SpglslGlslWriter & SpglslGlslWriter::reset() {
@@ -214,18 +213,15 @@ SpglslGlslWriter & SpglslGlslWriter::writeSwizzle(sh::TIntermSwizzle * node) {
     }
   }
 
-  std::ostringstream tmp;
+  char tmp[5];
+  size_t tmpLength = 0;
   for (const int offset : offsets) {
-    switch (offset) {
-      case 0: tmp << "x"; break;
-      case 1: tmp << "y"; break;
-      case 2: tmp << "z"; break;
-      case 3: tmp << "w"; break;
-      default: break;
+    if (offset >= 0 && offset < 4 && tmpLength < sizeof(tmp)) {
+      tmp[tmpLength++] = "xyzw"[offset];
     }
   }
   this->write('.');
-  this->write(tmp.str());
+  this->write(tmp, tmpLength);
   return *this;
 }
 
@@ -251,41 +247,7 @@ SpglslGlslWriter & SpglslGlslWriter::writeTMemoryQualifier(const sh::TMemoryQual
 }
 
 SpglslGlslWriter & SpglslGlslWriter::writeTypePrecision(const sh::TType & type) {
-  sh::TPrecision precision = type.getPrecision();
-  if (precision == sh::EbpUndefined) {
-    return *this;
-  }
-  switch (type.getBasicType()) {
-    case sh::EbtStruct:
-    case sh::EbtInterfaceBlock:
-    case sh::EbtVoid:
-    case sh::EbtAtomicCounter:
-    case sh::EbtBool: return *this;
-
-    case sh::EbtInt:
-    case sh::EbtUInt:
-      if (this->precisions.intPrecision != sh::EbpUndefined) {
-        if (precision == this->precisions.intPrecision) {
-          return *this;
-        }
-      } else if (precision == this->precisions.defaultIntPrecision) {
-        return *this;
-      }
-      break;
-
-    case sh::EbtFloat:
-      if (this->precisions.floatPrecision != sh::EbpUndefined) {
-        if (precision == this->precisions.floatPrecision) {
-          return *this;
-        }
-      } else if (precision == this->precisions.defaultFloatPrecision) {
-        return *this;
-      }
-      break;
-
-    default: break;
-  }
-  return this->write(sh::getPrecisionString(precision));
+  return this->write(this->precisions.getTypePrecisionString(type));
 }
 
 bool SpglslGlslWriter::needsToWriteTTypeLayoutQualifier(const sh::TType & type) {
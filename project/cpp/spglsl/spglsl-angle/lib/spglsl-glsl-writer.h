@@ -1,8 +1,9 @@
 #ifndef _SPGLSL_WRITER_H_
 #define _SPGLSL_WRITER_H_
 
-#include <sstream>
+#include <cstring>
 #include <string>
+#include <string_view>
 #include "../../core/non-copyable.h"
 #include "spglsl-glsl-precisions.h"
 
@@ -26,14 +27,18 @@ class SpglslAngleLayoutNeeds {
   bool needsToWriteLayout;
 };
 
+/**
+ * Writes GLSL text appending to a contiguous string buffer, owned by the caller.
+ * Reserve the buffer in advance to avoid reallocations, the written text can be moved out of it without copies.
+ */
 class SpglslGlslWriter : NonCopyable {
  public:
-  std::ostream & out;
+  std::string & out;
   bool beautify;
 
   const SpglslGlslPrecisions precisions;
 
-  explicit SpglslGlslWriter(std::ostream & out, const SpglslGlslPrecisions & precisions, bool beautify);
+  explicit SpglslGlslWriter(std::string & out, const SpglslGlslPrecisions & precisions, bool beautify);
 
   SpglslGlslWriter & reset();
 
@@ -62,6 +67,12 @@ class SpglslGlslWriter : NonCopyable {
     return (last == ' ' || last == '\n') ? this->_lastLastCh : last;
   }
 
+  /** Sets the last written characters, to continue a text that was written in another buffer */
+  inline void setLastChars(char lastCh, char lastLastCh) {
+    this->_lastCh = lastCh;
+    this->_lastLastCh = lastLastCh;
+  }
+
   inline SpglslGlslWriter & indent() {
     ++this->_indentLevel;
     return *this;
@@ -84,6 +95,10 @@ class SpglslGlslWriter : NonCopyable {
     return this->write(text.c_str(), text.length());
   }
 
+  inline SpglslGlslWriter & write(std::string_view text) {
+    return this->write(text.data(), text.length());
+  }
+
   inline SpglslGlslWriter & write(const sh::ImmutableString & s) {
     return this->write(s.data(), s.length());
   }
@@ -110,7 +125,7 @@ class SpglslGlslWriter : NonCopyable {
  protected:
   inline SpglslGlslWriter & writeRaw(const char ch) {
     if (ch != '\0') {
-      this->out.put(ch);
+      this->out.push_back(ch);
       this->_lastLastCh = this->_lastCh;
       this->_lastCh = ch;
       ++this->_size;
@@ -120,7 +135,7 @@ class SpglslGlslWriter : NonCopyable {
 
   inline SpglslGlslWriter & writeRaw(const char * s, size_t length) {
     if (length != 0) {
-      this->out.write(s, (std::streamsize)length);
+      this->out.append(s, length);
       this->_lastLastCh = this->_lastCh;
       this->_lastCh = s[length - 1];
       this->_size += length;
@@ -0,0 +1,132 @@
+#include "spglsl-source-map.h"
+
+static constexpr char BASE64_CHARS[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static void _appendVlq(std::string & out, int64_t value) {
+  uint64_t vlq = value < 0 ? (((uint64_t)-value) << 1) | 1 : ((uint64_t)value) << 1;
+  do {
+    uint32_t digit = vlq & 31;
+    vlq >>= 5;
+    if (vlq != 0) {
+      digit |= 32;
+    }
+    out.push_back(BASE64_CHARS[digit]);
+  } while (vlq != 0);
+}
+
+static void _appendJsonString(std::string & out, std::string_view value) {
+  static constexpr char HEX_CHARS[] = "0123456789abcdef";
+  out.push_back('"');
+  for (char c : value) {
+    switch (c) {
+      case '"': out.append("\\\""); break;
+      case '\\': out.append("\\\\"); break;
+      case '\n': out.append("\\n"); break;
+      case '\r': out.append("\\r"); break;
+      case '\t': out.append("\\t"); break;
+      default:
+        if ((unsigned char)c < 0x20) {
+          out.append("\\u00");
+          out.push_back(HEX_CHARS[(c >> 4) & 15]);
+          out.push_back(HEX_CHARS[c & 15]);
+        } else {
+          out.push_back(c);
+        }
+        break;
+    }
+  }
+  out.push_back('"');
+}
+
+void SpglslSourceMap::add(uint32_t generatedLine, uint32_t generatedColumn, uint32_t sourceLine, int32_t nameIndex) {
+  if (!this->_mappings.empty()) {
+    Mapping & last = this->_mappings.back();
+    if (last.generatedLine == generatedLine) {
+      if (last.generatedColumn == generatedColumn) {
+        // The same position, a name is more useful than a statement start.
+        if (nameIndex >= 0 || last.nameIndex < 0) {
+          last.sourceLine = sourceLine;
+          last.nameIndex = nameIndex;
+        }
+        return;
+      }
+      if (nameIndex < 0 && last.nameIndex < 0 && last.sourceLine == sourceLine) {
+        // Already covered by the previous mapping.
+        return;
+      }
+    }
+  }
+  this->_mappings.push_back(Mapping{generatedLine, generatedColumn, sourceLine, nameIndex});
+}
+
+int32_t SpglslSourceMap::addName(const void * symbol, std::string_view name) {
+  auto found = this->_nameIndices.find(symbol);
+  if (found != this->_nameIndices.end()) {
+    return found->second;
+  }
+  int32_t index = (int32_t)this->_names.size();
+  this->_names.emplace_back(name);
+  this->_nameIndices.emplace(symbol, index);
+  return index;
+}
+
+std::string SpglslSourceMap::encodeMappings() const {
+  std::string result;
+  result.reserve(this->_mappings.size() * 6);
+
+  uint32_t line = 0;
+  int64_t previousColumn = 0;
+  int64_t previousSourceLine = 0;
+  int64_t previousNameIndex = 0;
+  bool isFirstInLine = true;
+
+  for (const Mapping & mapping : this->_mappings) {
+    while (line < mapping.generatedLine) {
+      result.push_back(';');
+      ++line;
+      previousColumn = 0;
+      isFirstInLine = true;
+    }
+    if (!isFirstInLine) {
+      result.push_back(',');
+    }
+    isFirstInLine = false;
+
+    _appendVlq(result, (int64_t)mapping.generatedColumn - previousColumn);
+    previousColumn = mapping.generatedColumn;
+
+    // There is a single source and the source column is always 0, their deltas are always 0.
+    _appendVlq(result, 0);
+    _appendVlq(result, (int64_t)mapping.sourceLine - previousSourceLine);
+    previousSourceLine = mapping.sourceLine;
+    _appendVlq(result, 0);
+
+    if (mapping.nameIndex >= 0) {
+      _appendVlq(result, (int64_t)mapping.nameIndex - previousNameIndex);
+      previousNameIndex = mapping.nameIndex;
+    }
+  }
+  return result;
+}
+
+std::string SpglslSourceMap::toJSON(std::string_view sourcePath) const {
+  std::string result = "{\"version\":3,\"sources\":[";
+  _appendJsonString(result, sourcePath);
+  result.append("],\"names\":[");
+  for (size_t i = 0; i < this->_names.size(); ++i) {
+    if (i != 0) {
+      result.push_back(',');
+    }
+    _appendJsonString(result, this->_names[i]);
+  }
+  result.append("],\"mappings\":\"");
+  result.append(this->encodeMappings());
+  result.append("\"}");
+  return result;
+}
+
+void SpglslSourceMap::clear() {
+  this->_mappings.clear();
+  this->_names.clear();
+  this->_nameIndices.clear();
+}
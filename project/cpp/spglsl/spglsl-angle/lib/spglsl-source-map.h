@@ -0,0 +1,50 @@
+#ifndef _SPGLSL_SOURCE_MAP_H_
+#define _SPGLSL_SOURCE_MAP_H_
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "../../core/non-copyable.h"
+
+/**
+ * Source map of a written shader, to find the source line of a position in the output.
+ * Mappings are buffered as they are written, in output order, and encoded once in the source map v3 format.
+ * Lines and columns are zero based. ANGLE does not keep the source columns, all mappings point to column 0.
+ */
+class SpglslSourceMap : NonCopyable {
+ public:
+  inline size_t size() const {
+    return this->_mappings.size();
+  }
+
+  /** Adds a mapping, positions must be added in increasing output order. nameIndex is -1 for no name. */
+  void add(uint32_t generatedLine, uint32_t generatedColumn, uint32_t sourceLine, int32_t nameIndex = -1);
+
+  /** Gets the index of the original name of a symbol, the same symbol is added only once */
+  int32_t addName(const void * symbol, std::string_view name);
+
+  /** Encodes the mappings with base64 VLQ, the "mappings" field of a source map v3 */
+  std::string encodeMappings() const;
+
+  /** Writes the whole source map v3 JSON, with a single source */
+  std::string toJSON(std::string_view sourcePath) const;
+
+  void clear();
+
+ private:
+  struct Mapping {
+    uint32_t generatedLine;
+    uint32_t generatedColumn;
+    uint32_t sourceLine;
+    int32_t nameIndex;
+  };
+
+  std::vector<Mapping> _mappings;
+  std::vector<std::string> _names;
+  std::unordered_map<const void *, int32_t> _nameIndices;
+};
+
+#endif
@@ -37,8 +37,12 @@ std::string SpglslAngleCompilerHandle::getInfoLog() const {
   return this->compiler ? this->compiler->infoSink.info.str() : "ERROR 0:0 '' Failed to initialize ANGLE compiler";
 }
 
-std::string SpglslAngleCompilerHandle::decompileOutput() const {
-  return this->compiler ? this->compiler->decompileOutput() : Strings::empty;
+std::string SpglslAngleCompilerHandle::decompileOutput(SpglslSourceMap * sourceMap) const {
+  std::string out;
+  if (this->compiler) {
+    this->compiler->decompileOutput(out, sourceMap);
+  }
+  return out;
 }
 
 const std::map<std::string, std::string> * SpglslAngleCompilerHandle::getUniforms() const {
@@ -48,3 +52,11 @@ const std::map<std::string, std::string> * SpglslAngleCompilerHandle::getUniform
 const std::map<std::string, std::string> * SpglslAngleCompilerHandle::getGlobals() const {
   return this->compiler ? &this->compiler->globalsMap : nullptr;
 }
+
+const std::map<std::string, std::string> * SpglslAngleCompilerHandle::getMangleMap() const {
+  return this->compiler ? &this->compiler->mangleMap : nullptr;
+}
+
+const std::vector<SpglslRepeatedSubtree> * SpglslAngleCompilerHandle::getRepeatedSubtrees() const {
+  return this->compiler ? &this->compiler->repeatedSubtrees : nullptr;
+}
@@ -2,10 +2,13 @@
 #define _SPGLSL_COMPILER_HANDLE_H_
 
 #include <map>
+#include <vector>
 #include "../core/non-copyable.h"
 #include "../spglsl-compile-options.h"
 
 class SpglslAngleCompiler;
+class SpglslSourceMap;
+struct SpglslRepeatedSubtree;
 
 class SpglslAngleCompilerHandle : public NonCopyable {
  public:
@@ -19,9 +22,11 @@ class SpglslAngleCompilerHandle : public NonCopyable {
   bool compile(const std::string & sourceCode);
 
   std::string getInfoLog() const;
-  std::string decompileOutput() const;
+  std::string decompileOutput(SpglslSourceMap * sourceMap = nullptr) const;
   const std::map<std::string, std::string> * getUniforms() const;
   const std::map<std::string, std::string> * getGlobals() const;
+  const std::map<std::string, std::string> * getMangleMap() const;
+  const std::vector<SpglslRepeatedSubtree> * getRepeatedSubtrees() const;
 
   ~SpglslAngleCompilerHandle();
 };
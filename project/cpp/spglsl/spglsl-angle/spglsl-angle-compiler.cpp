@@ -11,8 +11,10 @@
 #include <angle/src/compiler/translator/tree_ops/SplitSequenceOperator.h>
 #include <angle/src/compiler/translator/tree_util/IntermNodePatternMatcher.h>
 #include <angle/src/compiler/translator/util.h>
-#include <sstream>
+#include <algorithm>
+#include <cstring>
 #include <string>
+#include <thread>
 
 #include "GLES/gl.h"
 #include "GLSLANG/ShaderLang.h"
@@ -22,13 +24,18 @@
 #include "compiler/translator/ParseContext.h"
 #include "compiler/translator/tree_util/IntermTraverse.h"
 #include "compiler/translator/tree_util/Visit.h"
+#include "../core/gzip-size.h"
 #include "spglsl-angle-compiler-handle.h"
+#include "spglsl-angle-parallel-output.h"
 #include "spglsl-angle-webgl-output.h"
+#include "spglsl/spglsl-angle/lib/spglsl-angle-ast-hash-index.h"
 #include "spglsl/spglsl-angle/lib/spglsl-glsl-precisions.h"
 #include "spglsl/spglsl-angle/lib/spglsl-t-compiler.h"
 #include "spglsl/spglsl-angle/tree-ops/spglsl-get-precisions-traverser.h"
 #include "spglsl/spglsl-compile-options.h"
+#include "symbols/spglsl-field-usage.h"
 #include "symbols/spglsl-symbol-usage.h"
+#include "tree-ops/spglsl-analysis-traverser.h"
 #include "tree-ops/tree-ops.h"
 
 SpglslAngleCompiler::SpglslAngleCompiler(sh::GLenum shaderType, SpglslCompileOptions & compilerOptions) :
@@ -44,6 +51,8 @@ SpglslAngleCompiler::SpglslAngleCompiler(sh::GLenum shaderType, SpglslCompileOpt
 bool SpglslAngleCompiler::compile(const char * sourceCode) {
   SetGlobalPoolAllocator(&this->getAllocator());
 
+  this->_sourceLength = sourceCode ? strlen(sourceCode) : 0;
+
   this->symbolTable.initializeBuiltIns(
       this->metadata.shaderType, this->tCompiler.getShaderSpec(), this->compilerOptions.angle);
   sh::InitExtensionBehavior(this->compilerOptions.angle, this->extensionBehavior);
@@ -114,6 +123,11 @@ bool SpglslAngleCompiler::_checkAndSimplifyAST(sh::TIntermBlock * root, const sh
     }
   }
 
+  if (this->compilerOptions.reportRepeatedSubtrees) {
+    // Before the optimizations, the nodes still have the line of the source.
+    this->_findRepeatedSubtrees(root);
+  }
+
   if (this->compilerOptions.compileMode == SpglslCompileMode::Optimize) {
     if (!SeparateDeclarations(this->tCompiler, *root, true)) {
       return false;
@@ -136,37 +150,70 @@ bool SpglslAngleCompiler::_checkAndSimplifyAST(sh::TIntermBlock * root, const sh
   this->loadPrecisions();
 
   if (this->compilerOptions.compileMode == SpglslCompileMode::Optimize) {
+    if (this->compilerOptions.coalesceLocals && !spglsl_treeops_coalesceLocals(*this, root)) {
+      return false;
+    }
+
     if (this->compilerOptions.minify) {
       spglsl_treeops_minify(*this, root);
     }
 
+    if (this->compilerOptions.hoistLiterals && !spglsl_treeops_hoistLiterals(*this, root)) {
+      return false;
+    }
+
     if (this->compilerOptions.mangle) {
+      this->_mangleMapKeys.load(this->symbols, root);
+    }
+
+    if (this->compilerOptions.optimizeGzip) {
+      this->_optimizeGzip(root);
+    } else if (this->compilerOptions.mangle) {
       this->_mangle(root);
     }
+
+    if (this->compilerOptions.mangle) {
+      this->mangleMap = this->_mangleMapKeys.exportNames(this->symbols);
+    }
   }
 
   return true;
 }
 
-void SpglslAngleCompiler::_mangle(sh::TIntermBlock * root) {
+void SpglslAngleCompiler::_mangle(sh::TIntermBlock * root, bool useTextWords) {
   SpglslSymbolUsage usage(this->symbols);
   SpglslSymbolGenerator symgen(usage);
+  symgen.useTextWords = useTextWords;
 
-  usage.load(root, this->precisions, &symgen);
+  usage.load(root, this->precisions, &symgen, &this->_mangleMapKeys);
 
+  int maxMangleId = 0;
   for (const auto & entry : usage.sorted) {
-    if (entry->mangleId > 0) {
+    maxMangleId = std::max(maxMangleId, entry->mangleId);
+  }
+  symgen.generateNames((size_t)maxMangleId);
+
+  for (const auto & entry : usage.sorted) {
+    if (!entry->importedName.empty()) {
+      entry->entry->renamed = entry->importedName;
+      entry->entry->mustBeRenamedUnique = false;
+    } else if (entry->mangleId > 0) {
       entry->entry->renamed = symgen.getOrCreateMangledName(entry->mangleId);
       entry->entry->mustBeRenamedUnique = false;
     }
   }
 
+  if (this->compilerOptions.mangleFields) {
+    SpglslFieldUsage fieldUsage;
+    fieldUsage.load(root);
+    fieldUsage.mangle(this->symbols, symgen);
+  }
+
   if (!this->symbols.compileOptions.mangle_global_map.isUndefined()) {
-    for (auto & kv : this->symbols._map) {
-      auto & sym = kv.second;
+    for (auto * info : this->symbols.entries()) {
+      auto & sym = *info;
       if (sym.symbol && sym.renamed.empty() && !sym.symbolName.empty()) {
-        auto * s = sym.symbolName.c_str();
-        auto globalRename = this->symbols.compileOptions.mangle_global_map[s];
+        auto globalRename = this->symbols.compileOptions.mangle_global_map[std::string(sym.symbolName)];
         if (globalRename.isString()) {
           sym.renamed = globalRename.as<std::string>();
           sym.mustBeRenamedUnique = false;
@@ -176,50 +223,223 @@ void SpglslAngleCompiler::_mangle(sh::TIntermBlock * root) {
   }
 }
 
-void SpglslAngleCompiler::loadPrecisions() {
-  this->precisions = SpglslGlslPrecisions();
-  if (this->compilerOptions.language == EShLangVertex) {
-    this->precisions.defaultIntPrecision = sh::TPrecision::EbpHigh;
-    this->precisions.defaultFloatPrecision = sh::TPrecision::EbpHigh;
-  } else {
-    this->precisions.defaultIntPrecision = sh::TPrecision::EbpMedium;
-    this->precisions.defaultFloatPrecision = sh::TPrecision::EbpUndefined;
+/** Global declarations that can be moved before all the functions without changing the meaning of the shader */
+static bool _isMovableGlobalDeclaration(sh::TIntermNode * node) {
+  sh::TIntermDeclaration * declaration = node->getAsDeclarationNode();
+  if (!declaration || declaration->getSequence()->size() != 1) {
+    return false;
+  }
+  sh::TIntermTyped * declarator = declaration->getSequence()->front()->getAsTyped();
+  sh::TIntermBinary * initializer = declarator ? declarator->getAsBinaryNode() : nullptr;
+  if (initializer) {
+    if (initializer->getOp() != sh::EOpInitialize || !initializer->getRight()->getAsConstantUnion()) {
+      return false;
+    }
+    declarator = initializer->getLeft();
   }
+  if (!declarator || !declarator->getAsSymbolNode()) {
+    return false;
+  }
+  const sh::TType & type = declarator->getType();
+  return type.getBasicType() != sh::EbtStruct && type.getBasicType() != sh::EbtInterfaceBlock;
+}
 
-  SpglslGetPrecisionsTraverser precisionsTraverser;
-  precisionsTraverser.traverseNode(this->body);
-  precisionsTraverser.count();
+static std::string _globalDeclarationGroupKey(sh::TIntermNode * node) {
+  sh::TIntermTyped * declarator = node->getAsDeclarationNode()->getSequence()->front()->getAsTyped();
+  const sh::TType & type = declarator->getType();
+  std::string key = sh::getQualifierString(type.getQualifier());
+  key += ' ';
+  key += sh::getPrecisionString(type.getPrecision());
+  key += ' ';
+  key += type.getBuiltInTypeNameString();
+  return key;
+}
 
-  this->precisions.floatPrecision = precisionsTraverser.floatPrecision;
-  this->precisions.intPrecision = precisionsTraverser.intPrecision;
+/**
+ * Moves the movable global declarations before everything else, grouped by qualifier and type,
+ * so consecutive declarations can be merged by the output ("uniform float a,b;") and repeat the same tokens.
+ */
+static sh::TIntermSequence _groupGlobalDeclarations(const sh::TIntermSequence & sequence) {
+  std::vector<std::string> groups;
+  std::unordered_map<std::string, std::vector<sh::TIntermNode *>> declarations;
+  sh::TIntermSequence rest;
+  for (sh::TIntermNode * node : sequence) {
+    if (_isMovableGlobalDeclaration(node)) {
+      auto key = _globalDeclarationGroupKey(node);
+      auto & group = declarations[key];
+      if (group.empty()) {
+        groups.push_back(key);
+      }
+      group.push_back(node);
+    } else {
+      rest.push_back(node);
+    }
+  }
+  sh::TIntermSequence result;
+  result.reserve(sequence.size());
+  for (const auto & key : groups) {
+    for (sh::TIntermNode * node : declarations[key]) {
+      result.push_back(node);
+    }
+  }
+  for (sh::TIntermNode * node : rest) {
+    result.push_back(node);
+  }
+  return result;
 }
 
-std::string SpglslAngleCompiler::decompileOutput() {
-  if (!this->body) {
-    return "";
+/** Collects the functions defined in the shader that a function calls */
+class SpglslFunctionCallsTraverser : public sh::TIntermTraverser {
+ public:
+  std::vector<const sh::TFunction *> callees;
+
+  SpglslFunctionCallsTraverser() : sh::TIntermTraverser(true, false, false) {
   }
-  std::ostringstream out;
 
-  SpglslAngleWebglOutput outputTraverser(out, this->symbols, this->precisions, this->compilerOptions.beautify);
+  bool visitAggregate(sh::Visit visit, sh::TIntermAggregate * node) override {
+    if (node->getOp() == sh::EOpCallFunctionInAST && node->getFunction()) {
+      this->callees.push_back(node->getFunction());
+    }
+    return true;
+  }
+};
 
-  outputTraverser.writeHeader(this->metadata.shaderVersion, this->metadata.pragma, this->extensionBehavior);
-  this->body->traverse(&outputTraverser);
+/**
+ * In each run of consecutive function definitions, moves the functions right before their first caller.
+ * The order is built from the callers, starting from the last function of the run (usually main), so the functions
+ * called together end up next to each other, in the same gzip window.
+ * A callee always stays before its callers, and the other nodes do not move, so the output stays valid.
+ */
+static sh::TIntermSequence _clusterFunctions(const sh::TIntermSequence & sequence) {
+  sh::TIntermSequence result;
+  result.reserve(sequence.size());
+
+  size_t i = 0;
+  while (i < sequence.size()) {
+    if (!sequence[i]->getAsFunctionDefinition()) {
+      result.push_back(sequence[i++]);
+      continue;
+    }
 
-  return out.str();
+    size_t runEnd = i;
+    std::unordered_map<const sh::TFunction *, size_t> indices;
+    while (runEnd < sequence.size() && sequence[runEnd]->getAsFunctionDefinition()) {
+      indices.emplace(sequence[runEnd]->getAsFunctionDefinition()->getFunction(), runEnd - i);
+      ++runEnd;
+    }
+
+    const size_t runLength = runEnd - i;
+    std::vector<std::vector<size_t>> callees(runLength);
+    for (size_t k = 0; k < runLength; ++k) {
+      SpglslFunctionCallsTraverser calls;
+      sequence[i + k]->traverse(&calls);
+      for (const sh::TFunction * callee : calls.callees) {
+        auto found = indices.find(callee);
+        if (found != indices.end() && found->second != k) {
+          callees[k].push_back(found->second);
+        }
+      }
+    }
+
+    // Post order visit from the last caller, the callees of a function are written before it in call order.
+    // A function not reached from the later ones is not called by any of them, it can be written after them.
+    // GLSL has no recursion.
+    std::vector<bool> emitted(runLength, false);
+    std::vector<std::pair<size_t, size_t>> stack;
+    for (size_t k = runLength; k-- > 0;) {
+      if (emitted[k]) {
+        continue;
+      }
+      emitted[k] = true;
+      stack.emplace_back(k, 0);
+      while (!stack.empty()) {
+        auto & top = stack.back();
+        if (top.second < callees[top.first].size()) {
+          size_t callee = callees[top.first][top.second++];
+          if (!emitted[callee]) {
+            emitted[callee] = true;
+            stack.emplace_back(callee, 0);
+          }
+        } else {
+          result.push_back(sequence[i + top.first]);
+          stack.pop_back();
+        }
+      }
+    }
+
+    i = runEnd;
+  }
+
+  return result;
 }
 
-class CollectVariablesTraverser : public sh::TIntermTraverser {
+void SpglslAngleCompiler::_optimizeGzip(sh::TIntermBlock * root) {
+  sh::TIntermSequence & sequence = *root->getSequence();
+
+  // Candidate layouts: source order, grouped global declarations, clustered functions, and both.
+  std::vector<sh::TIntermSequence> layouts;
+  layouts.push_back(sequence);
+  layouts.push_back(_groupGlobalDeclarations(layouts[0]));
+  layouts.push_back(_clusterFunctions(layouts[0]));
+  layouts.push_back(_clusterFunctions(layouts[1]));
+  for (size_t i = layouts.size() - 1; i > 0; --i) {
+    for (size_t j = 0; j < i; ++j) {
+      if (layouts[i] == layouts[j]) {
+        layouts.erase(layouts.begin() + i);
+        break;
+      }
+    }
+  }
+
+  const SpglslSymbolsState initialState = this->symbols.saveState();
+
+  const int layoutsCount = (int)layouts.size();
+  const int strategiesCount = this->compilerOptions.mangle ? 2 : 1;
+
+  size_t bestSize = 0;
+  int bestLayout = 0;
+  int bestStrategy = 0;
+  std::string output;
+
+  for (int layout = 0; layout < layoutsCount; ++layout) {
+    sequence = layouts[layout];
+    for (int strategy = 0; strategy < strategiesCount; ++strategy) {
+      this->symbols.restoreState(initialState);
+      if (this->compilerOptions.mangle) {
+        this->_mangle(root, strategy == 0);
+      }
+      this->decompileOutput(output);
+      size_t size = gzipSize(output);
+      if (bestSize == 0 || size < bestSize) {
+        bestSize = size;
+        bestLayout = layout;
+        bestStrategy = strategy;
+      }
+    }
+  }
+
+  sequence = layouts[bestLayout];
+  this->symbols.restoreState(initialState);
+  if (this->compilerOptions.mangle) {
+    this->_mangle(root, bestStrategy == 0);
+  }
+}
+
+/** Collects the uniforms and the shader inputs and outputs, their names are read after mangling */
+class SpglslInterfaceVariablesAnalysis : public SpglslAnalysis {
  public:
-  SpglslAngleCompiler & compiler;
+  std::vector<const sh::TVariable *> & uniforms;
+  std::vector<const sh::TVariable *> & globals;
 
-  explicit CollectVariablesTraverser(SpglslAngleCompiler & compiler) :
-      sh::TIntermTraverser(true, false, false, &compiler.symbolTable), compiler(compiler) {
+  SpglslInterfaceVariablesAnalysis(std::vector<const sh::TVariable *> & uniforms,
+      std::vector<const sh::TVariable *> & globals) :
+      uniforms(uniforms), globals(globals) {
   }
 
-  bool visitDeclaration(sh::Visit, sh::TIntermDeclaration * node) override {
+  void onDeclaration(sh::TIntermDeclaration * node) override {
     const sh::TIntermSequence & sequence = *(node->getSequence());
     if (sequence.empty()) {
-      return false;
+      return;
     }
 
     const sh::TIntermTyped & typedNode = *(sequence.front()->getAsTyped());
@@ -230,7 +450,7 @@ class CollectVariablesTraverser : public sh::TIntermTraverser {
         sh::IsVarying(qualifier);
 
     if (typedNode.getBasicType() != sh::EbtInterfaceBlock && !isShaderVariable) {
-      return false;
+      return;
     }
 
     for (sh::TIntermNode * variableNode : sequence) {
@@ -245,31 +465,131 @@ class CollectVariablesTraverser : public sh::TIntermTraverser {
         case sh::EvqBuffer:
         case sh::EvqFragmentIn:
         case sh::EvqFragmentOut:
-        case sh::EvqFragmentInOut: {
-          auto & v = this->compiler.symbols.get(&variable.variable());
-          const auto & name = this->compiler.symbols.getName(&variable.variable(), false);
-          const auto & renamed = this->compiler.symbols.getName(&variable.variable(), true);
-          this->compiler.globalsMap.emplace(name, renamed);
-          break;
-        }
-
-        case sh::EvqUniform: {
-          auto & v = this->compiler.symbols.get(&variable.variable());
-          const auto & name = this->compiler.symbols.getName(&variable.variable(), false);
-          const auto & renamed = this->compiler.symbols.getName(&variable.variable(), true);
-          this->compiler.uniformsMap.emplace(name, renamed);
-          break;
-        }
-
+        case sh::EvqFragmentInOut: this->globals.push_back(&variable.variable()); break;
+        case sh::EvqUniform: this->uniforms.push_back(&variable.variable()); break;
         default: break;
       }
     }
+  }
+};
+
+void SpglslAngleCompiler::_findRepeatedSubtrees(sh::TIntermBlock * root) {
+  AngleAstHashCache hashCache(&this->symbolTable);
+  AngleAstHashIndex hashIndex(hashCache);
+  hashIndex.build(root);
+
+  this->repeatedSubtrees.clear();
+  for (const auto & group : hashIndex.largestRepeatedSubtrees(3)) {
+    sh::TIntermNode * node = group.front();
+    SpglslRepeatedSubtree repeated{hashIndex.subtreeSize(node), {node->getLine().first_line}};
+    for (sh::TIntermNode * duplicate : hashIndex.duplicatesOf(node)) {
+      repeated.lines.push_back(duplicate->getLine().first_line);
+    }
+    std::sort(repeated.lines.begin(), repeated.lines.end());
+    this->repeatedSubtrees.push_back(std::move(repeated));
+  }
+}
+
+void SpglslAngleCompiler::loadPrecisions() {
+  this->precisions = SpglslGlslPrecisions();
+  if (this->compilerOptions.language == EShLangVertex) {
+    this->precisions.defaultIntPrecision = sh::TPrecision::EbpHigh;
+    this->precisions.defaultFloatPrecision = sh::TPrecision::EbpHigh;
+  } else {
+    this->precisions.defaultIntPrecision = sh::TPrecision::EbpMedium;
+    this->precisions.defaultFloatPrecision = sh::TPrecision::EbpUndefined;
+  }
 
+  // The interface variables are collected in the same walk, the tree ops that follow do not change them.
+  SpglslGetPrecisionsTraverser precisionsTraverser;
+  SpglslInterfaceVariablesAnalysis variablesAnalysis(this->_uniformVariables, this->_globalVariables);
+  this->_uniformVariables.clear();
+  this->_globalVariables.clear();
+
+  SpglslAnalysisTraverser traverser;
+  traverser.subscribe(&precisionsTraverser);
+  traverser.subscribe(&variablesAnalysis);
+  traverser.traverseNode(this->body);
+  this->_interfaceVariablesLoaded = true;
+
+  precisionsTraverser.count();
+
+  this->precisions.floatPrecision = precisionsTraverser.floatPrecision;
+  this->precisions.intPrecision = precisionsTraverser.intPrecision;
+}
+
+std::string SpglslAngleCompiler::decompileOutput() {
+  std::string out;
+  this->decompileOutput(out);
+  return out;
+}
+
+void SpglslAngleCompiler::decompileOutput(std::string & out, SpglslSourceMap * sourceMap) {
+  out.clear();
+  if (!this->body) {
+    return;
+  }
+  // The minified output is usually smaller than the source, this avoids reallocations in most cases.
+  out.reserve(this->_sourceLength + 256);
+
+#ifdef SPGLSL_PARALLEL_OUTPUT
+  // The source map needs the mappings in output order, it is written serially.
+  if (!sourceMap && this->_decompileOutputParallel(out)) {
+    return;
+  }
+#endif
+
+  SpglslAngleWebglOutput outputTraverser(
+      out, this->symbols, this->precisions, this->compilerOptions.beautify, &this->floatLiteralCache);
+
+  outputTraverser.lowPrecisionLiterals = this->compilerOptions.lowPrecisionLiterals;
+  outputTraverser.sourceMap = sourceMap;
+
+  outputTraverser.writeHeader(this->metadata.shaderVersion, this->metadata.pragma, this->extensionBehavior);
+  this->body->traverse(&outputTraverser);
+}
+
+#ifdef SPGLSL_PARALLEL_OUTPUT
+bool SpglslAngleCompiler::_decompileOutputParallel(std::string & out) {
+  const unsigned outputThreads = this->compilerOptions.outputThreads;
+  unsigned threadsCount = outputThreads ? outputThreads : std::thread::hardware_concurrency();
+  if (threadsCount <= 1 || this->_sourceLength < this->compilerOptions.parallelOutputMinSourceLength) {
     return false;
   }
-};
+
+  SpglslAngleParallelOutput outputTraverser(
+      out, this->symbols, this->precisions, this->compilerOptions.beautify, &this->floatLiteralCache);
+
+  outputTraverser.lowPrecisionLiterals = this->compilerOptions.lowPrecisionLiterals;
+
+  outputTraverser.writeHeader(this->metadata.shaderVersion, this->metadata.pragma, this->extensionBehavior);
+  if (outputTraverser.writeBody(this->body, threadsCount)) {
+    return true;
+  }
+  out.clear();
+  return false;
+}
+#endif
 
 void SpglslAngleCompiler::_collectVariables(sh::TIntermBlock * root) {
-  CollectVariablesTraverser collectVariablesTraverser(*this);
-  root->traverse(&collectVariablesTraverser);
+  if (!this->_interfaceVariablesLoaded) {
+    // loadPrecisions did not run, the AST is walked only for the variables.
+    SpglslInterfaceVariablesAnalysis variablesAnalysis(this->_uniformVariables, this->_globalVariables);
+    SpglslAnalysisTraverser traverser;
+    traverser.subscribe(&variablesAnalysis);
+    traverser.traverseNode(root);
+    this->_interfaceVariablesLoaded = true;
+  }
+
+  for (const sh::TVariable * variable : this->_globalVariables) {
+    const auto & name = this->symbols.getName(variable, false);
+    const auto & renamed = this->symbols.getName(variable, true);
+    this->globalsMap.emplace(name, renamed);
+  }
+
+  for (const sh::TVariable * variable : this->_uniformVariables) {
+    const auto & name = this->symbols.getName(variable, false);
+    const auto & renamed = this->symbols.getName(variable, true);
+    this->uniformsMap.emplace(name, renamed);
+  }
 }
@@ -8,6 +8,7 @@
 #include <angle/src/compiler/translator/IntermNode.h>
 #include <emscripten/bind.h>
 
+#include "../core/float-literal-cache.h"
 #include "../core/hash-stream.h"
 #include "../core/non-copyable.h"
 #include "../spglsl-compiled-info.h"
@@ -15,11 +16,21 @@
 #include "lib/spglsl-t-compiler.h"
 #include "spglsl-angle-call-dag.h"
 #include "spglsl-module-metadata.h"
+#include "symbols/spglsl-mangle-map.h"
 #include "symbols/spglsl-symbol-info.h"
 
 class SpglslAngleCompilerHandle;
+class SpglslSourceMap;
 class SpglslAngleCompilerBase : NonCopyable {};
 
+/** A subtree that appears more than once in the source, reported by reportRepeatedSubtrees */
+struct SpglslRepeatedSubtree {
+  /** Number of AST nodes in one occurrence */
+  size_t nodes;
+  /** Source line of each occurrence, in ascending order */
+  std::vector<int> lines;
+};
+
 class SpglslAngleCompiler : public SpglslTCompilerHolder {
  public:
   const SpglslCompileOptions & compilerOptions;
@@ -31,10 +42,17 @@ class SpglslAngleCompiler : public SpglslTCompilerHolder {
   SpglslGlslPrecisions precisions;
   SpglslCompiledInfo compiledInfo;
 
+  /** Float literals written by this compiler, the same values are written at every decompileOutput */
+  SpglslFloatLiteralCache floatLiteralCache;
+
   /** After compiling, will contain all the uniforms */
   std::map<std::string, std::string> uniformsMap;
   /** After compiling, will contain all the shader inputs and outputs, excluding uniforms */
   std::map<std::string, std::string> globalsMap;
+  /** After mangling, will contain the stable keys of the renamed symbols and their new name */
+  std::map<std::string, std::string> mangleMap;
+  /** If reportRepeatedSubtrees is true, the largest repeated subtrees of the source, largest first */
+  std::vector<SpglslRepeatedSubtree> repeatedSubtrees;
 
   explicit SpglslAngleCompiler(sh::GLenum shaderType, SpglslCompileOptions & compilerOptions);
 
@@ -44,12 +62,35 @@ class SpglslAngleCompiler : public SpglslTCompilerHolder {
 
   std::string decompileOutput();
 
+  /**
+   * Writes the output in the given buffer, replacing its content. Reusing the buffer avoids reallocations.
+   * If a source map is given, the mappings of the written output are added to it.
+   */
+  void decompileOutput(std::string & out, SpglslSourceMap * sourceMap = nullptr);
+
  private:
   bool _checkAndSimplifyAST(sh::TIntermBlock * root, const sh::TParseContext & parseContext);
-  void _mangle(sh::TIntermBlock * root);
+  void _mangle(sh::TIntermBlock * root, bool useTextWords = true);
+  void _optimizeGzip(sh::TIntermBlock * root);
   void _collectVariables(sh::TIntermBlock * root);
+  void _findRepeatedSubtrees(sh::TIntermBlock * root);
+
+  /**
+   * Writes the output of a large shader with the outputThreads option, returns false if it must be written serially.
+   * Ignored by the builds without threads, the output is the same with any number of threads.
+   */
+  bool _decompileOutputParallel(std::string & out);
 
   std::vector<SpglslAngleFunctionMetadata> _functionMetadata;
+  SpglslMangleMap _mangleMapKeys;
+
+  /** Length of the compiled source code, used to reserve the output buffer */
+  size_t _sourceLength = 0;
+
+  /** Uniforms and shader inputs and outputs, collected with the precisions and named by _collectVariables */
+  std::vector<const sh::TVariable *> _uniformVariables;
+  std::vector<const sh::TVariable *> _globalVariables;
+  bool _interfaceVariablesLoaded = false;
 };
 
 #endif
@@ -0,0 +1,234 @@
+#include "spglsl-angle-parallel-output.h"
+
+#ifdef SPGLSL_PARALLEL_OUTPUT
+
+#include <angle/src/compiler/translator/PoolAlloc.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+/** Collects the symbols and the structs a function reads while it is written */
+class SpglslFunctionDependenciesTraverser : public sh::TIntermTraverser {
+ public:
+  std::vector<const sh::TSymbol *> symbols;
+  std::vector<const sh::TStructure *> structs;
+
+  SpglslFunctionDependenciesTraverser() : sh::TIntermTraverser(true, false, false) {
+  }
+
+  void visitSymbol(sh::TIntermSymbol * node) override {
+    this->symbols.push_back(&node->variable());
+    this->addType(node->getType());
+  }
+
+  void visitConstantUnion(sh::TIntermConstantUnion * node) override {
+    this->addType(node->getType());
+  }
+
+  bool visitSwizzle(sh::Visit visit, sh::TIntermSwizzle * node) override {
+    this->addType(node->getType());
+    return true;
+  }
+
+  bool visitBinary(sh::Visit visit, sh::TIntermBinary * node) override {
+    this->addType(node->getType());
+    return true;
+  }
+
+  bool visitUnary(sh::Visit visit, sh::TIntermUnary * node) override {
+    this->addType(node->getType());
+    return true;
+  }
+
+  bool visitTernary(sh::Visit visit, sh::TIntermTernary * node) override {
+    this->addType(node->getType());
+    return true;
+  }
+
+  bool visitAggregate(sh::Visit visit, sh::TIntermAggregate * node) override {
+    this->addType(node->getType());
+    if (node->getFunction()) {
+      this->symbols.push_back(node->getFunction());
+    }
+    return true;
+  }
+
+  void visitFunctionPrototype(sh::TIntermFunctionPrototype * node) override {
+    const sh::TFunction * func = node->getFunction();
+    this->symbols.push_back(func);
+    this->addType(func->getReturnType());
+    for (size_t i = 0, len = func->getParamCount(); i < len; ++i) {
+      const sh::TVariable * param = func->getParam(i);
+      this->symbols.push_back(param);
+      this->addType(param->getType());
+    }
+  }
+
+ private:
+  void addType(const sh::TType & type) {
+    const sh::TStructure * structure = type.getStruct();
+    if (structure) {
+      this->structs.push_back(structure);
+      this->symbols.push_back(structure);
+    }
+  }
+};
+
+/** Writes a function in a separate thread, the names of the symbols are only read */
+class SpglslAngleFunctionOutput : public SpglslAngleWebglOutput {
+ public:
+  /** True if a symbol had no name yet, the written text is not valid */
+  bool failed = false;
+
+  SpglslAngleFunctionOutput(std::string & out,
+      SpglslSymbols & symbols,
+      const SpglslGlslPrecisions & precisions,
+      bool beautify) :
+      SpglslAngleWebglOutput(out, symbols, precisions, beautify) {
+  }
+
+  std::string_view getSymbolName(const sh::TSymbol * symbol) override {
+    const SpglslSymbolInfo * info = this->symbols.find(symbol);
+    if (!info || (info->renamed.empty() && info->mustBeRenamedUnique)) {
+      this->failed = true;
+      return std::string_view();
+    }
+    return info->renamed.empty() ? info->symbolName : info->renamed;
+  }
+
+  /** Writes a function continuing from the given state, returns true if the state after it is the expected one */
+  bool writeFunction(sh::TIntermFunctionDefinition * node, int indentLevel, char lastCh, char lastLastCh) {
+    this->setIndentLevel(indentLevel);
+    this->setLastChars(lastCh, lastLastCh);
+    this->traverseNode(node);
+    return !this->failed && this->getLastCh() == '}' && this->getIndentLevel() == indentLevel &&
+        this->isAtStatementBoundary();
+  }
+};
+
+SpglslAngleParallelOutput::SpglslAngleParallelOutput(std::string & out,
+    SpglslSymbols & symbols,
+    const SpglslGlslPrecisions & precisions,
+    bool beautify,
+    SpglslFloatLiteralCache * floatLiteralCache) :
+    SpglslAngleWebglOutput(out, symbols, precisions, beautify, floatLiteralCache) {
+}
+
+bool SpglslAngleParallelOutput::canDeferFunction(sh::TIntermFunctionDefinition * node) {
+  SpglslFunctionDependenciesTraverser dependencies;
+  node->traverse(&dependencies);
+
+  for (const sh::TStructure * structure : dependencies.structs) {
+    if (this->declaredStructs.count(structure) == 0) {
+      return false;  // The struct would be declared inside the function
+    }
+  }
+
+  for (const sh::TSymbol * symbol : dependencies.symbols) {
+    const SpglslSymbolInfo * info = this->symbols.find(symbol);
+    if (!info || (info->renamed.empty() && info->mustBeRenamedUnique)) {
+      return false;  // The name would be assigned while writing the function
+    }
+  }
+
+  return true;
+}
+
+bool SpglslAngleParallelOutput::deferFunctionDefinition(sh::TIntermFunctionDefinition * node) {
+  if (!this->isAtStatementBoundary() || !this->canDeferFunction(node)) {
+    return false;
+  }
+
+  this->_deferredFunctions.push_back(
+      DeferredFunction{node, this->out.size(), this->getIndentLevel(), this->getLastCh(), this->getLastLastCh()});
+
+  // A function always ends with '}', the character before it is never read before the next one is written.
+  this->setLastChars('}', '}');
+  return true;
+}
+
+bool SpglslAngleParallelOutput::writeBody(sh::TIntermBlock * body, unsigned threadsCount) {
+  this->_deferredFunctions.clear();
+  this->_parallelFunctionsCount = 0;
+  body->traverse(this);
+
+  const size_t count = this->_deferredFunctions.size();
+  if (count == 0) {
+    return true;
+  }
+
+  struct FunctionText {
+    size_t buffer;
+    size_t begin;
+    size_t end;
+  };
+
+  threadsCount = std::max(1U, std::min(threadsCount, (unsigned)count));
+  std::vector<std::string> buffers(threadsCount);
+  std::vector<FunctionText> texts(count);
+  std::atomic<size_t> nextFunction{0};
+  std::atomic<bool> failed{false};
+
+  auto writeFunctions = [&](size_t bufferIndex) {
+    // The ANGLE pool allocator is per thread, ArrayString and the other helpers allocate from it.
+    angle::PoolAllocator allocator;
+    allocator.push();
+    SetGlobalPoolAllocator(&allocator);
+    {
+      std::string & buffer = buffers[bufferIndex];
+      SpglslAngleFunctionOutput output(buffer, this->symbols, this->precisions, this->beautify);
+      output.declaredStructs = this->declaredStructs;
+      output.lowPrecisionLiterals = this->lowPrecisionLiterals;
+
+      for (size_t i = nextFunction++; i < count && !failed; i = nextFunction++) {
+        const DeferredFunction & deferred = this->_deferredFunctions[i];
+        const size_t begin = buffer.size();
+        if (!output.writeFunction(deferred.node, deferred.indentLevel, deferred.lastCh, deferred.lastLastCh)) {
+          failed = true;
+          break;
+        }
+        texts[i] = FunctionText{bufferIndex, begin, buffer.size()};
+      }
+    }
+    SetGlobalPoolAllocator(nullptr);
+    allocator.pop();
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(threadsCount);
+  for (size_t i = 0; i < threadsCount; ++i) {
+    threads.emplace_back(writeFunctions, i);
+  }
+  for (auto & thread : threads) {
+    thread.join();
+  }
+
+  if (failed) {
+    return false;
+  }
+
+  size_t totalLength = this->out.size();
+  for (const auto & buffer : buffers) {
+    totalLength += buffer.size();
+  }
+
+  std::string result;
+  result.reserve(totalLength);
+  size_t position = 0;
+  for (size_t i = 0; i < count; ++i) {
+    const FunctionText & text = texts[i];
+    const size_t insertPosition = this->_deferredFunctions[i].position;
+    result.append(this->out, position, insertPosition - position);
+    result.append(buffers[text.buffer], text.begin, text.end - text.begin);
+    position = insertPosition;
+  }
+  result.append(this->out, position, std::string::npos);
+  this->out.swap(result);
+
+  this->_parallelFunctionsCount = count;
+  this->_deferredFunctions.clear();
+  return true;
+}
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef _SPGLSL_ANGLE_PARALLEL_OUTPUT_H_
+#define _SPGLSL_ANGLE_PARALLEL_OUTPUT_H_
+
+#if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+#define SPGLSL_PARALLEL_OUTPUT 1
+#endif
+
+#ifdef SPGLSL_PARALLEL_OUTPUT
+
+#include <vector>
+
+#include "spglsl-angle-webgl-output.h"
+
+/**
+ * Writes the functions at the root of the shader concurrently, in separate buffers.
+ * The root statements are written serially, the functions that only read the state resolved before them
+ * (the declared structs and the names of their symbols) are skipped and written later by the threads.
+ * The buffers are then inserted in source order, the output is identical to the one of SpglslAngleWebglOutput.
+ */
+class SpglslAngleParallelOutput : public SpglslAngleWebglOutput {
+ public:
+  SpglslAngleParallelOutput(std::string & out,
+      SpglslSymbols & symbols,
+      const SpglslGlslPrecisions & precisions,
+      bool beautify,
+      SpglslFloatLiteralCache * floatLiteralCache = nullptr);
+
+  /**
+   * Writes the whole body, after the header.
+   * Returns false if the written text could not be merged, the caller must write the output again serially.
+   */
+  bool writeBody(sh::TIntermBlock * body, unsigned threadsCount);
+
+  /** Number of functions written by the threads in the last writeBody */
+  inline size_t getParallelFunctionsCount() const {
+    return this->_parallelFunctionsCount;
+  }
+
+ protected:
+  bool deferFunctionDefinition(sh::TIntermFunctionDefinition * node) override;
+
+ private:
+  struct DeferredFunction {
+    sh::TIntermFunctionDefinition * node;
+    /** Position in the output where the text of the function is inserted */
+    size_t position;
+    int indentLevel;
+    char lastCh;
+    char lastLastCh;
+  };
+
+  std::vector<DeferredFunction> _deferredFunctions;
+  size_t _parallelFunctionsCount = 0;
+
+  bool canDeferFunction(sh::TIntermFunctionDefinition * node);
+};
+
+#endif
+
+#endif
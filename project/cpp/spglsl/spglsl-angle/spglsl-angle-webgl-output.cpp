@@ -4,19 +4,25 @@
 #include <angle/src/compiler/translator/Symbol.h>
 #include <angle/src/compiler/translator/util.h>
 
+#include <algorithm>
+#include <cstring>
+
 #include "../core/math-utils.h"
 #include "lib/spglsl-angle-node-utils.h"
 #include "lib/spglsl-angle-operator-precedence.h"
 #include "symbols/spglsl-symbol-info.h"
 
-SpglslAngleWebglOutput::SpglslAngleWebglOutput(std::ostream & out,
+SpglslAngleWebglOutput::SpglslAngleWebglOutput(std::string & out,
     SpglslSymbols & symbols,
     const SpglslGlslPrecisions & precisions,
-    bool beautify) :
-    SpglslScopedTraverser(symbols), SpglslGlslWriter(out, precisions, beautify) {
+    bool beautify,
+    SpglslFloatLiteralCache * floatLiteralCache) :
+    SpglslScopedTraverser(symbols),
+    SpglslGlslWriter(out, precisions, beautify),
+    floatLiteralCache(floatLiteralCache) {
 }
 
-const std::string & SpglslAngleWebglOutput::getSymbolName(const sh::TSymbol * symbol) {
+std::string_view SpglslAngleWebglOutput::getSymbolName(const sh::TSymbol * symbol) {
   return this->symbols.getName(symbol);
 }
 
@@ -26,13 +32,13 @@ std::string SpglslAngleWebglOutput::getFunctionName(sh::TIntermAggregate * aggre
   }
   const auto op = aggregateNode->getOp();
   if (op == sh::EOpCallInternalRawFunction || op == sh::EOpCallFunctionInAST || sh::BuiltInGroup::IsBuiltIn(op)) {
-    return this->getSymbolName(aggregateNode->getFunction());
+    return std::string(this->getSymbolName(aggregateNode->getFunction()));
   }
   return sh::GetOperatorString(op);
 }
 
 std::string SpglslAngleWebglOutput::getFieldName(const sh::TField * field) {
-  return field ? field->name().data() : Strings::empty;
+  return field ? std::string(this->symbols.getFieldName(field)) : Strings::empty;
 }
 
 std::string SpglslAngleWebglOutput::getBuiltinTypeName(const sh::TType * type) {
@@ -44,10 +50,10 @@ std::string SpglslAngleWebglOutput::getTypeName(const sh::TType * type) {
     return Strings::empty;
   }
   if (type->getBasicType() == sh::EbtStruct && type->getStruct()) {
-    return this->getSymbolName(type->getStruct());
+    return std::string(this->getSymbolName(type->getStruct()));
   }
   if (type->getBasicType() == sh::EbtInterfaceBlock && type->getInterfaceBlock()) {
-    return this->getSymbolName(type->getInterfaceBlock());
+    return std::string(this->getSymbolName(type->getInterfaceBlock()));
   }
   return this->getBuiltinTypeName(type);
 }
@@ -87,7 +93,9 @@ void SpglslAngleWebglOutput::writeTOperatorNode(sh::TIntermOperator * node) {
         if (!fn) {
           break;
         }
-        this->write(this->getSymbolName(fn));
+        const auto & name = this->getSymbolName(fn);
+        this->write(name);
+        this->addSourceMapping(aggregateNode, fn, name.length());
         return;
       }
 
@@ -120,8 +128,11 @@ void SpglslAngleWebglOutput::writeConstantUnionSingleValue(const sh::TConstantUn
     case sh::EbtInt: this->write(int32ToGlsl(value->getIConst())); break;
     case sh::EbtUInt: this->write(uint32ToGlsl(value->getUConst())); break;
     case sh::EbtBool: this->write(value->getBConst() ? "true" : "false"); break;
-    case sh::EbtYuvCscStandardEXT: out << getYuvCscStandardEXTString(value->getYuvCscStandardEXTConst()); break;
-    default: this->write(floatToGlsl(value->getFConst(), needsParentheses, needsFloat)); break;
+    case sh::EbtYuvCscStandardEXT: this->write(getYuvCscStandardEXTString(value->getYuvCscStandardEXTConst())); break;
+    default:
+      this->write(floatToGlsl(
+          value->getFConst(), needsParentheses, needsFloat, this->floatLiteralCache, this->_literalMantissaBits));
+      break;
   }
 }
 
@@ -351,20 +362,67 @@ void SpglslAngleWebglOutput::writeVariableDeclaration(sh::TIntermNode & child) {
   }
 
   const auto & name = this->getSymbolName(&variable);
-  this->write(name).write(sh::ArrayString(type));
+  this->write(name);
+  this->addSourceMapping(childSym, &variable, name.length());
+  this->write(sh::ArrayString(type));
 
   this->_lastWrittenVarDecl = &type;
   this->_canForwardVarDecl = !name.empty();
 }
 
 void SpglslAngleWebglOutput::visitSymbol(sh::TIntermSymbol * node) {
-  this->write(this->getSymbolName(&node->variable()));
+  const auto & name = this->getSymbolName(&node->variable());
+  this->write(name);
+  this->addSourceMapping(node, &node->variable(), name.length());
 }
 
 void SpglslAngleWebglOutput::visitConstantUnion(sh::TIntermConstantUnion * node) {
   sh::TIntermBinary * parentBinary = nodeGetAsBinaryNode(this->getParentNode());
   bool canSkipParentheses = parentBinary != nullptr && parentBinary->getOp() == sh::EOpAssign;
+
+  this->_literalMantissaBits = FLOAT_MANTISSA_BITS_HIGHP;
+  if (this->lowPrecisionLiterals && node->getBasicType() == sh::EbtFloat) {
+    switch (nodeGetConsumingPrecision(this->getParentNode(), node)) {
+      case sh::EbpMedium: this->_literalMantissaBits = FLOAT_MANTISSA_BITS_MEDIUMP; break;
+      case sh::EbpLow: this->_literalMantissaBits = FLOAT_MANTISSA_BITS_LOWP; break;
+      default: break;
+    }
+  }
+
   this->writeConstantUnion(&node->getType(), node->getConstantValue(), !canSkipParentheses);
+  this->_literalMantissaBits = FLOAT_MANTISSA_BITS_HIGHP;
+}
+
+void SpglslAngleWebglOutput::addSourceMapping(sh::TIntermNode * node, const sh::TSymbol * symbol, size_t length) {
+  // Nodes created by the optimizations do not have a source line.
+  if (!this->sourceMap || !node || node->getLine().first_line <= 0) {
+    return;
+  }
+
+  const size_t end = this->out.size();
+  const char * text = this->out.data();
+  while (this->_sourceMapScanned < end) {
+    const void * found = memchr(text + this->_sourceMapScanned, '\n', end - this->_sourceMapScanned);
+    if (!found) {
+      this->_sourceMapScanned = end;
+      break;
+    }
+    this->_sourceMapScanned = (size_t)((const char *)found - text) + 1;
+    this->_sourceMapLineStart = this->_sourceMapScanned;
+    ++this->_sourceMapLine;
+  }
+
+  int32_t nameIndex = -1;
+  if (symbol) {
+    const SpglslSymbolInfo & info = this->symbols.get(symbol);
+    if (!info.renamed.empty() && !info.symbolName.empty() && info.renamed != info.symbolName) {
+      nameIndex = this->sourceMap->addName(symbol, info.symbolName);
+    }
+  }
+
+  const size_t start = end - std::min(length, end - this->_sourceMapLineStart);
+  this->sourceMap->add(this->_sourceMapLine, (uint32_t)(start - this->_sourceMapLineStart),
+      (uint32_t)(node->getLine().first_line - 1), nameIndex);
 }
 
 void SpglslAngleWebglOutput::visitPreprocessorDirective(sh::TIntermPreprocessorDirective * node) {
@@ -512,7 +570,10 @@ void SpglslAngleWebglOutput::beforeVisitFunctionPrototype(sh::TIntermFunctionPro
   this->writeVariableType(type, false);
   this->write(sh::ArrayString(type));
   const auto * proto = node->getFunction();
-  this->write(this->getSymbolName(proto)).write('(');
+  const auto & name = this->getSymbolName(proto);
+  this->write(name);
+  this->addSourceMapping(node, proto, name.length());
+  this->write('(');
 }
 
 void SpglslAngleWebglOutput::afterVisitFunctionPrototype(sh::TIntermFunctionPrototype * node,
@@ -560,6 +621,7 @@ void SpglslAngleWebglOutput::onVisitBlock(sh::TIntermBlock * node) {
             this->_skipNextBlockBraces = true;
           }
           this->beautyNewLine().indent();
+          this->addSourceMapping(child);
           this->traverseNode(child);
           if (isIntermNodeSingleStatement(child) && (!isVarDecl)) {
             this->writeStatementSemicolon();
@@ -567,6 +629,11 @@ void SpglslAngleWebglOutput::onVisitBlock(sh::TIntermBlock * node) {
           this->deindent().beautyDoubleNewLine();
         } else {
           this->beautyStatementNewLine(true);
+          if (child->getAsFunctionDefinition() && this->deferFunctionDefinition(child->getAsFunctionDefinition())) {
+            prev = child;
+            continue;
+          }
+          this->addSourceMapping(child);
           this->traverseNode(child);
           if (isIntermNodeSingleStatement(child) && (!isVarDecl)) {
             this->writeStatementSemicolon();
@@ -584,6 +651,15 @@ void SpglslAngleWebglOutput::onVisitBlock(sh::TIntermBlock * node) {
   }
 }
 
+bool SpglslAngleWebglOutput::deferFunctionDefinition(sh::TIntermFunctionDefinition * node) {
+  return false;
+}
+
+bool SpglslAngleWebglOutput::isAtStatementBoundary() const {
+  return !this->_lastWrittenVarDecl && !this->_canForwardVarDecl && !this->_isInsideForInit &&
+      !this->_skipNextBlockBraces && this->_literalMantissaBits == FLOAT_MANTISSA_BITS_HIGHP;
+}
+
 void SpglslAngleWebglOutput::onVisitForLoop(sh::TIntermLoop * node, bool infinite) {
   this->clearLastWrittenVarDecl();
   this->write("for").beautySpace().write('(');
@@ -769,8 +845,8 @@ void SpglslAngleWebglOutput::writeHeader(int shaderVersion,
   this->beautyDoubleNewLine();
 
   bool hasVariables = false;
-  for (const auto & iter : this->symbols._map) {
-    if (!iter.second.symbolName.empty()) {
+  for (const auto * info : this->symbols.entries()) {
+    if (!info->symbolName.empty()) {
       hasVariables = true;
       break;
     }
@@ -5,11 +5,14 @@
 #include <angle/src/compiler/translator/Pragma.h>
 #include <angle/src/compiler/translator/tree_util/IntermTraverse.h>
 
-#include <sstream>
+#include <string>
 #include <unordered_set>
 
+#include "../core/float-literal-cache.h"
+#include "../core/math-utils.h"
 #include "../core/string-utils.h"
 #include "lib/spglsl-glsl-writer.h"
+#include "lib/spglsl-source-map.h"
 #include "spglsl-scoped-traverser.h"
 #include "symbols/spglsl-symbol-info.h"
 
@@ -17,10 +20,20 @@ class SpglslAngleWebglOutput : public SpglslScopedTraverser, public SpglslGlslWr
  public:
   std::unordered_set<const sh::TStructure *> declaredStructs;
 
-  SpglslAngleWebglOutput(std::ostream & out,
+  /** Optional cache of the float literals, owned by the compiler */
+  SpglslFloatLiteralCache * floatLiteralCache;
+
+  /** If true, float literals consumed by mediump or lowp expressions are written only as precise as needed */
+  bool lowPrecisionLiterals = false;
+
+  /** Optional source map, receives the source line of the statements and symbols as they are written */
+  SpglslSourceMap * sourceMap = nullptr;
+
+  SpglslAngleWebglOutput(std::string & out,
       SpglslSymbols & symbols,
       const SpglslGlslPrecisions & precisions,
-      bool beautify);
+      bool beautify,
+      SpglslFloatLiteralCache * floatLiteralCache = nullptr);
 
   void visitSymbol(sh::TIntermSymbol * node) override;
   void visitConstantUnion(sh::TIntermConstantUnion * node) override;
@@ -40,7 +53,7 @@ class SpglslAngleWebglOutput : public SpglslScopedTraverser, public SpglslGlslWr
   void writeHeader(int shaderVersion, const TPragma & pragma, const sh::TExtensionBehavior & extensionBehavior);
   void writeTOperatorNode(sh::TIntermOperator * node);
 
-  virtual const std::string & getSymbolName(const sh::TSymbol * symbol);
+  virtual std::string_view getSymbolName(const sh::TSymbol * symbol);
   virtual std::string getTypeName(const sh::TType * type);
   virtual std::string getFieldName(const sh::TField * field);
   std::string getFunctionName(sh::TIntermAggregate * aggregateNode);
@@ -58,6 +71,15 @@ class SpglslAngleWebglOutput : public SpglslScopedTraverser, public SpglslGlslWr
   void onVisitWhileLoop(sh::TIntermLoop * node) override;
   void onVisitDoWhileLoop(sh::TIntermLoop * node) override;
 
+  /**
+   * Called before writing a function definition.
+   * If it returns true the function is not written, its text is inserted later by the caller at the current position.
+   */
+  virtual bool deferFunctionDefinition(sh::TIntermFunctionDefinition * node);
+
+  /** True if nothing written so far changes how the next statement is written, other than the last characters */
+  bool isAtStatementBoundary() const;
+
  private:
   void traverseCodeBlock(sh::TIntermBlock * node);
   void traverseWithParentheses(sh::TIntermNode * node, int operandIndex);
@@ -77,10 +99,19 @@ class SpglslAngleWebglOutput : public SpglslScopedTraverser, public SpglslGlslWr
   void clearLastWrittenVarDecl();
   bool needsToClearLastWrittenVarDecl();
 
+  /** Maps the last written length characters to the source line of a node, and to the original name of a symbol */
+  void addSourceMapping(sh::TIntermNode * node, const sh::TSymbol * symbol = nullptr, size_t length = 0);
+
   int _isInsideForInit = 0;
   bool _canForwardVarDecl = false;
   bool _skipNextBlockBraces = true;
   const sh::TType * _lastWrittenVarDecl = nullptr;
+  int _literalMantissaBits = FLOAT_MANTISSA_BITS_HIGHP;
+
+  /** Output position up to which the lines were counted for the source map */
+  size_t _sourceMapScanned = 0;
+  size_t _sourceMapLineStart = 0;
+  uint32_t _sourceMapLine = 0;
 };
 
 #endif
@@ -0,0 +1,125 @@
+#include "spglsl-field-usage.h"
+
+#include <algorithm>
+
+#include "../lib/spglsl-angle-node-utils.h"
+#include "spglsl-symbol-usage.h"
+
+/** Variables with these qualifiers are not visible outside of the shader */
+static bool _isLocalQualifier(sh::TQualifier qualifier) {
+  switch (qualifier) {
+    case sh::EvqTemporary:
+    case sh::EvqGlobal:
+    case sh::EvqConst:
+    case sh::EvqParamIn:
+    case sh::EvqParamOut:
+    case sh::EvqParamInOut:
+    case sh::EvqParamConst: return true;
+    default: return false;
+  }
+}
+
+class SpglslFieldUsageTraverser : public sh::TIntermTraverser {
+ public:
+  SpglslFieldUsage & usage;
+
+  explicit SpglslFieldUsageTraverser(SpglslFieldUsage & usage) :
+      sh::TIntermTraverser(true, false, false), usage(usage) {
+  }
+
+  bool visitDeclaration(sh::Visit visit, sh::TIntermDeclaration * node) override {
+    for (sh::TIntermNode * child : *node->getSequence()) {
+      sh::TIntermBinary * initializer = nodeGetAsBinaryNode(child, sh::EOpInitialize);
+      sh::TIntermTyped * declarator = initializer ? initializer->getLeft() : child->getAsTyped();
+      if (declarator) {
+        const sh::TType & type = declarator->getType();
+        this->usage.addType(type);
+        if (type.isInterfaceBlock() || !_isLocalQualifier(type.getQualifier())) {
+          this->usage.exportType(type);
+        }
+      }
+    }
+    return true;
+  }
+
+  void visitFunctionPrototype(sh::TIntermFunctionPrototype * node) override {
+    const sh::TFunction * function = node->getFunction();
+    this->usage.addType(function->getReturnType());
+    for (size_t i = 0, paramCount = function->getParamCount(); i < paramCount; ++i) {
+      this->usage.addType(function->getParam(i)->getType());
+    }
+  }
+
+  bool visitBinary(sh::Visit visit, sh::TIntermBinary * node) override {
+    if (node->getOp() == sh::EOpIndexDirectStruct) {
+      const sh::TStructure * structure = node->getLeft()->getType().getStruct();
+      sh::TIntermConstantUnion * indexNode = nodeGetAsConstantUnion(node->getRight());
+      const int fieldIndex = indexNode ? indexNode->getIConst(0) : -1;
+      if (structure && fieldIndex >= 0 && (size_t)fieldIndex < structure->fields().size()) {
+        ++this->usage.frequency[structure->fields()[fieldIndex]];
+      }
+    }
+    return true;
+  }
+};
+
+////////////////////////////////////////
+//    Class SpglslFieldUsage
+////////////////////////////////////////
+
+void SpglslFieldUsage::load(sh::TIntermBlock * root) {
+  this->structs.clear();
+  this->exportedStructs.clear();
+  this->frequency.clear();
+  SpglslFieldUsageTraverser traverser(*this);
+  root->traverse(&traverser);
+}
+
+void SpglslFieldUsage::addType(const sh::TType & type) {
+  const sh::TStructure * structure = type.getStruct();
+  if (!structure || std::find(this->structs.begin(), this->structs.end(), structure) != this->structs.end()) {
+    return;
+  }
+  this->structs.push_back(structure);
+  for (const sh::TField * field : structure->fields()) {
+    this->addType(*field->type());
+  }
+}
+
+void SpglslFieldUsage::exportType(const sh::TType & type) {
+  const sh::TFieldListCollection * fields = type.getStruct();
+  if (fields) {
+    if (!this->exportedStructs.emplace(type.getStruct()).second) {
+      return;
+    }
+  } else {
+    fields = type.getInterfaceBlock();
+  }
+  if (fields) {
+    for (const sh::TField * field : fields->fields()) {
+      this->exportType(*field->type());
+    }
+  }
+}
+
+void SpglslFieldUsage::mangle(SpglslSymbols & symbols, SpglslSymbolGenerator & generator) const {
+  std::vector<std::pair<const sh::TField *, uint32_t>> sortedFields;
+  for (const sh::TStructure * structure : this->structs) {
+    if (structure->symbolType() != sh::SymbolType::UserDefined || this->exportedStructs.count(structure) != 0) {
+      continue;
+    }
+
+    sortedFields.clear();
+    for (const sh::TField * field : structure->fields()) {
+      auto found = this->frequency.find(field);
+      sortedFields.emplace_back(field, found != this->frequency.end() ? found->second : 0);
+    }
+    std::stable_sort(sortedFields.begin(), sortedFields.end(),
+        [](const auto & a, const auto & b) { return a.second > b.second; });
+
+    // Fields have their own namespace, every struct can reuse the most frequent names.
+    for (size_t i = 0; i < sortedFields.size(); ++i) {
+      symbols.renamedFields[sortedFields[i].first] = generator.getOrCreateMangledName((int)i + 1);
+    }
+  }
+}
@@ -0,0 +1,39 @@
+#ifndef _SPGLSL_FIELD_USAGE_
+#define _SPGLSL_FIELD_USAGE_
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "spglsl-symbol-info.h"
+
+class SpglslSymbolGenerator;
+
+/**
+ * Usage of the fields of the user defined structs, used to rename the fields when mangleFields is enabled.
+ * Structs reachable from uniforms, shader inputs and outputs and interface blocks are exported,
+ * their fields keep the names used by the application.
+ */
+class SpglslFieldUsage : NonCopyable {
+ public:
+  /** The user defined structs found in the shader, in the order they are found */
+  std::vector<const sh::TStructure *> structs;
+
+  std::unordered_set<const sh::TStructure *> exportedStructs;
+
+  /** How many times each field is accessed */
+  std::unordered_map<const sh::TField *, uint32_t> frequency;
+
+  void load(sh::TIntermBlock * root);
+
+  /** Renames the fields of the structs that are not exported, the most used fields get the shortest names */
+  void mangle(SpglslSymbols & symbols, SpglslSymbolGenerator & generator) const;
+
+  /** Adds the structs used by a type */
+  void addType(const sh::TType & type);
+
+  /** Marks the structs used by a type as exported */
+  void exportType(const sh::TType & type);
+};
+
+#endif
@@ -0,0 +1,107 @@
+#include "spglsl-mangle-map.h"
+
+#include <cstdio>
+
+#include "../lib/spglsl-angle-ast-hasher.h"
+#include "../spglsl-scoped-traverser.h"
+
+static std::string _functionKey(const sh::TFunction * fn) {
+  std::string key = fn->name().data();
+  key += '(';
+  for (size_t i = 0, paramCount = fn->getParamCount(); i < paramCount; ++i) {
+    if (i != 0) {
+      key += ',';
+    }
+    key += fn->getParam(i)->getType().getMangledName().data();
+  }
+  key += ')';
+  return key;
+}
+
+class SpglslMangleMapKeysTraverser : public SpglslScopedTraverser {
+ public:
+  SpglslMangleMap & mangleMap;
+
+  SpglslMangleMapKeysTraverser(SpglslSymbols & symbols, SpglslMangleMap & mangleMap) :
+      SpglslScopedTraverser(symbols), mangleMap(mangleMap) {
+  }
+
+ protected:
+  void onSymbolDeclaration(const sh::TSymbol * symbol,
+      sh::TIntermNode * node,
+      SpglslSymbolDeclarationKind kind) override {
+    const auto & name = this->symbols.get(symbol).symbolName;
+    if (name.empty() || this->mangleMap.keys.count(symbol) != 0) {
+      return;
+    }
+
+    if (symbol->isFunction()) {
+      this->mangleMap.keys.emplace(symbol, _functionKey(static_cast<const sh::TFunction *>(symbol)));
+      return;
+    }
+
+    sh::TIntermFunctionDefinition * definition = this->getCurrentFunctionDefinition();
+    if (!definition) {
+      this->mangleMap.keys.emplace(symbol, std::string(name));
+      return;
+    }
+
+    if (definition != this->_function) {
+      this->_function = definition;
+      this->_functionPrefix = this->_makeFunctionPrefix(definition);
+      this->_ordinals.clear();
+    }
+
+    std::string key = this->_functionPrefix;
+    key += name;
+    key += '#';
+    key += std::to_string(this->_ordinals[std::string(name)]++);
+    this->mangleMap.keys.emplace(symbol, std::move(key));
+  }
+
+ private:
+  sh::TIntermFunctionDefinition * _function = nullptr;
+  std::string _functionPrefix;
+  std::unordered_map<std::string, uint32_t> _ordinals;
+
+  std::string _makeFunctionPrefix(sh::TIntermFunctionDefinition * definition) {
+    AngleAstHasher hasher(this->symbols.symbolTable);
+    hasher.hashSymbolNames = true;
+    auto hash = hasher.computeNodeHash(definition);
+
+    char fingerprint[17];
+    snprintf(fingerprint, sizeof(fingerprint), "%016llx", (unsigned long long)hash.a);
+
+    std::string prefix = _functionKey(definition->getFunction());
+    prefix += '@';
+    prefix += fingerprint;
+    prefix += '/';
+    return prefix;
+  }
+};
+
+////////////////////////////////////////
+//    Class SpglslMangleMap
+////////////////////////////////////////
+
+void SpglslMangleMap::load(SpglslSymbols & symbols, sh::TIntermBlock * root) {
+  this->keys.clear();
+  SpglslMangleMapKeysTraverser traverser(symbols, *this);
+  root->traverse(&traverser);
+}
+
+const std::string * SpglslMangleMap::getKey(const sh::TSymbol * symbol) const {
+  auto found = this->keys.find(symbol);
+  return found != this->keys.end() ? &found->second : nullptr;
+}
+
+std::map<std::string, std::string> SpglslMangleMap::exportNames(SpglslSymbols & symbols) const {
+  std::map<std::string, std::string> result;
+  for (const auto & kv : this->keys) {
+    const auto & info = symbols.get(kv.first);
+    if (!info.renamed.empty() && !symbols.isReserved(info)) {
+      result.emplace(kv.second, info.renamed);
+    }
+  }
+  return result;
+}
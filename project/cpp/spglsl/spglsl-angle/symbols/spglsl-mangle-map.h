@@ -0,0 +1,29 @@
+#ifndef _SPGLSL_MANGLE_MAP_
+#define _SPGLSL_MANGLE_MAP_
+
+#include <map>
+#include <string>
+#include <unordered_map>
+
+#include "spglsl-symbol-info.h"
+
+/**
+ * Stable keys of the declared symbols, used to export the names assigned by the mangler
+ * and to import them in a later compilation, so the code that did not change keeps the same names.
+ * Globals are keyed by name and functions by name and parameter types.
+ * Locals and parameters are keyed by their function, a fingerprint of the function definition,
+ * their name and their declaration order, so they keep their names only if the function did not change.
+ */
+class SpglslMangleMap : NonCopyable {
+ public:
+  std::unordered_map<const sh::TSymbol *, std::string> keys;
+
+  void load(SpglslSymbols & symbols, sh::TIntermBlock * root);
+
+  const std::string * getKey(const sh::TSymbol * symbol) const;
+
+  /** Map of the keys of the renamed symbols and their new name */
+  std::map<std::string, std::string> exportNames(SpglslSymbols & symbols) const;
+};
+
+#endif
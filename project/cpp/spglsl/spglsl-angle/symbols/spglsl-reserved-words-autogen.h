@@ -0,0 +1,128 @@
+// Generated by scripts/generate-reserved-words.js, do not edit.
+
+#ifndef _SPGLSL_RESERVED_WORDS_AUTOGEN_
+#define _SPGLSL_RESERVED_WORDS_AUTOGEN_
+
+#include <cstdint>
+#include <string_view>
+
+constexpr uint32_t spglslReservedWordsCount = 437;
+constexpr uint32_t spglslReservedWordsTableSize = 1024;
+constexpr uint32_t spglslReservedWordsBucketsCount = 110;
+
+constexpr uint16_t spglslReservedWordsDisplacements[spglslReservedWordsBucketsCount] = {
+    2, 3, 3, 1, 1, 2, 1, 5, 2, 3, 2, 7, 1, 1, 1, 4, 1, 1, 3, 2, 4, 1, 1, 1, 2, 1, 2, 3, 3, 1, 3, 1, 1, 3, 1, 5, 1, 1,
+    1, 5, 3, 1, 4, 10, 2, 5, 9, 3, 1, 1, 3, 1, 1, 1, 2, 3, 1, 2, 1, 1, 3, 1, 3, 2, 1, 8, 3, 5, 2, 2, 1, 3, 8, 1, 1, 4,
+    1, 6, 1, 1, 2, 3, 1, 2, 12, 1, 2, 4, 2, 6, 3, 2, 1, 3, 3, 3, 1, 1, 6, 2, 2, 4, 2, 1, 1, 12, 1, 5, 1, 3,
+};
+
+constexpr std::string_view spglslReservedWordsTable[spglslReservedWordsTableSize] = {
+    "", "", "textureGrad", "clamp", "", "", "", "", "unsigned", "", "", "", "", "bitfieldInsert", "",
+    "gl_NumWorkGroups", "", "", "short", "", "", "image2DShadow", "", "textureGatherOffsets", "", "asin",
+    "gl_VertexIndex", "", "", "iimage2D", "sampler2DRect", "", "", "gl_MaxComputeTextureImageUnits", "", "", "active",
+    "", "", "", "", "vec2", "faceforward", "", "", "", "unpackUnorm4x8", "", "", "", "", "outerProduct", "", "",
+    "struct", "atan", "iimage1D", "", "", "frexp", "", "", "packHalf2x16", "", "", "", "", "", "", "textureVideoWEBGL",
+    "memoryBarrier", "uimage2D", "", "", "", "", "gl_FragDepth", "", "", "reflect", "gl_PrimitiveID", "", "lowp",
+    "input", "", "", "", "", "dmat3x3", "", "default", "", "", "atomicCounterIncrement", "isampler2DRect", "atanh", "",
+    "lessThan", "textureCubeLod", "texelFetchOffset", "", "", "ivec3", "atomicMax", "", "", "isamplerBuffer", "", "",
+    "isampler2DMSArray", "", "", "", "imageStore", "", "isampler1D", "", "", "packUnorm2x16", "", "", "", "fixed", "",
+    "", "acos", "", "gl_MaxGeometryTotalOutputComponents", "", "step", "", "", "", "", "imageSize", "", "dot",
+    "gl_MaxVertexTextureImageUnits", "", "break", "", "floatBitsToInt", "ivec4", "", "unpackSnorm2x16", "", "dmat4x2",
+    "acosh", "", "", "textureOffset", "gl_MaxGeometryAtomicCounterBuffers", "smoothstep", "hvec3", "uint", "", "",
+    "textureLod", "mat4", "volatile", "", "gl_MaxFragmentAtomicCounterBuffers", "", "", "memoryBarrierShared", "exp",
+    "gl_MaxProgramTexelOffset", "uvec4", "", "", "", "", "", "", "", "", "", "gl_MaxFragmentImageUniforms", "", "", "",
+    "", "gl_HelperInvocation", "", "gl_MaxAtomicCounterBindings", "", "", "", "", "", "dmat3", "", "uimage1DArray",
+    "texture3DProjLod", "", "", "", "gl_MaxImageUnits", "", "", "", "inverse", "gl_MaxVertexAttribs", "texture3DProj",
+    "gl_VertexID", "", "far", "", "", "", "normalize", "", "isampler1DArray", "subroutine", "", "", "", "",
+    "isampler2D", "", "", "", "isampler2DArray", "gl_MaxGeometryTotalOutputComponents(", "texture2D", "continue",
+    "gl_MaxComputeImageUniforms", "", "", "", "unpackHalf2x16", "tan", "", "", "atomicCompSwap", "textureProjLod", "",
+    "", "external", "", "", "image1D", "", "", "namespace", "", "", "", "patch", "", "", "", "", "pow", "", "", "",
+    "equal", "transpose", "distance", "", "uimage2DArray", "", "", "image2DArray", "textureGatherOffset", "mat4x3", "",
+    "image2DArrayShadow", "true", "", "", "case", "", "", "mat4x2", "highp", "", "", "", "texture", "",
+    "gl_ViewportIndex", "", "", "", "", "typedef", "", "uniform", "", "", "", "switch", "gl_MaxFragmentInputVectors",
+    "", "gl_MaxClipDistances", "", "", "", "mediump", "notEqual", "", "", "", "", "", "packed", "", "", "", "", "", "",
+    "", "atomicAdd", "", "greaterThan", "", "", "intBitsToFloat", "", "", "", "", "const", "matrixCompMult", "", "",
+    "", "", "findLSB", "yuv_2_rgb", "", "noinline", "cross", "", "", "", "gl_MaxCombinedAtomicCounterBuffers",
+    "findMSB", "vec4", "tanh", "", "", "", "", "", "gl_MaxComputeWorkGroupCount", "", "", "gl_SecondaryFragColorEXT",
+    "", "", "dmat4x4", "", "textureCubeLodEXT", "", "gl_MaxComputeAtomicCounterBuffers", "", "", "gl_PrimitiveIDIn",
+    "uvec2", "textureProjGrad", "", "", "", "sampler2DArray", "asm", "textureGather", "gl_FragData", "", "",
+    "gl_DrawID", "", "", "interface", "fvec4", "iimage3D", "", "", "", "not", "", "", "noperspective", "", "main",
+    "sampler3D", "", "", "", "gl_LastFragData", "", "gl_MaxGeometryAtomicCounterBuffers(", "atomicOr", "", "",
+    "gl_LastFragColorARM", "", "output", "double", "angle_BaseVertex", "", "union", "dvec2", "", "", "", "bvec3", "",
+    "gl_MaxGeometryOutputVertices", "xor", "sampler2DMSArray", "", "", "", "dmat2", "gl_MaxGeometryAtomicCounters",
+    "sign", "texture2DLodEXT", "", "", "gl_InstanceID", "textureCubeGradEXT", "", "texture2DProjLodEXT", "inversesqrt",
+    "", "", "", "", "", "sampler1DArrayShadow", "", "", "mat3x4", "memoryBarrierImage", "", "", "", "", "",
+    "textureProjOffset", "", "", "", "", "", "uimage3D", "", "", "textureGradOffset", "usamplerCube", "", "discard",
+    "", "sample", "gl_MaxFragmentAtomicCounterBuffers(", "out", "", "texture2DProjLod", "", "fwidth", "isampler3D", "",
+    "", "", "", "superp", "or", "refract", "", "", "public", "", "", "", "", "", "unpackSnorm4x8", "", "", "",
+    "gl_MaxVertexAtomicCounters", "", "", "", "cast", "gl_InstanceIndex", "gl_MaxGeometryOutputComponents", "",
+    "ldexp", "atomicMin", "", "", "do", "uimageCube", "gl_Layer", "", "", "gl_MaxAtomicCounterBufferSize", "", "",
+    "sampler2DRectShadow", "", "gl_GlobalInvocationID", "isamplerCubeArray", "", "", "sampler2DMS", "", "fract", "",
+    "textureProjLodOffset", "", "gl_FrontFacing", "vec3", "usampler2DArray", "samplerCubeArrayShadow", "", "", "",
+    "atomicXor", "", "determinant", "gl_MaxCombinedAtomicCounters", "", "texelFetch", "", "", "", "imageLoad", "", "",
+    "", "", "image1DShadow", "centroid", "", "dFdx", "iimageCube", "", "this", "", "", "", "lessThanEqual", "",
+    "texture2DProj", "", "dmat3x4", "uimageBuffer", "", "packSnorm4x8", "", "gl_MaxVertexUniformVectors", "", "bool",
+    "", "bitfieldExtract", "", "length", "", "gl_MaxCombinedShaderOutputResources(", "", "cos", "", "usampler2D",
+    "static", "gl_MaxGeometryImageUniforms", "sampler2DShadow", "gl_MaxVertexOutputVectors", "",
+    "sampler2DArrayShadow", "sizeof", "", "hvec4", "iimageBuffer", "inout", "", "floatBitsToUint", "", "uvec3", "",
+    "gl_MinProgramTexelOffset", "", "", "gl_in", "", "", "atomicExchange", "usampler2DMSArray", "",
+    "gl_MaxVertexAtomicCounterBuffers", "extern", "", "", "", "", "gl_MaxDualSourceDrawBuffersEXT",
+    "usamplerCubeArray", "flat", "packSnorm2x16", "", "texture2DProjGradEXT", "isampler2DMS", "", "", "usampler2DRect",
+    "", "if", "row_major", "gl_MaxTextureImageUnits", "gl_FragDepthEXT", "", "EndPrimitive", "", "dmat2x3", "",
+    "bvec4", "smooth", "mat3x3", "half", "", "", "near", "", "mat2x4", "gl_WorkGroupSize", "", "", "",
+    "gl_MaxCombinedShaderOutputResources", "textureCube", "", "", "", "", "atomicAnd", "", "", "", "gl_LastFragColor",
+    "gl_MaxGeometryTextureImageUnits", "", "", "", "", "void", "gl_MaxVertexAtomicCounterBuffers(", "", "for",
+    "uimage1D", "", "texture3DLod", "", "", "", "", "dvec4", "", "", "mat4x4", "", "", "", "degrees", "", "", "", "",
+    "uaddCarry", "max", "", "", "", "gl_MaxComputeAtomicCounterBuffers(", "using", "gl_MaxGeometryUniformComponents",
+    "", "mat2x2", "", "atomicCounterDecrement", "precision", "", "", "", "dvec3", "log2", "", "isinf", "", "",
+    "mat3x2", "texture2DRectProj", "long", "", "", "gl_MaxFragmentUniformVectors", "asinh", "", "", "enum",
+    "textureSize", "", "gl_MaxCombinedTextureImageUnits", "", "gl_ClipDistance", "sqrt", "round", "bitfieldReverse",
+    "", "angle_BaseInstance", "", "exp2", "", "", "", "", "", "", "greaterThanEqual", "", "gl_InvocationID", "", "",
+    "", "fvec2", "image2D", "mix", "", "sampler1DShadow", "", "", "", "", "", "dmat2x4", "mat2x3",
+    "gl_MaxComputeAtomicCounters", "textureLodOffset", "", "", "groupMemoryBarrier", "", "", "usampler3D", "", "", "",
+    "", "dmat4", "", "dmat4x3", "hvec2", "partition", "else", "log", "", "", "", "gl_SecondaryFragDataEXT", "",
+    "iimage1DArray", "gl_MaxCombinedAtomicCounterBuffers(", "gl_MaxComputeUniformComponents", "",
+    "gl_MaxComputeWorkGroupSize", "image1DArray", "", "floor", "dFdy", "trunc", "layout", "", "", "attribute", "", "",
+    "image1DArrayShadow", "class", "gl_PerVertex", "", "", "gl_LocalInvocationID", "sampler3DRect", "", "sin", "", "",
+    "", "ceil", "", "gl_MaxVertexImageUniforms", "", "", "gl_MaxFragmentAtomicCounters", "uintBitsToFloat", "",
+    "ivec2", "", "", "imageCube", "", "", "", "gl_DepthRangeParameters", "and", "", "", "", "", "dmat2x2", "mat2", "",
+    "", "min", "", "", "fma", "int", "usamplerBuffer", "", "", "", "fvec3", "", "", "", "", "", "", "", "", "", "", "",
+    "", "textureProjGradOffset", "", "gl_ViewID_OVR", "", "", "", "image3D", "", "gl_WorkGroupID", "texture2DLod",
+    "float", "", "gl_BaseVertex", "", "", "", "", "EmitVertex", "", "", "", "", "", "in", "packUnorm4x8", "", "abs",
+    "", "false", "", "", "isamplerCube", "", "", "", "sampler1D", "", "cosh", "texture2DRect", "", "", "", "", "all",
+    "unpackUnorm2x16", "isnan", "", "", "", "", "", "", "", "", "gl_PointSize", "", "samplerCubeShadow", "",
+    "template", "", "", "mod", "", "", "", "", "", "", "", "", "", "", "", "imulExtended", "", "umulExtended", "", "",
+    "gl_MaxVaryingVectors", "rgb_2_yuv", "", "gl_MaxDrawBuffers", "", "varying", "", "atomicCounter", "usubBorrow",
+    "filter", "barrier", "", "", "", "gl_MaxGeometryInputComponents", "bvec2", "", "gl_FragCoord", "", "common", "",
+    "", "gl_FragColor", "", "sinh", "", "", "", "", "diff", "", "", "sampler2D", "mat3", "", "", "memoryBarrierBuffer",
+    "while", "", "inline", "", "", "", "gl_LocalInvocationIndex", "", "", "", "", "", "", "", "", "", "samplerCube",
+    "", "roundEven", "", "gl_MaxCombinedImageUniforms", "", "radians", "texture2DGradEXT", "", "", "return",
+    "imageBuffer", "", "memoryBarrierAtomicCounter", "", "", "gl_BaseInstance", "", "", "textureProj", "", "bitCount",
+    "usampler1DArray", "gl_PointCoord", "usampler1D", "", "goto", "", "", "invariant", "", "gl_Position", "", "",
+    "usampler2DMS", "any", "", "", "gl_DepthRange", "dmat3x2", "sampler1DArray", "", "", "", "", "", "modf",
+    "samplerBuffer", "iimage2DArray", "", "samplerCubeArray", "", "", "texture3D",
+};
+
+constexpr uint32_t spglslReservedWordHash(std::string_view word, uint32_t seed) {
+  uint32_t h = 0x811c9dc5u ^ seed;
+  for (char c : word) {
+    h = (h ^ (uint8_t)c) * 0x01000193u;
+  }
+  h = (h ^ (h >> 16)) * 0x7feb352du;
+  h = (h ^ (h >> 15)) * 0x846ca68bu;
+  return h ^ (h >> 16);
+}
+
+/** True if the word is a GLSL keyword or built-in name, without any allocation */
+constexpr bool spglslReservedWordsHas(std::string_view word) {
+  if (word.empty()) {
+    return false;
+  }
+  const uint32_t bucket = spglslReservedWordHash(word, 0) % spglslReservedWordsBucketsCount;
+  const uint32_t slot = spglslReservedWordHash(word, spglslReservedWordsDisplacements[bucket]);
+  return spglslReservedWordsTable[slot & (spglslReservedWordsTableSize - 1)] == word;
+}
+
+static_assert(spglslReservedWordsHas("main") && spglslReservedWordsHas("vec4") && !spglslReservedWordsHas("a"));
+
+#endif
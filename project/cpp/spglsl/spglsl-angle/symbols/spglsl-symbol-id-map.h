@@ -0,0 +1,98 @@
+#ifndef _SPGLSL_SYMBOL_ID_MAP_
+#define _SPGLSL_SYMBOL_ID_MAP_
+
+#include <angle/src/compiler/translator/Symbol.h>
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "../../core/non-copyable.h"
+
+/**
+ * Dense store of values indexed by the unique id of the symbols, without hashing.
+ * Values are allocated in pages of fixed size, so references stay valid when other values are added.
+ * The null symbol has its own value, that always exists.
+ */
+template <typename T>
+class SpglslSymbolIdMap : NonCopyable {
+ public:
+  static constexpr size_t PAGE_BITS = 8;
+  static constexpr size_t PAGE_SIZE = (size_t)1 << PAGE_BITS;
+
+  /** Gets the value of a symbol, or null if it was never added */
+  inline T * find(const sh::TSymbol * symbol) {
+    Slot * slot = this->_findSlot(symbol);
+    return slot && slot->symbol == symbol ? &slot->value : nullptr;
+  }
+
+  inline const T * find(const sh::TSymbol * symbol) const {
+    return const_cast<SpglslSymbolIdMap *>(this)->find(symbol);
+  }
+
+  /** Gets the value of a symbol, adding a default constructed value if it was never added */
+  inline T & get(const sh::TSymbol * symbol, bool & added) {
+    Slot * slot = this->_findSlot(symbol);
+    if (slot && slot->symbol == symbol) {
+      added = false;
+      return slot->value;
+    }
+    added = true;
+    return this->_add(symbol, slot);
+  }
+
+  /** All the values of the non null symbols, in the order they were added */
+  inline const std::vector<T *> & values() const {
+    return this->_values;
+  }
+
+ private:
+  struct Slot {
+    const sh::TSymbol * symbol = nullptr;
+    T value;
+  };
+
+  Slot _null;
+  std::vector<std::unique_ptr<Slot[]>> _pages;
+  std::vector<T *> _values;
+
+  /** Symbols with the same unique id of another symbol, it should not happen but ANGLE does not guarantee it */
+  std::unordered_map<const sh::TSymbol *, std::unique_ptr<Slot>> _collisions;
+
+  inline Slot * _findSlot(const sh::TSymbol * symbol) {
+    if (!symbol) {
+      return &this->_null;
+    }
+    const size_t id = (size_t)symbol->uniqueId().get();
+    const size_t page = id >> PAGE_BITS;
+    if (page >= this->_pages.size() || !this->_pages[page]) {
+      return nullptr;
+    }
+    Slot * slot = &this->_pages[page][id & (PAGE_SIZE - 1)];
+    if (slot->symbol && slot->symbol != symbol) {
+      auto found = this->_collisions.find(symbol);
+      return found != this->_collisions.end() ? found->second.get() : slot;
+    }
+    return slot;
+  }
+
+  /** Adds a non null symbol, slot is the free or colliding slot found by _findSlot, or null if the page is missing */
+  T & _add(const sh::TSymbol * symbol, Slot * slot) {
+    if (!slot) {
+      const size_t id = (size_t)symbol->uniqueId().get();
+      const size_t page = id >> PAGE_BITS;
+      if (page >= this->_pages.size()) {
+        this->_pages.resize(page + 1);
+      }
+      this->_pages[page].reset(new Slot[PAGE_SIZE]);
+      slot = &this->_pages[page][id & (PAGE_SIZE - 1)];
+    } else if (slot->symbol) {
+      slot = (this->_collisions[symbol] = std::make_unique<Slot>()).get();
+    }
+    slot->symbol = symbol;
+    this->_values.push_back(&slot->value);
+    return slot->value;
+  }
+};
+
+#endif
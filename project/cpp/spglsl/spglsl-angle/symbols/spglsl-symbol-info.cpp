@@ -2,6 +2,7 @@
 #include <string>
 #include "../lib/spglsl-angle-node-utils.h"
 #include "../spglsl-scoped-traverser.h"
+#include "spglsl-reserved-words-autogen.h"
 
 void _loadSymbolName(SpglslSymbolInfo & entry) {
   const sh::TSymbol * symbol = entry.symbol;
@@ -33,7 +34,7 @@ void _loadSymbolName(SpglslSymbolInfo & entry) {
     }
   }
 
-  entry.symbolName = std::string(n.data(), len);
+  entry.symbolName = std::string_view(n.data(), len);
 }
 
 void SpglslSymbols::renameUnique(const sh::TIntermSymbol * symbolNode) {
@@ -50,13 +51,18 @@ void SpglslSymbols::renameUnique(const sh::TSymbol * symbol) {
 }
 
 bool SpglslSymbols::has(const sh::TSymbol * symbol) const {
-  auto found = this->_map.find(symbol);
-  return found != this->_map.end() && found->second.symbol != nullptr;
+  return this->find(symbol) != nullptr;
+}
+
+const SpglslSymbolInfo * SpglslSymbols::find(const sh::TSymbol * symbol) const {
+  const SpglslSymbolInfo * found = this->_infos.find(symbol);
+  return found && found->symbol != nullptr ? found : nullptr;
 }
 
 SpglslSymbolInfo & SpglslSymbols::get(const sh::TSymbol * symbol) {
-  SpglslSymbolInfo & result = this->_map[symbol];
-  if (!result.symbol && symbol) {
+  bool added;
+  SpglslSymbolInfo & result = this->_infos.get(symbol, added);
+  if (added) {
     result.symbol = symbol;
     _loadSymbolName(result);
   }
@@ -65,7 +71,34 @@ SpglslSymbolInfo & SpglslSymbols::get(const sh::TSymbol * symbol) {
 
 SpglslSymbols::SpglslSymbols(sh::TSymbolTable * symbolTable, SpglslCompileOptions & compileOptions) :
     symbolTable(symbolTable), compileOptions(compileOptions) {
-  auto & n = this->_map[nullptr];
+}
+
+SpglslSymbolsState SpglslSymbols::saveState() const {
+  SpglslSymbolsState state;
+  state.uniqueCounter = this->_uniqueCounter;
+  const auto & entries = this->entries();
+  state.renamed.reserve(entries.size());
+  for (const auto * info : entries) {
+    state.renamed.emplace_back(info->renamed, info->mustBeRenamedUnique);
+  }
+  state.renamedFields = this->renamedFields;
+  return state;
+}
+
+void SpglslSymbols::restoreState(const SpglslSymbolsState & state) {
+  this->_uniqueCounter = state.uniqueCounter;
+  this->renamedFields = state.renamedFields;
+  const auto & entries = this->entries();
+  for (size_t i = 0; i < entries.size(); ++i) {
+    auto * info = entries[i];
+    if (i < state.renamed.size()) {
+      info->renamed = state.renamed[i].first;
+      info->mustBeRenamedUnique = state.renamed[i].second;
+    } else {
+      info->renamed.clear();
+      info->mustBeRenamedUnique = false;
+    }
+  }
 }
 
 bool SpglslSymbols::isReserved(const SpglslSymbolInfo & info) const {
@@ -111,78 +144,12 @@ bool SpglslSymbols::isReserved(const SpglslSymbolInfo & info) const {
   return !symbol->isStruct();
 }
 
-static std::unordered_set<std::string> spglslReservedWordSet({"main", "and", "or", "xor", "not", "EmitVertex",
-    "EndPrimitive", "abs", "acos", "acosh", "active", "all", "angle_BaseInstance", "angle_BaseVertex", "any", "asin",
-    "asinh", "asm", "atan", "atanh", "atomicAdd", "atomicAnd", "atomicCompSwap", "atomicCounter",
-    "atomicCounterDecrement", "atomicCounterIncrement", "atomicExchange", "atomicMax", "atomicMin", "atomicOr",
-    "atomicXor", "attribute", "barrier", "bitCount", "bitfieldExtract", "bitfieldInsert", "bitfieldReverse", "bool",
-    "break", "bvec2", "bvec3", "bvec4", "case", "cast", "ceil", "centroid", "clamp", "class", "common", "const",
-    "continue", "cos", "cosh", "cross", "dFdx", "dFdy", "default", "degrees", "determinant", "diff", "discard",
-    "distance", "dmat2", "dmat2x2", "dmat2x3", "dmat2x4", "dmat3", "dmat3x2", "dmat3x3", "dmat3x4", "dmat4", "dmat4x2",
-    "dmat4x3", "dmat4x4", "do", "dot", "double", "dvec2", "dvec3", "dvec4", "else", "enum", "equal", "exp", "exp2",
-    "extern", "external", "faceforward", "false", "far", "filter", "findLSB", "findMSB", "fixed", "flat", "float",
-    "floatBitsToInt", "floatBitsToUint", "floor", "fma", "for", "fract", "frexp", "fvec2", "fvec3", "fvec4", "fwidth",
-    "gl_BaseInstance", "gl_BaseVertex", "gl_ClipDistance", "gl_DepthRange", "gl_DepthRangeParameters", "gl_DrawID",
-    "gl_FragColor", "gl_FragCoord", "gl_FragData", "gl_FragDepth", "gl_FragDepthEXT", "gl_FrontFacing",
-    "gl_GlobalInvocationID", "gl_HelperInvocation", "gl_InstanceID", "gl_InstanceIndex", "gl_InvocationID",
-    "gl_LastFragColor", "gl_LastFragColorARM", "gl_LastFragData", "gl_Layer", "gl_LocalInvocationID",
-    "gl_LocalInvocationIndex", "gl_MaxAtomicCounterBindings", "gl_MaxAtomicCounterBufferSize", "gl_MaxClipDistances",
-    "gl_MaxCombinedAtomicCounterBuffers", "gl_MaxCombinedAtomicCounterBuffers(", "gl_MaxCombinedAtomicCounters",
-    "gl_MaxCombinedImageUniforms", "gl_MaxCombinedShaderOutputResources", "gl_MaxCombinedShaderOutputResources(",
-    "gl_MaxCombinedTextureImageUnits", "gl_MaxComputeAtomicCounterBuffers", "gl_MaxComputeAtomicCounterBuffers(",
-    "gl_MaxComputeAtomicCounters", "gl_MaxComputeImageUniforms", "gl_MaxComputeTextureImageUnits",
-    "gl_MaxComputeUniformComponents", "gl_MaxComputeWorkGroupCount", "gl_MaxComputeWorkGroupSize", "gl_MaxDrawBuffers",
-    "gl_MaxDualSourceDrawBuffersEXT", "gl_MaxFragmentAtomicCounterBuffers", "gl_MaxFragmentAtomicCounterBuffers(",
-    "gl_MaxFragmentAtomicCounters", "gl_MaxFragmentImageUniforms", "gl_MaxFragmentInputVectors",
-    "gl_MaxFragmentUniformVectors", "gl_MaxGeometryAtomicCounterBuffers", "gl_MaxGeometryAtomicCounterBuffers(",
-    "gl_MaxGeometryAtomicCounters", "gl_MaxGeometryImageUniforms", "gl_MaxGeometryInputComponents",
-    "gl_MaxGeometryOutputComponents", "gl_MaxGeometryOutputVertices", "gl_MaxGeometryTextureImageUnits",
-    "gl_MaxGeometryTotalOutputComponents", "gl_MaxGeometryTotalOutputComponents(", "gl_MaxGeometryUniformComponents",
-    "gl_MaxImageUnits", "gl_MaxProgramTexelOffset", "gl_MaxTextureImageUnits", "gl_MaxVaryingVectors",
-    "gl_MaxVertexAtomicCounterBuffers", "gl_MaxVertexAtomicCounterBuffers(", "gl_MaxVertexAtomicCounters",
-    "gl_MaxVertexAttribs", "gl_MaxVertexImageUniforms", "gl_MaxVertexOutputVectors", "gl_MaxVertexTextureImageUnits",
-    "gl_MaxVertexUniformVectors", "gl_MinProgramTexelOffset", "gl_NumWorkGroups", "gl_PerVertex", "gl_PointCoord",
-    "gl_PointSize", "gl_Position", "gl_PrimitiveID", "gl_PrimitiveIDIn", "gl_SecondaryFragColorEXT",
-    "gl_SecondaryFragDataEXT", "gl_VertexID", "gl_VertexIndex", "gl_ViewID_OVR", "gl_ViewportIndex", "gl_WorkGroupID",
-    "gl_WorkGroupSize", "gl_in", "goto", "greaterThan", "greaterThanEqual", "groupMemoryBarrier", "half", "highp",
-    "hvec2", "hvec3", "hvec4", "if", "iimage1D", "iimage1DArray", "iimage2D", "iimage2DArray", "iimage3D",
-    "iimageBuffer", "iimageCube", "image1D", "image1DArray", "image1DArrayShadow", "image1DShadow", "image2D",
-    "image2DArray", "image2DArrayShadow", "image2DShadow", "image3D", "imageBuffer", "imageCube", "imageLoad",
-    "imageSize", "imageStore", "imulExtended", "in", "inline", "inout", "input", "int", "intBitsToFloat", "interface",
-    "invariant", "inverse", "inversesqrt", "isampler1D", "isampler1DArray", "isampler2D", "isampler2DArray",
-    "isampler2DMS", "isampler2DMSArray", "isampler2DRect", "isampler3D", "isamplerBuffer", "isamplerCube",
-    "isamplerCubeArray", "isinf", "isnan", "ivec2", "ivec3", "ivec4", "layout", "ldexp", "length", "lessThan",
-    "lessThanEqual", "log", "log2", "long", "lowp", "mat2", "mat2x2", "mat2x3", "mat2x4", "mat3", "mat3x2", "mat3x3",
-    "mat3x4", "mat4", "mat4x2", "mat4x3", "mat4x4", "matrixCompMult", "max", "mediump", "memoryBarrier",
-    "memoryBarrierAtomicCounter", "memoryBarrierBuffer", "memoryBarrierImage", "memoryBarrierShared", "min", "mix",
-    "mod", "modf", "namespace", "near", "noinline", "noperspective", "normalize", "not", "notEqual", "out",
-    "outerProduct", "output", "packHalf2x16", "packSnorm2x16", "packSnorm4x8", "packUnorm2x16", "packUnorm4x8",
-    "packed", "partition", "patch", "pow", "precision", "public", "radians", "reflect", "refract", "return",
-    "rgb_2_yuv", "round", "roundEven", "row_major", "sample", "sampler1D", "sampler1DArray", "sampler1DArrayShadow",
-    "sampler1DShadow", "sampler2D", "sampler2DArray", "sampler2DArrayShadow", "sampler2DMS", "sampler2DMSArray",
-    "sampler2DRect", "sampler2DRectShadow", "sampler2DShadow", "sampler3D", "sampler3DRect", "samplerBuffer",
-    "samplerCube", "samplerCubeArray", "samplerCubeArrayShadow", "samplerCubeShadow", "short", "sign", "sin", "sinh",
-    "sizeof", "smooth", "smoothstep", "sqrt", "static", "step", "struct", "subroutine", "superp", "switch", "tan",
-    "tanh", "template", "texelFetch", "texelFetchOffset", "texture", "texture2D", "texture2DGradEXT", "texture2DLod",
-    "texture2DLodEXT", "texture2DProj", "texture2DProjGradEXT", "texture2DProjLod", "texture2DProjLodEXT",
-    "texture2DRect", "texture2DRectProj", "texture3D", "texture3DLod", "texture3DProj", "texture3DProjLod",
-    "textureCube", "textureCubeGradEXT", "textureCubeLod", "textureCubeLodEXT", "textureGather", "textureGatherOffset",
-    "textureGatherOffsets", "textureGrad", "textureGradOffset", "textureLod", "textureLodOffset", "textureOffset",
-    "textureProj", "textureProjGrad", "textureProjGradOffset", "textureProjLod", "textureProjLodOffset",
-    "textureProjOffset", "textureSize", "textureVideoWEBGL", "this", "transpose", "true", "trunc", "typedef",
-    "uaddCarry", "uimage1D", "uimage1DArray", "uimage2D", "uimage2DArray", "uimage3D", "uimageBuffer", "uimageCube",
-    "uint", "uintBitsToFloat", "umulExtended", "uniform", "union", "unpackHalf2x16", "unpackSnorm2x16",
-    "unpackSnorm4x8", "unpackUnorm2x16", "unpackUnorm4x8", "unsigned", "usampler1D", "usampler1DArray", "usampler2D",
-    "usampler2DArray", "usampler2DMS", "usampler2DMSArray", "usampler2DRect", "usampler3D", "usamplerBuffer",
-    "usamplerCube", "usamplerCubeArray", "using", "usubBorrow", "uvec2", "uvec3", "uvec4", "varying", "vec2", "vec3",
-    "vec4", "void", "volatile", "while", "yuv_2_rgb"});
-
-bool spglslIsValidIdentifier(const std::string & str) {
+bool spglslIsValidIdentifier(std::string_view str) {
   // If first character is invalid
-  if (!((str[0] >= 'a' && str[0] <= 'z') || (str[0] >= 'A' && str[1] <= 'Z') || str[0] == '_')) {
+  if (!((str[0] >= 'a' && str[0] <= 'z') || (str[0] >= 'A' && str[0] <= 'Z') || str[0] == '_')) {
     return false;
   }
-  for (int i = 1; i < str.length(); i++) {
+  for (size_t i = 1; i < str.length(); i++) {
     if (!((str[i] >= 'a' && str[i] <= 'z') || (str[i] >= 'A' && str[i] <= 'Z') || (str[i] >= '0' && str[i] <= '9') ||
             str[i] == '_'))
       return false;
@@ -190,7 +157,7 @@ bool spglslIsValidIdentifier(const std::string & str) {
   return true;
 }
 
-bool spglslIsWordReserved(const std::string & word) {
+bool spglslIsWordReserved(std::string_view word) {
   if (word.length() == 0) {
     return true;
   }
@@ -200,5 +167,5 @@ bool spglslIsWordReserved(const std::string & word) {
   if (!spglslIsValidIdentifier(word)) {
     return true;
   }
-  return spglslReservedWordSet.count(word) != 0;
+  return spglslReservedWordsHas(word);
 }
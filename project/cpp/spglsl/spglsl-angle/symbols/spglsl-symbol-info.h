@@ -2,7 +2,9 @@
 #define _SPGLSL_SYMBOL_INFO_
 
 #include <emscripten/bind.h>
+#include <string_view>
 #include <unordered_map>
+#include <vector>
 
 #include <angle/src/compiler/translator/BaseTypes.h>
 #include <angle/src/compiler/translator/ImmutableString.h>
@@ -15,14 +17,16 @@
 #include "../../core/non-copyable.h"
 #include "../../core/string-utils.h"
 #include "../../spglsl-compile-options.h"
+#include "spglsl-symbol-id-map.h"
 
-bool spglslIsValidIdentifier(const std::string & str);
-bool spglslIsWordReserved(const std::string & word);
+bool spglslIsValidIdentifier(std::string_view str);
+bool spglslIsWordReserved(std::string_view word);
 
 class SpglslSymbolInfo : NonCopyable {
  public:
   const sh::TSymbol * symbol = nullptr;
-  std::string symbolName;
+  /** The name in the source, a view of a string owned by the ANGLE pool */
+  std::string_view symbolName;
   std::string renamed;
   bool mustBeRenamedUnique = false;
 
@@ -32,31 +36,50 @@ class SpglslSymbolInfo : NonCopyable {
   }
 };
 
+/** A snapshot of the renamed symbols, used to try different mangling strategies */
+class SpglslSymbolsState {
+ public:
+  uint32_t uniqueCounter = 0;
+  /** Renamed and mustBeRenamedUnique of the symbols, in the order of SpglslSymbols::entries() */
+  std::vector<std::pair<std::string, bool>> renamed;
+  std::unordered_map<const sh::TField *, std::string> renamedFields;
+};
+
 class SpglslSymbols {
  private:
   uint32_t _uniqueCounter = 0;
 
  public:
   sh::TSymbolTable * symbolTable;
-  std::unordered_map<const sh::TSymbol *, SpglslSymbolInfo> _map;
   SpglslCompileOptions & compileOptions;
 
+  /** New names of the fields of the structs, when mangleFields is enabled */
+  std::unordered_map<const sh::TField *, std::string> renamedFields;
+
   SpglslSymbols(sh::TSymbolTable * symbolTable, SpglslCompileOptions & compileOptions);
 
   SpglslSymbolInfo & get(const sh::TSymbol * symbol);
 
   bool has(const sh::TSymbol * symbol) const;
 
+  /** Gets the info of a symbol without adding it, nullptr if the symbol was never seen */
+  const SpglslSymbolInfo * find(const sh::TSymbol * symbol) const;
+
+  /** All the symbols, in the order they were first seen */
+  inline const std::vector<SpglslSymbolInfo *> & entries() const {
+    return this->_infos.values();
+  }
+
   /** Mark a variable as function parameter */
   SpglslSymbolInfo & declareParameter(const sh::TVariable * variable);
 
-  inline const std::string & getName(const sh::TSymbol * symbol, bool renamed = true) {
+  inline std::string_view getName(const sh::TSymbol * symbol, bool renamed = true) {
     auto & info = this->get(symbol);
     if (renamed && !info.renamed.empty()) {
       return info.renamed;
     }
     if (info.symbolName.empty()) {
-      return Strings::empty;
+      return std::string_view();
     }
     if (info.mustBeRenamedUnique) {
       info.mustBeRenamedUnique = false;
@@ -67,10 +90,27 @@ class SpglslSymbols {
     return info.symbolName;
   }
 
+  inline std::string_view getFieldName(const sh::TField * field) const {
+    if (!this->renamedFields.empty()) {
+      auto found = this->renamedFields.find(field);
+      if (found != this->renamedFields.end()) {
+        return found->second;
+      }
+    }
+    const sh::ImmutableString & name = field->name();
+    return std::string_view(name.data(), name.length());
+  }
+
   bool isReserved(const SpglslSymbolInfo & info) const;
 
+  SpglslSymbolsState saveState() const;
+  void restoreState(const SpglslSymbolsState & state);
+
   void renameUnique(const sh::TIntermSymbol * symbolNode);
   void renameUnique(const sh::TSymbol * symbol);
+
+ private:
+  SpglslSymbolIdMap<SpglslSymbolInfo> _infos;
 };
 
 #endif
@@ -2,15 +2,17 @@
 #include <algorithm>
 #include <cmath>
 #include <cstddef>
+#include <functional>
 #include <list>
 #include <ostream>
-#include <sstream>
 #include <string>
+#include <unordered_set>
 
-#include "../spglsl-angle-webgl-output.h"
+#include "../lib/spglsl-angle-node-utils.h"
 #include "compiler/translator/IntermNode.h"
 #include "compiler/translator/Symbol.h"
 #include "compiler/translator/Types.h"
+#include "spglsl-mangle-map.h"
 #include "spglsl-symbol-usage.h"
 #include "spglsl/core/string-utils.h"
 #include "spglsl/spglsl-angle/lib/spglsl-glsl-precisions.h"
@@ -36,6 +38,32 @@ static auto _cmp_SpglslSymbolUsageInfo(const SpglslSymbolUsageInfo * a, const Sp
   return ae->uniqueId() < be->uniqueId();
 }
 
+/** Sets a bit in a bitset of mangle ids, the bitset grows as needed */
+static void _setMangleIdBit(std::vector<uint64_t> & bits, int mangleId) {
+  size_t word = (size_t)mangleId >> 6;
+  if (word >= bits.size()) {
+    bits.resize(word + 1, 0);
+  }
+  bits[word] |= (uint64_t)1 << (mangleId & 63);
+}
+
+/** Gets the first mangle id in the range [from, to] that is not set in the bitset, 0 if there are none */
+static int _findFreeMangleId(const std::vector<uint64_t> & bits, int from, int to) {
+  for (int id = from; id <= to;) {
+    size_t word = (size_t)id >> 6;
+    if (word >= bits.size()) {
+      return id;
+    }
+    uint64_t freeBits = ~bits[word] & (~(uint64_t)0 << (id & 63));
+    if (freeBits != 0) {
+      int found = (int)(word << 6) + __builtin_ctzll(freeBits);
+      return found <= to ? found : 0;
+    }
+    id = (int)((word + 1) << 6);
+  }
+  return 0;
+}
+
 class ScopeSymbols {
  public:
   ScopeSymbols * parent;
@@ -45,6 +73,16 @@ class ScopeSymbols {
   std::unordered_set<SpglslSymbolUsageInfo *> declarations;
   std::unordered_set<SpglslSymbolUsageInfo *> usedSymbols;
 
+  /** Bitset of the mangle ids of the symbols used in this scope or in any of its children */
+  std::vector<uint64_t> usedMangleIds;
+
+  /** The declarations of this scope that have a mangle id, by mangle id. Overloads share the same id */
+  std::unordered_map<int, std::vector<SpglslSymbolUsageInfo *>> declarationsByMangleId;
+
+  /** Range of the usage positions of this scope and its children */
+  uint32_t beginPosition = 0;
+  uint32_t endPosition = 0;
+
   inline explicit ScopeSymbols(ScopeSymbols * parent = nullptr, sh::TIntermFunctionDefinition * node = nullptr) :
       parent(parent), node(node) {
   }
@@ -57,21 +95,35 @@ class ScopeSymbols {
     if (mangleId <= 0) {
       return false;
     }
-    for (const auto * used : this->usedSymbols) {
-      if (used->mangleId == mangleId) {
-        return true;
-      }
+    size_t word = (size_t)mangleId >> 6;
+    return word < this->usedMangleIds.size() && ((this->usedMangleIds[word] >> (mangleId & 63)) & 1) != 0;
+  }
+
+  /** Marks a mangle id as used in this scope and in all its parents */
+  void setMangleIdUsed(int mangleId) {
+    if (mangleId <= 0) {
+      return;
     }
-    for (const auto * child : this->children) {
-      if (child->isMangleIdUsed(mangleId)) {
-        return true;
+    size_t word = (size_t)mangleId >> 6;
+    uint64_t bit = (uint64_t)1 << (mangleId & 63);
+    for (ScopeSymbols * scope = this; scope; scope = scope->parent) {
+      auto & bits = scope->usedMangleIds;
+      if (word >= bits.size()) {
+        bits.resize(word + 1, 0);
+      } else if ((bits[word] & bit) != 0) {
+        break;  // Already set here, so it is set in all the parents too.
       }
+      bits[word] |= bit;
     }
-    return false;
   }
 
-  inline void addSymbolUsed(SpglslSymbolUsageInfo * symbol) {
-    this->usedSymbols.emplace(symbol);
+  /** Gets the first mangle id in the range [from, to] that is not used, 0 if there are none */
+  int findFreeMangleId(int from, int to) const {
+    return _findFreeMangleId(this->usedMangleIds, from, to);
+  }
+
+  inline bool addSymbolUsed(SpglslSymbolUsageInfo * symbol) {
+    return this->usedSymbols.emplace(symbol).second;
   }
 };
 
@@ -83,6 +135,21 @@ class ScopeSymbolsManager {
   ScopeSymbols * currentScope = nullptr;
   SpglslSymbolUsage & usage;
 
+  /** For each declared symbol, the scope of its declaration */
+  std::unordered_map<SpglslSymbolUsageInfo *, ScopeSymbols *> declarationScopes;
+
+  /** For each symbol, the scopes where it is used */
+  std::unordered_map<SpglslSymbolUsageInfo *, std::vector<ScopeSymbols *>> symbolScopes;
+
+  /** Incremented at each symbol use, in the same order the symbols are written in the output */
+  uint32_t position = 0;
+
+  /** For each symbol, the positions where it is used, in ascending order */
+  std::unordered_map<SpglslSymbolUsageInfo *, std::vector<uint32_t>> usePositions;
+
+  /** For each declared variable, the position where its declaration ends and it starts to be visible */
+  std::unordered_map<SpglslSymbolUsageInfo *, uint32_t> declarationEnds;
+
   explicit ScopeSymbolsManager(SpglslSymbolUsage & usage) : usage(usage), rootScope(&this->allScopes.emplace_back()) {
   }
 
@@ -97,78 +164,535 @@ class ScopeSymbolsManager {
       this->currentScope->children.push_back(&newScope);
       this->currentScope = &newScope;
     }
+    this->currentScope->beginPosition = this->position;
   }
 
   void addDeclaredSymbol(SpglslSymbolUsageInfo * symbol) {
     auto * scope = this->currentScope;
     if (scope && scope->declarations.emplace(symbol).second) {
       ++this->declarationsCount;
+      this->declarationScopes.emplace(symbol, scope);
+    }
+  }
+
+  void addSymbolUsed(SpglslSymbolUsageInfo * symbol) {
+    auto * scope = this->currentScope;
+    if (scope && scope->addSymbolUsed(symbol)) {
+      this->symbolScopes[symbol].push_back(scope);
+    }
+    this->usePositions[symbol].push_back(++this->position);
+  }
+
+  void endDeclaration(SpglslSymbolUsageInfo * symbol) {
+    this->declarationEnds[symbol] = this->position;
+  }
+
+  /** Gets the position of the last use of a symbol in the range of a scope, 0 if not used there */
+  uint32_t lastUsePosition(SpglslSymbolUsageInfo * symbol, const ScopeSymbols & scope) const {
+    auto found = this->usePositions.find(symbol);
+    if (found == this->usePositions.end()) {
+      return 0;
+    }
+    const auto & positions = found->second;
+    auto it = std::upper_bound(positions.begin(), positions.end(), scope.endPosition);
+    return it != positions.begin() && *(it - 1) > scope.beginPosition ? *(it - 1) : 0;
+  }
+
+  /** Assigns a mangle id to a symbol and marks it as used in all the scopes where the symbol is used */
+  void setMangleId(SpglslSymbolUsageInfo * symbol, int mangleId) {
+    symbol->mangleId = mangleId;
+    auto declarationScope = this->declarationScopes.find(symbol);
+    if (declarationScope != this->declarationScopes.end()) {
+      declarationScope->second->declarationsByMangleId[mangleId].push_back(symbol);
+    }
+    auto found = this->symbolScopes.find(symbol);
+    if (found != this->symbolScopes.end()) {
+      for (auto * scope : found->second) {
+        scope->setMangleIdUsed(mangleId);
+      }
     }
   }
 
   void endScope() {
     if (this->currentScope) {
+      this->currentScope->endPosition = this->position;
       this->currentScope = this->currentScope->parent;
     }
   }
 };
 
-class SpglslAngleWebglOutputCounter : public SpglslAngleWebglOutput {
+////////////////////////////////////////
+//    Class SpglslSymbolUsageCounter
+////////////////////////////////////////
+
+/**
+ * Counts the symbols usage and collects the character statistics of the shader without rendering it.
+ * Follows the same paths of SpglslAngleWebglOutput. The text that is not an identifier is only estimated:
+ * keywords, type names, qualifiers, field names and integers are counted,
+ * float fractions and layout qualifiers are not.
+ */
+class SpglslSymbolUsageCounter : public SpglslScopedTraverser {
  public:
-  SpglslSymbolGenerator * symbolGenerator;
   ScopeSymbolsManager & scopeSymbolsManager;
   SpglslSymbolUsage & usage;
+  const SpglslGlslPrecisions & precisions;
+  SpglslTextStats & stats;
+
+  std::unordered_set<const sh::TStructure *> declaredStructs;
 
-  explicit SpglslAngleWebglOutputCounter(ScopeSymbolsManager & scopeSymbolsManager,
-      std::ostream & out,
+  SpglslSymbolUsageCounter(ScopeSymbolsManager & scopeSymbolsManager,
       SpglslSymbolUsage & usage,
       const SpglslGlslPrecisions & precisions,
-      SpglslSymbolGenerator * symbolGenerator = nullptr) :
-      SpglslAngleWebglOutput(out, usage.symbols, precisions, false),
+      SpglslTextStats & stats) :
+      SpglslScopedTraverser(usage.symbols),
       scopeSymbolsManager(scopeSymbolsManager),
       usage(usage),
-      symbolGenerator(symbolGenerator) {
+      precisions(precisions),
+      stats(stats) {
+  }
+
+  void useSymbol(const sh::TSymbol * symbol) {
+    auto & symentry = this->usage.get(symbol);
+    if (symentry.isReserved) {
+      this->stats.addWord(this->symbols.getName(symbol));
+      return;
+    }
+    ++symentry.frequency;
+    this->scopeSymbolsManager.addSymbolUsed(&symentry);
+  }
+
+  void endDeclaration(const sh::TSymbol * symbol) {
+    this->scopeSymbolsManager.endDeclaration(&this->usage.get(symbol));
+  }
+
+  void countTypeName(const sh::TType & type) {
+    if (type.getBasicType() == sh::EbtStruct && type.getStruct()) {
+      this->useSymbol(type.getStruct());
+    } else if (type.getBasicType() == sh::EbtInterfaceBlock && type.getInterfaceBlock()) {
+      this->useSymbol(type.getInterfaceBlock());
+    } else {
+      this->stats.addWord(type.getBuiltInTypeNameString());
+    }
+  }
+
+  void countMemoryQualifier(const sh::TMemoryQualifier & q) {
+    this->stats.addWord(q.readonly && !q.writeonly ? "readonly" : nullptr);
+    this->stats.addWord(q.writeonly && !q.readonly ? "writeonly" : nullptr);
+    this->stats.addWord(q.coherent ? "coherent" : nullptr);
+    this->stats.addWord(q.restrictQualifier ? "restrict" : nullptr);
+    this->stats.addWord(q.volatileQualifier ? "volatile" : nullptr);
+  }
+
+  void countVariableType(const sh::TType & type, bool isFunctionArgument) {
+    if (type.isInvariant()) {
+      this->stats.addWord("invariant");
+    }
+    if (type.isPrecise()) {
+      this->stats.addWord("precise");
+    }
+    auto qualifier = type.getQualifier();
+    bool hasQualifier = qualifier != sh::EvqTemporary && qualifier != sh::EvqGlobal;
+    if (hasQualifier &&
+        (!isFunctionArgument ||
+            (qualifier != sh::TQualifier::EvqVertexIn && qualifier != sh::TQualifier::EvqFragmentIn &&
+                qualifier != sh::TQualifier::EvqParamIn))) {
+      this->stats.addWord(sh::getQualifierString(qualifier));
+    }
+    if (hasQualifier || isFunctionArgument) {
+      this->countMemoryQualifier(type.getMemoryQualifier());
+    }
+    const sh::TStructure * structure = type.getBasicType() == sh::EbtStruct ? type.getStruct() : nullptr;
+    if (structure && this->declaredStructs.count(structure) == 0) {
+      this->countStruct(*structure);
+    } else if (type.getBasicType() == sh::EbtInterfaceBlock && type.getInterfaceBlock()) {
+      this->countInterfaceBlock(*type.getInterfaceBlock());
+    } else {
+      this->stats.addWord(this->precisions.getTypePrecisionString(type));
+      this->countTypeName(type);
+    }
+  }
+
+  void countStruct(const sh::TStructure & structure) {
+    this->stats.addWord("struct");
+    this->useSymbol(&structure);
+    for (const auto * field : structure.fields()) {
+      const auto * fieldType = field->type();
+      if (fieldType) {
+        this->stats.addWord(this->precisions.getTypePrecisionString(*fieldType));
+        this->countTypeName(*fieldType);
+        this->stats.addWord(field->name());
+      }
+    }
+    // Structs with a mangled name are declared again at each use, the output does the same while counting.
+    if (this->usage.get(&structure).isReserved) {
+      this->declaredStructs.emplace(&structure);
+    }
+  }
+
+  void countInterfaceBlock(const sh::TInterfaceBlock & interfaceBlock) {
+    this->useSymbol(&interfaceBlock);
+    for (const auto * field : interfaceBlock.fields()) {
+      const auto * type = field->type();
+      if (type) {
+        if (type->isMatrix() || type->isStructureContainingMatrices()) {
+          auto matrixPacking = type->getLayoutQualifier().matrixPacking;
+          if (matrixPacking == sh::EmpColumnMajor || matrixPacking == sh::EmpRowMajor) {
+            this->stats.addWord("layout");
+            this->stats.addWord(matrixPacking == sh::EmpColumnMajor ? "column_major" : "row_major");
+          }
+        }
+        this->countMemoryQualifier(type->getMemoryQualifier());
+        this->stats.addWord(this->precisions.getTypePrecisionString(*type));
+        this->countTypeName(*type);
+        this->stats.addWord(field->name());
+      }
+    }
+  }
+
+  void countVariableDeclaration(sh::TIntermNode & child) {
+    sh::TIntermSymbol * childSym = child.getAsSymbolNode();
+    if (!childSym) {
+      this->traverseNode(&child);
+      return;
+    }
+    const sh::TVariable & variable = childSym->variable();
+    // Only the first declarator of a for loop init writes the type.
+    if (!this->_isInsideForInit || !this->_forInitTypeCounted) {
+      this->_forInitTypeCounted = this->_isInsideForInit != 0;
+      this->countVariableType(variable.getType(), false);
+    }
+    this->useSymbol(&variable);
+  }
+
+  void countConstantValue(const sh::TConstantUnion * value) {
+    switch (value->getType()) {
+      case sh::EbtInt: {
+        int32_t i = value->getIConst();
+        this->stats.addNumber(i < 0 ? -(int64_t)i : i);
+        break;
+      }
+      case sh::EbtUInt: this->stats.addNumber(value->getUConst()); break;
+      case sh::EbtBool: this->stats.addWord(value->getBConst() ? "true" : "false"); break;
+      case sh::EbtYuvCscStandardEXT:
+        this->stats.addWord(getYuvCscStandardEXTString(value->getYuvCscStandardEXTConst()));
+        break;
+      default: {
+        // Only the integer part of a float is estimated.
+        double f = std::fabs((double)value->getFConst());
+        if (f >= 1 && f < 1e9) {
+          this->stats.addNumber((uint64_t)f);
+        }
+        break;
+      }
+    }
+  }
+
+  const sh::TConstantUnion * countConstantUnion(const sh::TType * type, const sh::TConstantUnion * pConstUnion) {
+    const sh::TStructure * structure = type->getBasicType() == sh::EbtStruct ? type->getStruct() : nullptr;
+    if (structure) {
+      this->useSymbol(structure);
+      for (const auto * field : structure->fields()) {
+        pConstUnion = this->countConstantUnion(field->type(), pConstUnion);
+      }
+      return pConstUnion;
+    }
+
+    size_t size = type->getObjectSize();
+    if (size > 1) {
+      this->countTypeName(*type);
+      if (type->isVector()) {
+        bool isAllSameValue = true;
+        for (size_t i = 1; i < size; ++i) {
+          if (pConstUnion[0] != pConstUnion[i]) {
+            isAllSameValue = false;
+            break;
+          }
+        }
+        if (isAllSameValue) {
+          this->countConstantValue(pConstUnion);
+          return pConstUnion + size;
+        }
+      }
+    }
+    for (size_t i = 0; i < size; ++i, ++pConstUnion) {
+      this->countConstantValue(pConstUnion);
+    }
+    return pConstUnion;
+  }
+
+  void countOperatorNode(sh::TIntermOperator * node) {
+    sh::TIntermUnary * unaryNode = node->getAsUnaryNode();
+    if (unaryNode) {
+      switch (unaryNode->getOp()) {
+        case sh::EOpRadians: this->stats.addWord("radians"); return;
+        case sh::EOpDegrees: this->stats.addWord("degrees"); return;
+        default: break;
+      }
+      if (unaryNode->getFunction()) {
+        this->useSymbol(unaryNode->getFunction());
+        return;
+      }
+    }
+
+    sh::TIntermAggregate * aggregateNode = node->getAsAggregate();
+    if (aggregateNode) {
+      const auto op = aggregateNode->getOp();
+      if (op == sh::EOpConstruct) {
+        this->countTypeName(aggregateNode->getType());
+        return;
+      }
+      if (op == sh::EOpCallInternalRawFunction || op == sh::EOpCallFunctionInAST || sh::BuiltInGroup::IsBuiltIn(op)) {
+        if (aggregateNode->getFunction()) {
+          this->useSymbol(aggregateNode->getFunction());
+        }
+        return;
+      }
+    }
+
+    const char * opString = sh::GetOperatorString(node->getOp());
+    if (opString) {
+      this->stats.addText(opString, strlen(opString));
+    }
+  }
+
+  /** Mirrors SpglslAngleWebglOutput::traverseCodeBlock, single statements are written without a block */
+  void traverseCodeBlock(sh::TIntermBlock * body, bool allowIf) {
+    if (!nodeBlockIsEmpty(body)) {
+      sh::TIntermNode * singleNode = nodeGetBlockSingleNode(body);
+      if (singleNode && (allowIf || !singleNode->getAsIfElseNode()) && !nodeIsSomeSortOfDeclaration(singleNode)) {
+        this->traverseNode(singleNode);
+      } else {
+        this->traverseNode(body);
+      }
+    }
   }
 
   void onScopeBegin() override {
     this->scopeSymbolsManager.beginScope(this->getCurrentFunctionDefinition());
-    SpglslAngleWebglOutput::onScopeBegin();
   }
 
-  void beforeVisitFunctionPrototype(sh::TIntermFunctionPrototype * node,
-      sh::TIntermFunctionDefinition * definition) override {
-    SpglslAngleWebglOutput::beforeVisitFunctionPrototype(node, definition);
+  void onScopeEnd() override {
+    this->scopeSymbolsManager.endScope();
   }
 
   void onSymbolDeclaration(const sh::TSymbol * symbol,
       sh::TIntermNode * node,
       SpglslSymbolDeclarationKind kind) override {
     this->scopeSymbolsManager.addDeclaredSymbol(&this->usage.get(symbol));
-    SpglslAngleWebglOutput::onSymbolDeclaration(symbol, node, kind);
   }
 
-  std::string getBuiltinTypeName(const sh::TType * type) override {
-    auto result = SpglslAngleWebglOutput::getBuiltinTypeName(type);
-    if (this->symbolGenerator != nullptr) {
-      this->symbolGenerator->addReservedWord(result);
+  void beforeVisitFunctionPrototype(sh::TIntermFunctionPrototype * node,
+      sh::TIntermFunctionDefinition * definition) override {
+    this->countVariableType(node->getType(), false);
+    this->useSymbol(node->getFunction());
+  }
+
+  void afterVisitFunctionPrototype(sh::TIntermFunctionPrototype * node,
+      sh::TIntermFunctionDefinition * definition) override {
+    const auto * fun = node->getFunction();
+    for (size_t i = 0, paramCount = fun->getParamCount(); i < paramCount; ++i) {
+      const sh::TVariable * param = fun->getParam(i);
+      this->countVariableType(param->getType(), true);
+      if (definition) {
+        this->useSymbol(param);
+        this->endDeclaration(param);
+      }
     }
-    return result;
   }
 
-  const std::string & getSymbolName(const sh::TSymbol * symbol) override {
-    auto & symentry = this->usage.get(symbol);
-    if (symentry.isReserved) {
-      return SpglslAngleWebglOutput::getSymbolName(symbol);  // Reserved.
+  void onVisitForLoop(sh::TIntermLoop * node, bool infinite) override {
+    this->stats.addWord("for");
+    ++this->_isInsideForInit;
+    this->_forInitTypeCounted = false;
+    this->traverseNode(node->getInit());
+    --this->_isInsideForInit;
+    if (!infinite) {
+      this->traverseNode(node->getCondition());
     }
-    ++symentry.frequency;
-    this->scopeSymbolsManager.currentScope->addSymbolUsed(&symentry);
-    return Strings::empty;
+    if (nodeHasSideEffects(node->getExpression())) {
+      this->traverseNode(node->getExpression());
+    }
+    this->traverseCodeBlock(node->getBody(), true);
   }
 
-  void onScopeEnd() override {
-    SpglslAngleWebglOutput::onScopeEnd();
-    this->scopeSymbolsManager.endScope();
+  void onVisitWhileLoop(sh::TIntermLoop * node) override {
+    this->stats.addWord("while");
+    this->traverseNode(node->getCondition());
+    this->traverseCodeBlock(node->getBody(), true);
   }
+
+  void onVisitDoWhileLoop(sh::TIntermLoop * node) override {
+    this->stats.addWord("do");
+    this->traverseCodeBlock(node->getBody(), true);
+    this->stats.addWord("while");
+    this->traverseNode(node->getCondition());
+  }
+
+  bool visitVariableDeclaration(sh::TIntermNode * node, sh::TIntermDeclaration * declarationNode) override {
+    this->countVariableDeclaration(*node);
+    if (node->getAsSymbolNode()) {
+      this->endDeclaration(&node->getAsSymbolNode()->variable());
+    }
+    return false;
+  }
+
+  void visitSymbol(sh::TIntermSymbol * node) override {
+    this->useSymbol(&node->variable());
+  }
+
+  void visitConstantUnion(sh::TIntermConstantUnion * node) override {
+    this->countConstantUnion(&node->getType(), node->getConstantValue());
+  }
+
+  void visitPreprocessorDirective(sh::TIntermPreprocessorDirective * node) override {
+    switch (node->getDirective()) {
+      case sh::PreprocessorDirective::Define: this->stats.addWord("define"); break;
+      case sh::PreprocessorDirective::Endif: this->stats.addWord("endif"); break;
+      case sh::PreprocessorDirective::If: this->stats.addWord("if"); break;
+      case sh::PreprocessorDirective::Ifdef: this->stats.addWord("ifdef"); break;
+      default: return;
+    }
+    const auto & command = node->getCommand();
+    this->stats.addText(command.data(), command.length());
+  }
+
+  bool visitSwizzle(sh::Visit visit, sh::TIntermSwizzle * node) override {
+    if (visit == sh::PostVisit) {
+      static const char swizzleChars[] = "xyzw";
+      char swizzle[4];
+      size_t length = 0;
+      bool isNoop = true;
+      const auto & offsets = node->getSwizzleOffsets();
+      for (size_t i = 0; i != offsets.size() && length < sizeof(swizzle); ++i) {
+        int offset = offsets[i];
+        if (offset != (int)i) {
+          isNoop = false;
+        }
+        if (offset >= 0 && offset < 4) {
+          swizzle[length++] = swizzleChars[offset];
+        }
+      }
+      sh::TIntermTyped * operand = node->getOperand();
+      if (isNoop && operand && (operand->getType().isVector() || operand->getType().isScalar()) &&
+          operand->getNominalSize() == offsets.size()) {
+        return true;  // The swizzle is removed by the output.
+      }
+      this->stats.addWord(swizzle, length);
+    }
+    return true;
+  }
+
+  bool visitBinary(sh::Visit visit, sh::TIntermBinary * node) override {
+    switch (node->getOp()) {
+      case sh::EOpIndexDirectStruct:
+      case sh::EOpIndexDirectInterfaceBlock: {
+        const sh::TType * leftType = node->getLeft() ? &node->getLeft()->getType() : nullptr;
+        const sh::TFieldListCollection * fields = nullptr;
+        if (leftType) {
+          fields = node->getOp() == sh::EOpIndexDirectStruct
+              ? static_cast<const sh::TFieldListCollection *>(leftType->getStruct())
+              : static_cast<const sh::TFieldListCollection *>(leftType->getInterfaceBlock());
+        }
+        if (!fields) {
+          return true;
+        }
+        sh::TIntermSymbol * symLeft = nodeGetAsSymbolNode(node->getLeft());
+        if (node->getOp() == sh::EOpIndexDirectInterfaceBlock && symLeft) {
+          // Fields of a nameless interface block are global, the block variable is counted once.
+          this->useSymbol(&symLeft->variable());
+        } else {
+          this->traverseNode(node->getLeft());
+        }
+        sh::TIntermConstantUnion * indexNode = nodeGetAsConstantUnion(node->getRight());
+        const int fieldIndex = indexNode ? indexNode->getIConst(0) : -1;
+        if (fieldIndex >= 0 && fieldIndex < fields->fields().size()) {
+          this->stats.addWord(fields->fields().at(fieldIndex)->name());
+        } else {
+          this->traverseNode(node->getRight());
+        }
+        return false;
+      }
+
+      case sh::EOpInitialize: {
+        this->countVariableDeclaration(*node->getLeft());
+        this->traverseNode(node->getRight());
+        // The initializer still sees the outer symbols, the declared variable is visible only after it.
+        sh::TIntermSymbol * symLeft = nodeGetAsSymbolNode(node->getLeft());
+        if (symLeft) {
+          this->endDeclaration(&symLeft->variable());
+        }
+        return false;
+      }
+
+      default: return true;
+    }
+  }
+
+  bool visitUnary(sh::Visit visit, sh::TIntermUnary * node) override {
+    if (visit == sh::PreVisit) {
+      this->countOperatorNode(node);
+    }
+    return true;
+  }
+
+  bool visitAggregate(sh::Visit visit, sh::TIntermAggregate * node) override {
+    if (visit == sh::PreVisit) {
+      this->countOperatorNode(node);
+    }
+    return true;
+  }
+
+  bool visitIfElse(sh::Visit visit, sh::TIntermIfElse * node) override {
+    this->stats.addWord("if");
+    this->traverseNode(node->getCondition());
+    this->traverseCodeBlock(node->getTrueBlock(), false);
+    if (!nodeBlockIsEmpty(node->getFalseBlock())) {
+      this->stats.addWord("else");
+      this->traverseCodeBlock(node->getFalseBlock(), true);
+    }
+    return false;
+  }
+
+  bool visitSwitch(sh::Visit visit, sh::TIntermSwitch * node) override {
+    if (visit == sh::PreVisit) {
+      this->stats.addWord("switch");
+    }
+    return true;
+  }
+
+  bool visitCase(sh::Visit visit, sh::TIntermCase * node) override {
+    if (visit == sh::PreVisit) {
+      if (!node->getCondition()) {
+        this->stats.addWord("default");
+        return false;
+      }
+      this->stats.addWord("case");
+    }
+    return true;
+  }
+
+  bool visitBranch(sh::Visit visit, sh::TIntermBranch * node) override {
+    if (visit == sh::PreVisit) {
+      switch (node->getFlowOp()) {
+        case sh::EOpKill: this->stats.addWord("discard"); break;
+        case sh::EOpBreak: this->stats.addWord("break"); break;
+        case sh::EOpContinue: this->stats.addWord("continue"); break;
+        case sh::EOpReturn: this->stats.addWord("return"); break;
+        default: break;
+      }
+    }
+    return true;
+  }
+
+  bool visitGlobalQualifierDeclaration(sh::Visit visit, sh::TIntermGlobalQualifierDeclaration * node) override {
+    this->stats.addWord(node->isPrecise() ? "precise" : "invariant");
+    this->useSymbol(&node->getSymbol()->variable());
+    return false;
+  }
+
+ private:
+  int _isInsideForInit = 0;
+  bool _forInitTypeCounted = false;
 };
 
 ////////////////////////////////////////
@@ -248,25 +772,148 @@ void mangleScopeDeclarations(ScopeSymbolsManager & scopeSymbolsManager, ScopeSym
     if (declInfo->mangleId != 0 || declInfo->frequency == 0) {
       continue;  // Already renamed.
     }
-    bool renamed = false;
-    for (; lastMangleId <= scopeSymbolsManager.declarationsCount; ++lastMangleId) {
-      if (!scope.isMangleIdUsed(lastMangleId)) {
-        auto newMangleId = lastMangleId++;
-        declInfo->mangleId = newMangleId;
-        renamed = true;
-
-        auto declOverloads = overloads.find(declInfo);
-        if (declOverloads != overloads.end()) {
-          for (auto * overload : declOverloads->second) {
-            overload->mangleId = newMangleId;
+    int newMangleId = scope.findFreeMangleId(lastMangleId, scopeSymbolsManager.declarationsCount);
+    if (newMangleId <= 0) {
+      break;  // No more available ids.
+    }
+    lastMangleId = newMangleId + 1;
+    scopeSymbolsManager.setMangleId(declInfo, newMangleId);
+
+    auto declOverloads = overloads.find(declInfo);
+    if (declOverloads != overloads.end()) {
+      for (auto * overload : declOverloads->second) {
+        scopeSymbolsManager.setMangleId(overload, newMangleId);
+      }
+    }
+  }
+}
+
+/**
+ * Assigns the mangle ids of the declarations of a local scope using the live ranges of the outer symbols.
+ * A declaration can reuse the id of an outer symbol if all the uses of the outer symbol in the scope come
+ * before the end of the declaration, the declared variable then shadows the outer symbol in the rest of the scope.
+ * Declarations are colored greedily, most frequent first, with the smallest id that does not interfere.
+ */
+void mangleScopeDeclarationsLiveRanges(ScopeSymbolsManager & scopeSymbolsManager, ScopeSymbols & scope) {
+  std::vector<SpglslSymbolUsageInfo *> sortedDeclarations(scope.declarations.begin(), scope.declarations.end());
+  std::sort(sortedDeclarations.begin(), sortedDeclarations.end(), _cmp_SpglslSymbolUsageInfo);
+
+  // The scopes are mangled from the root, the ids used in this scope and in its children belong to outer
+  // declarations. For each of them, the position of the last use in this scope, the latest first.
+  std::vector<std::pair<uint32_t, int>> lastUseOfIds;
+  const auto & usedBits = scope.usedMangleIds;
+  for (size_t word = 0; word < usedBits.size(); ++word) {
+    for (uint64_t bits = usedBits[word]; bits != 0; bits &= bits - 1) {
+      int id = (int)(word << 6) + __builtin_ctzll(bits);
+      uint32_t lastUse = 0;
+      for (const ScopeSymbols * outer = scope.parent; outer; outer = outer->parent) {
+        auto declarations = outer->declarationsByMangleId.find(id);
+        if (declarations != outer->declarationsByMangleId.end()) {
+          for (auto * declaration : declarations->second) {
+            lastUse = std::max(lastUse, scopeSymbolsManager.lastUsePosition(declaration, scope));
           }
         }
+      }
+      if (lastUse != 0) {
+        lastUseOfIds.emplace_back(lastUse, id);
+      }
+    }
+  }
+  std::sort(lastUseOfIds.begin(), lastUseOfIds.end(), std::greater<std::pair<uint32_t, int>>());
+
+  // Two declarations in the same scope cannot have the same name.
+  std::vector<uint64_t> declaredIds;
+  std::vector<uint64_t> unavailableIds;
+  for (auto * declInfo : sortedDeclarations) {
+    if (declInfo->mangleId != 0 || declInfo->frequency == 0) {
+      continue;  // Already renamed.
+    }
+    auto declarationEnd = scopeSymbolsManager.declarationEnds.find(declInfo);
+    uint32_t visibleFrom =
+        declarationEnd != scopeSymbolsManager.declarationEnds.end() ? declarationEnd->second : scope.beginPosition;
+
+    // The ids of the outer symbols still used after the declaration is visible would be shadowed.
+    unavailableIds = declaredIds;
+    for (const auto & lastUse : lastUseOfIds) {
+      if (lastUse.first <= visibleFrom) {
         break;
       }
+      _setMangleIdBit(unavailableIds, lastUse.second);
     }
-    if (!renamed) {
-      break;  // No more avaialble ids.
+
+    int newMangleId = _findFreeMangleId(unavailableIds, 1, scopeSymbolsManager.declarationsCount);
+    if (newMangleId <= 0) {
+      break;  // No more available ids.
     }
+    _setMangleIdBit(declaredIds, newMangleId);
+    scopeSymbolsManager.setMangleId(declInfo, newMangleId);
+  }
+}
+
+/**
+ * Assigns to the declarations of a scope the names found in the mangle map of a previous compilation.
+ * A name is not imported if it would conflict with another declaration of the scope or hide an outer symbol
+ * used in the scope, the declaration then gets a new name from the generator.
+ * Scopes must be imported from the root to the leaves.
+ */
+void importScopeDeclarations(ScopeSymbols & scope,
+    const SpglslMangleMap & mangleMap,
+    const emscripten::val & importMap,
+    const SpglslSymbolGenerator & generator,
+    const std::unordered_set<std::string_view> & reservedNames) {
+  std::vector<SpglslSymbolUsageInfo *> sortedDeclarations(scope.declarations.begin(), scope.declarations.end());
+  std::sort(sortedDeclarations.begin(), sortedDeclarations.end(), _cmp_SpglslSymbolUsageInfo);
+
+  // Imported names of the outer symbols used in this scope or in its children.
+  std::unordered_set<std::string> outerNames;
+  std::vector<ScopeSymbols *> stack{&scope};
+  while (!stack.empty()) {
+    ScopeSymbols * current = stack.back();
+    stack.pop_back();
+    for (auto * used : current->usedSymbols) {
+      if (!used->importedName.empty() && scope.declarations.count(used) == 0) {
+        outerNames.emplace(used->importedName);
+      }
+    }
+    stack.insert(stack.end(), current->children.begin(), current->children.end());
+  }
+
+  // For each name imported in this scope, the overload keys of the functions, empty for the variables.
+  std::unordered_map<std::string, std::vector<std::string>> declaredNames;
+  for (auto * declInfo : sortedDeclarations) {
+    if (declInfo->mangleId != 0 || declInfo->frequency == 0 || declInfo->isReserved || !declInfo->entry) {
+      continue;
+    }
+    const std::string * key = mangleMap.getKey(declInfo->entry->symbol);
+    if (!key) {
+      continue;
+    }
+    auto found = importMap[*key];
+    if (!found.isString()) {
+      continue;
+    }
+    std::string name = found.as<std::string>();
+    // Names with two consecutive underscores are reserved in GLSL, the generator does not check them.
+    if (generator.isReservedWord(name) || name.find("__") != std::string::npos || name.size() > 256 ||
+        reservedNames.count(name) != 0 || outerNames.count(name) != 0) {
+      continue;
+    }
+
+    const auto * symbol = declInfo->entry->symbol;
+    std::string overloadKey =
+        symbol->isFunction() ? "(" + _functionOverloadKey(static_cast<const sh::TFunction *>(symbol)) : "";
+    auto & overloads = declaredNames[name];
+    bool conflicts = !overloads.empty() && overloadKey.empty();
+    for (const auto & other : overloads) {
+      conflicts = conflicts || other.empty() || other == overloadKey;
+    }
+    if (conflicts) {
+      continue;
+    }
+
+    overloads.push_back(overloadKey);
+    declInfo->importedName = std::move(name);
+    declInfo->mangleId = -1;
   }
 }
 
@@ -279,23 +926,24 @@ SpglslSymbolUsage::SpglslSymbolUsage(SpglslSymbols & symbols) : symbols(symbols)
 
 void SpglslSymbolUsage::load(sh::TIntermBlock * root,
     const SpglslGlslPrecisions & precisions,
-    SpglslSymbolGenerator * generator) {
+    SpglslSymbolGenerator * generator,
+    const SpglslMangleMap * mangleMap) {
   ScopeSymbolsManager scopeSymbolsManager(*this);
 
   {
-    std::stringstream ss;
-    SpglslAngleWebglOutputCounter counter(scopeSymbolsManager, ss, *this, precisions);
+    SpglslTextStats stats;
+    SpglslSymbolUsageCounter counter(scopeSymbolsManager, *this, precisions, stats);
     root->traverse(&counter);
     if (generator) {
-      generator->load(ss.str());
+      generator->load(stats);
     }
   }
 
   std::vector<SpglslSymbolUsageInfo *> tmpSorted;
   tmpSorted.reserve(this->map.size());
-  for (auto & kv : this->map) {
-    if (!kv.second.isReserved) {
-      tmpSorted.push_back(&kv.second);
+  for (auto * info : this->map.values()) {
+    if (!info->isReserved) {
+      tmpSorted.push_back(info);
     }
   }
 
@@ -310,19 +958,77 @@ void SpglslSymbolUsage::load(sh::TIntermBlock * root,
   }
 
   if (generator) {
+    const emscripten::val & importMap = this->symbols.compileOptions.mangle_map;
+    if (mangleMap && !importMap.isUndefined() && !importMap.isNull()) {
+      std::unordered_set<std::string_view> reservedNames;
+      for (const auto * info : this->map.values()) {
+        if (info->isReserved && info->entry) {
+          reservedNames.emplace(info->entry->symbolName);
+        }
+      }
+      for (auto & scope : scopeSymbolsManager.allScopes) {
+        importScopeDeclarations(scope, *mangleMap, importMap, *generator, reservedNames);
+      }
+      for (const auto * entry : this->sorted) {
+        if (!entry->importedName.empty()) {
+          generator->addReservedWord(entry->importedName);
+        }
+      }
+    }
+
+    bool liveRanges = this->symbols.compileOptions.mangleLiveRanges;
     for (auto & scope : scopeSymbolsManager.allScopes) {
-      mangleScopeDeclarations(scopeSymbolsManager, scope);
+      if (liveRanges && &scope != scopeSymbolsManager.rootScope) {
+        mangleScopeDeclarationsLiveRanges(scopeSymbolsManager, scope);
+      } else {
+        mangleScopeDeclarations(scopeSymbolsManager, scope);
+      }
     }
 
-    for (const auto & kv : this->symbols._map) {
-      auto & entry = this->get(kv.first);
+    for (const auto * info : this->symbols.entries()) {
+      auto & entry = this->get(info->symbol);
       if (entry.isReserved || entry.mangleId <= 0) {
-        generator->addReservedWord(kv.second.symbolName);
+        generator->addReservedWord(info->symbolName);
       }
     }
   }
 }
 
+////////////////////////////////////////
+//    Class SpglslTextStats
+////////////////////////////////////////
+
+SpglslTextStats::SpglslTextStats() : chars(), bigrams(128 * 128, 0) {
+}
+
+void SpglslTextStats::addWord(const char * word, size_t length) {
+  unsigned char prevChar = 0;
+  for (size_t i = 0; i < length; ++i) {
+    const unsigned char c = (unsigned char)word[i];
+    if (c >= 128) {
+      prevChar = 0;
+      continue;
+    }
+    ++this->chars[c];
+    if (isalpha(prevChar) && isalnum(c)) {
+      ++this->bigrams[prevChar * 128 + c];
+    }
+    prevChar = c;
+  }
+}
+
+void SpglslTextStats::addText(const char * text, size_t length) {
+  // Bigrams only pair alphanumeric characters, so a separator already splits the tokens.
+  this->addWord(text, length);
+}
+
+void SpglslTextStats::addNumber(uint64_t value) {
+  do {
+    ++this->chars['0' + (value % 10)];
+    value /= 10;
+  } while (value != 0);
+}
+
 ////////////////////////////////////////
 //    Class SpglslSymbolGenerator
 ////////////////////////////////////////
@@ -337,32 +1043,26 @@ inline bool charLess(char a, char b) {
 }
 
 SpglslSymbolGenerator::SpglslSymbolGenerator(SpglslSymbolUsage & usage) : usage(usage) {
-  this->_additionalReservedWords.emplace(Strings::empty);
+  this->_additionalReservedWords.add(Strings::empty);
 }
 
-bool SpglslSymbolGenerator::isReservedWord(const std::string & word) const {
-  if (this->_additionalReservedWords.count(word) > 0) {
-    return true;
-  }
-  if (spglslIsWordReserved(word)) {
-    return true;
-  }
-  return false;
+bool SpglslSymbolGenerator::isReservedWord(std::string_view word) const {
+  return this->_additionalReservedWords.has(word) || spglslIsWordReserved(word);
 }
 
-void SpglslSymbolGenerator::addReservedWord(const std::string & word) {
-  this->_additionalReservedWords.emplace(word);
+void SpglslSymbolGenerator::addReservedWord(std::string_view word) {
+  this->_additionalReservedWords.add(word);
 }
 
-void SpglslSymbolGenerator::load(const std::string & text) {
-  std::unordered_map<char, uint32_t> asciiAndNums;
-  std::unordered_map<char, uint32_t> ascii;
-  std::unordered_map<std::string, uint32_t> words;
+void SpglslSymbolGenerator::load(const SpglslTextStats & stats) {
+  std::vector<std::pair<char, uint32_t>> asciiSorted;
+  std::vector<std::pair<char, uint32_t>> asciiAndNumsSorted;
+  std::vector<std::pair<std::string, uint32_t>> wordsSorted;
 
   if (!usage.symbols.compileOptions.mangle_global_map.isUndefined()) {
-    for (const auto & kv : usage.symbols._map) {
-      if (!kv.second.symbolName.empty()) {
-        auto found = usage.symbols.compileOptions.mangle_global_map[kv.second.symbolName];
+    for (const auto * info : usage.symbols.entries()) {
+      if (!info->symbolName.empty()) {
+        auto found = usage.symbols.compileOptions.mangle_global_map[std::string(info->symbolName)];
         if (found.isString()) {
           this->addReservedWord(found.as<std::string>());
         }
@@ -370,54 +1070,30 @@ void SpglslSymbolGenerator::load(const std::string & text) {
     }
   }
 
-  std::string one;
-  one.resize(1);
-
-  std::string two;
-  two.resize(2);
-
-  for (char c = 'a'; c <= 'z'; ++c) {
-    ascii[c] = 1;
-    asciiAndNums[c] = 1;
-
-    one[0] = c;
-    words[one]++;
-  }
-  for (char c = 'A'; c <= 'Z'; ++c) {
-    ascii[c] = 1;
-    asciiAndNums[c] = 1;
-
-    one[0] = c;
-    words[one]++;
-  }
-  for (char c = '0'; c <= '9'; ++c) {
-    asciiAndNums[c] = 1;
+  // Every letter and digit starts from 1 so all of them are available to the generator.
+  for (int c = 0; c < 128; ++c) {
+    if (isalnum(c)) {
+      asciiAndNumsSorted.emplace_back((char)c, stats.chars[c] + 1);
+      if (isalpha(c)) {
+        asciiSorted.emplace_back((char)c, stats.chars[c] + 1);
+        wordsSorted.emplace_back(std::string(1, (char)c), stats.chars[c] + 1);
+      }
+    }
   }
-  char prevChar = 0;
-
-  for (size_t i = 0; i != text.size(); ++i) {
-    const char c = text[i];
-    if (isalpha(c)) {
-      ++ascii[c];
-      ++asciiAndNums[c];
 
-      one[0] = c;
-      words[one]++;
-
-    } else if (isalnum(c)) {
-      ++asciiAndNums[c];
+  for (int a = 0; a < 128; ++a) {
+    if (!isalpha(a)) {
+      continue;
     }
-
-    if (isalpha(prevChar) && isalnum(c)) {
-      two[0] = prevChar;
-      two[1] = c;
-      words[two]++;
+    for (int b = 0; b < 128; ++b) {
+      uint32_t count = stats.bigrams[a * 128 + b];
+      if (count != 0) {
+        const char two[2] = {(char)a, (char)b};
+        wordsSorted.emplace_back(std::string(two, 2), count);
+      }
     }
-
-    prevChar = c;
   }
 
-  std::vector<std::pair<char, uint32_t>> asciiSorted(ascii.begin(), ascii.end());
   std::sort(asciiSorted.begin(), asciiSorted.end(), [](const auto & a, const auto & b) {
     return a.second > b.second || (a.second == b.second && charLess(a.first, b.first));
   });
@@ -427,7 +1103,6 @@ void SpglslSymbolGenerator::load(const std::string & text) {
     this->chars[i] = asciiSorted[i].first;
   }
 
-  std::vector<std::pair<char, uint32_t>> asciiAndNumsSorted(asciiAndNums.begin(), asciiAndNums.end());
   std::sort(asciiAndNumsSorted.begin(), asciiAndNumsSorted.end(), [](const auto & a, const auto & b) {
     return a.second > b.second || (a.second == b.second && charLess(a.first, b.first));
   });
@@ -437,7 +1112,6 @@ void SpglslSymbolGenerator::load(const std::string & text) {
     this->charsAndNumbers[i] = asciiAndNumsSorted[i].first;
   }
 
-  std::vector<std::pair<std::string, uint32_t>> wordsSorted(words.begin(), words.end());
   std::sort(wordsSorted.begin(), wordsSorted.end(), [](const auto & a, const auto & b) {
     if (a.first.size() != b.first.size()) {
       return a.first.size() < b.first.size();
@@ -454,39 +1128,78 @@ void SpglslSymbolGenerator::load(const std::string & text) {
   this->words.clear();
   this->words.reserve(wordsSorted.size());
   for (const auto & kv : wordsSorted) {
+    if (!this->useTextWords && kv.first.size() > 1) {
+      break;
+    }
     if (!this->isReservedWord(kv.first)) {
       this->words.push_back(kv.first);
     }
   }
+
+  this->_wordsSet.clear();
+  for (const auto & word : this->words) {
+    this->_wordsSet.add(word);
+  }
 }
 
-const std::string & SpglslSymbolGenerator::getOrCreateMangledName(int mangleId) {
-  auto & result = this->_mangleMap[mangleId];
+/**
+ * Writes the name with the given index, the first character is taken from chars,
+ * the following ones from charsAndNumbers, as a bijective base-N number so every index has a different name.
+ */
+static void _writeGeneratedName(std::string & output,
+    uint64_t index,
+    const std::string & chars,
+    const std::string & charsAndNumbers) {
+  const uint64_t charsCount = chars.size();
+  const uint64_t charsAndNumbersCount = charsAndNumbers.size();
+  output.clear();
+  output.push_back(chars[index % charsCount]);
+  index /= charsCount;
+  while (index > 0) {
+    --index;
+    output.push_back(charsAndNumbers[index % charsAndNumbersCount]);
+    index /= charsAndNumbersCount;
+  }
+}
 
-  if (result.empty()) {
-    for (;;) {
-      if (this->_usedWords < this->words.size()) {
-        result = this->words[this->_usedWords++];
-      } else {
-        auto index = _genCounter++;
-        std::ostringstream ss;
-        ss.put(this->chars[index % this->chars.size()]);
-        index = floor((double)index / (double)this->chars.size());
-        while (index > 0) {
-          index -= 1;
-          ss.put(this->charsAndNumbers[index % this->charsAndNumbers.size()]);
-          index = floor((double)index / (double)this->charsAndNumbers.size());
-        }
-        result = ss.str();
-      }
-      if (this->isReservedWord(result)) {
-        continue;
-      }
-      if (this->_usedNames.emplace(result).second) {
-        break;
-      }
-    };
+void SpglslSymbolGenerator::generateNames(size_t count) {
+  if (this->_names.size() >= count) {
+    return;
   }
+  this->_names.reserve(count);
 
-  return result;
+  while (this->_names.size() < count && this->_usedWords < this->words.size()) {
+    const std::string & word = this->words[this->_usedWords++];
+    if (!this->isReservedWord(word)) {
+      this->_names.push_back(word);
+    }
+  }
+
+  std::string name;
+  while (this->_names.size() < count) {
+    _writeGeneratedName(name, this->_genCounter++, this->chars, this->charsAndNumbers);
+    if (name.size() <= 2 && this->_wordsSet.has(name)) {
+      continue;  // Words have one or two characters, longer names cannot collide with them.
+    }
+    if (!this->isReservedWord(name)) {
+      this->_names.push_back(name);
+    }
+  }
+}
+
+const std::string & SpglslSymbolGenerator::getOrCreateMangledName(int mangleId) {
+  if (mangleId <= 0) {
+    return Strings::empty;
+  }
+  if ((size_t)mangleId >= this->_mangleIdNames.size()) {
+    this->_mangleIdNames.resize((size_t)mangleId + 1, 0);
+  }
+  auto & nameIndex = this->_mangleIdNames[mangleId];
+  if (nameIndex == 0) {
+    if (this->_assignedNames >= this->_names.size()) {
+      this->generateNames(this->_names.size() * 2 + 16);
+    }
+    nameIndex = (uint32_t)++this->_assignedNames;
+  }
+  return this->_names[nameIndex - 1];
 }
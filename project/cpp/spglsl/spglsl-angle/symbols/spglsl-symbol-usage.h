@@ -1,6 +1,11 @@
 #ifndef _SPGLSL_SYMBOL_USAGE_
 #define _SPGLSL_SYMBOL_USAGE_
 
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+#include "../../core/string-set.h"
 #include "../lib/spglsl-glsl-precisions.h"
 #include "spglsl-symbol-info.h"
 
@@ -10,6 +15,9 @@ struct SpglslSymbolUsageInfo {
   bool isReserved = false;
   uint32_t frequency = 0;
 
+  /** The name imported from the mangle map of a previous compilation, mangleId is -1 when set */
+  std::string importedName;
+
   inline int uniqueId() const {
     const auto * entry = this->entry;
     return entry ? entry->uniqueId() : 0;
@@ -17,21 +25,65 @@ struct SpglslSymbolUsageInfo {
 };
 
 class SpglslSymbolGenerator;
+class SpglslMangleMap;
+
+/**
+ * Character statistics of the text of a shader, used to pick the characters of the generated names.
+ * Filled token by token by the usage counter, without rendering the shader.
+ */
+class SpglslTextStats {
+ public:
+  /** Occurrences of each ascii character */
+  uint32_t chars[128];
+
+  /** Occurrences of each alphabetic character followed by an alphanumeric character, indexed by first * 128 + second */
+  std::vector<uint32_t> bigrams;
+
+  SpglslTextStats();
+
+  /** Adds a single token, bigrams do not cross the token boundaries */
+  void addWord(const char * word, size_t length);
+
+  /** Adds a text, tokens are separated by non alphanumeric characters */
+  void addText(const char * text, size_t length);
+
+  void addNumber(uint64_t value);
+
+  inline void addWord(const char * word) {
+    if (word) {
+      this->addWord(word, strlen(word));
+    }
+  }
+
+  inline void addWord(const std::string & word) {
+    this->addWord(word.data(), word.size());
+  }
+
+  inline void addWord(std::string_view word) {
+    this->addWord(word.data(), word.size());
+  }
+
+  inline void addWord(const sh::ImmutableString & word) {
+    this->addWord(word.data(), word.length());
+  }
+};
 
 class SpglslSymbolUsage {
  public:
   SpglslSymbols & symbols;
-  std::unordered_map<const sh::TSymbol *, SpglslSymbolUsageInfo> map;
+  SpglslSymbolIdMap<SpglslSymbolUsageInfo> map;
   std::vector<SpglslSymbolUsageInfo *> sorted;
 
   explicit SpglslSymbolUsage(SpglslSymbols & symbols);
 
   void load(sh::TIntermBlock * root,
       const SpglslGlslPrecisions & precisions,
-      SpglslSymbolGenerator * generator = nullptr);
+      SpglslSymbolGenerator * generator = nullptr,
+      const SpglslMangleMap * mangleMap = nullptr);
 
   inline SpglslSymbolUsageInfo & get(const sh::TSymbol * symbol) {
-    auto & found = this->map[symbol];
+    bool added;
+    auto & found = this->map.get(symbol, added);
     if (!found.entry) {
       auto & info = this->symbols.get(symbol);
       found.entry = &info;
@@ -49,21 +101,37 @@ class SpglslSymbolGenerator {
   std::string charsAndNumbers;
   std::vector<std::string> words;
 
-  bool isReservedWord(const std::string & word) const;
-  void addReservedWord(const std::string & word);
+  /** If false, names are generated only from the most frequent characters, ignoring the words found in the text */
+  bool useTextWords = true;
+
+  bool isReservedWord(std::string_view word) const;
+  void addReservedWord(std::string_view word);
 
   explicit SpglslSymbolGenerator(SpglslSymbolUsage & usage);
 
-  void load(const std::string & text);
+  void load(const SpglslTextStats & stats);
+
+  /** Generates the names in one pass until there are at least count names available */
+  void generateNames(size_t count);
 
+  /** The returned reference is valid until the next call, names are generated on demand when they run out */
   const std::string & getOrCreateMangledName(int mangleId);
 
  private:
   size_t _usedWords = 0;
-  size_t _genCounter = 0;
-  std::unordered_map<int, std::string> _mangleMap;
-  std::unordered_set<std::string> _usedNames;
-  std::unordered_set<std::string> _additionalReservedWords;
+  uint64_t _genCounter = 0;
+  size_t _assignedNames = 0;
+
+  /** The generated names, in the order they are assigned to the mangle ids */
+  std::vector<std::string> _names;
+
+  /** For each mangle id, the index of its name in _names plus one, 0 if the mangle id has no name yet */
+  std::vector<uint32_t> _mangleIdNames;
+
+  /** The words of the text, the generated names of the same length must not collide with them */
+  SpglslStringSet _wordsSet;
+
+  SpglslStringSet _additionalReservedWords;
 };
 
 #endif
@@ -0,0 +1,57 @@
+#include "spglsl-analysis-traverser.h"
+
+void SpglslAnalysis::onDeclaration(sh::TIntermDeclaration * node) {
+}
+
+void SpglslAnalysis::onGlobalQualifierDeclaration(sh::TIntermGlobalQualifierDeclaration * node) {
+}
+
+void SpglslAnalysis::onFunctionDefinition(sh::TIntermFunctionDefinition * node) {
+}
+
+void SpglslAnalysis::onAggregate(sh::TIntermAggregate * node) {
+}
+
+SpglslAnalysisTraverser::SpglslAnalysisTraverser() : sh::TIntermTraverser(true, false, false, nullptr) {
+}
+
+void SpglslAnalysisTraverser::subscribe(SpglslAnalysis * analysis) {
+  if (analysis) {
+    this->_analyses.push_back(analysis);
+  }
+}
+
+void SpglslAnalysisTraverser::traverseNode(sh::TIntermNode * node) {
+  if (node && !this->_analyses.empty()) {
+    node->traverse(this);
+  }
+}
+
+bool SpglslAnalysisTraverser::visitDeclaration(sh::Visit visit, sh::TIntermDeclaration * node) {
+  for (SpglslAnalysis * analysis : this->_analyses) {
+    analysis->onDeclaration(node);
+  }
+  return true;
+}
+
+bool SpglslAnalysisTraverser::visitGlobalQualifierDeclaration(sh::Visit visit,
+    sh::TIntermGlobalQualifierDeclaration * node) {
+  for (SpglslAnalysis * analysis : this->_analyses) {
+    analysis->onGlobalQualifierDeclaration(node);
+  }
+  return true;
+}
+
+bool SpglslAnalysisTraverser::visitFunctionDefinition(sh::Visit visit, sh::TIntermFunctionDefinition * node) {
+  for (SpglslAnalysis * analysis : this->_analyses) {
+    analysis->onFunctionDefinition(node);
+  }
+  return true;
+}
+
+bool SpglslAnalysisTraverser::visitAggregate(sh::Visit visit, sh::TIntermAggregate * node) {
+  for (SpglslAnalysis * analysis : this->_analyses) {
+    analysis->onAggregate(node);
+  }
+  return true;
+}
@@ -0,0 +1,42 @@
+#ifndef _SPGLSL_ANALYSIS_TRAVERSER_H_
+#define _SPGLSL_ANALYSIS_TRAVERSER_H_
+
+#include <angle/src/compiler/translator/tree_util/IntermTraverse.h>
+#include <vector>
+
+#include "../../core/non-copyable.h"
+
+/**
+ * An analysis that reads the AST without modifying it.
+ * Many analyses can subscribe to the same SpglslAnalysisTraverser, to be computed in a single walk of the AST.
+ */
+class SpglslAnalysis {
+ public:
+  virtual ~SpglslAnalysis() = default;
+
+  virtual void onDeclaration(sh::TIntermDeclaration * node);
+  virtual void onGlobalQualifierDeclaration(sh::TIntermGlobalQualifierDeclaration * node);
+  virtual void onFunctionDefinition(sh::TIntermFunctionDefinition * node);
+  virtual void onAggregate(sh::TIntermAggregate * node);
+};
+
+/** Walks the whole AST once, the subscribed analyses receive each node in subscription order */
+class SpglslAnalysisTraverser : protected sh::TIntermTraverser, NonCopyable {
+ public:
+  SpglslAnalysisTraverser();
+
+  void subscribe(SpglslAnalysis * analysis);
+
+  void traverseNode(sh::TIntermNode * node);
+
+ protected:
+  bool visitDeclaration(sh::Visit visit, sh::TIntermDeclaration * node) override;
+  bool visitGlobalQualifierDeclaration(sh::Visit visit, sh::TIntermGlobalQualifierDeclaration * node) override;
+  bool visitFunctionDefinition(sh::Visit visit, sh::TIntermFunctionDefinition * node) override;
+  bool visitAggregate(sh::Visit visit, sh::TIntermAggregate * node) override;
+
+ private:
+  std::vector<SpglslAnalysis *> _analyses;
+};
+
+#endif
@@ -2,7 +2,7 @@
 
 #include <angle/src/compiler/translator/Symbol.h>
 
-SpglslGetPrecisionsTraverser::SpglslGetPrecisionsTraverser() : sh::TIntermTraverser(true, false, false, nullptr) {
+SpglslGetPrecisionsTraverser::SpglslGetPrecisionsTraverser() {
   this->reset();
 }
 
@@ -20,9 +20,9 @@ void SpglslGetPrecisionsTraverser::reset() {
 }
 
 void SpglslGetPrecisionsTraverser::traverseNode(sh::TIntermNode * node) {
-  if (node) {
-    node->traverse(this);
-  }
+  SpglslAnalysisTraverser traverser;
+  traverser.subscribe(this);
+  traverser.traverseNode(node);
 }
 
 void SpglslGetPrecisionsTraverser::add(sh::TBasicType basicType, sh::TPrecision precision) {
@@ -82,7 +82,7 @@ void SpglslGetPrecisionsTraverser::add(const sh::TVariable * variable) {
   }
 }
 
-bool SpglslGetPrecisionsTraverser::visitDeclaration(sh::Visit visit, sh::TIntermDeclaration * node) {
+void SpglslGetPrecisionsTraverser::onDeclaration(sh::TIntermDeclaration * node) {
   size_t childCount = node->getChildCount();
   for (size_t i = 0; i < childCount; ++i) {
     auto * child = node->getChildNode(i);
@@ -102,19 +102,16 @@ bool SpglslGetPrecisionsTraverser::visitDeclaration(sh::Visit visit, sh::TInterm
       }
     }
   }
-  return true;
 }
 
-bool SpglslGetPrecisionsTraverser::visitGlobalQualifierDeclaration(sh::Visit visit,
-    sh::TIntermGlobalQualifierDeclaration * node) {
+void SpglslGetPrecisionsTraverser::onGlobalQualifierDeclaration(sh::TIntermGlobalQualifierDeclaration * node) {
   sh::TIntermSymbol * symbolNode = node->getSymbol();
   if (symbolNode) {
     this->add(symbolNode->getType());
   }
-  return true;
 }
 
-bool SpglslGetPrecisionsTraverser::visitFunctionDefinition(sh::Visit visit, sh::TIntermFunctionDefinition * node) {
+void SpglslGetPrecisionsTraverser::onFunctionDefinition(sh::TIntermFunctionDefinition * node) {
   sh::TIntermFunctionPrototype * proto = node->getFunctionPrototype();
   if (proto) {
     const sh::TFunction * func = proto->getFunction();
@@ -125,14 +122,12 @@ bool SpglslGetPrecisionsTraverser::visitFunctionDefinition(sh::Visit visit, sh::
       }
     }
   }
-  return true;
 }
 
-bool SpglslGetPrecisionsTraverser::visitAggregate(sh::Visit visit, sh::TIntermAggregate * node) {
+void SpglslGetPrecisionsTraverser::onAggregate(sh::TIntermAggregate * node) {
   if (node->getOp() == sh::EOpConstruct) {
     this->add(node->getType());
   }
-  return true;
 }
 
 void SpglslGetPrecisionsTraverser::count() {
@@ -6,10 +6,12 @@
 #include <unordered_set>
 
 #include "../../core/non-copyable.h"
+#include "spglsl-analysis-traverser.h"
 
 class SpglslAngleCompiler;
 
-class SpglslGetPrecisionsTraverser : protected sh::TIntermTraverser, NonCopyable {
+/** Counts the precisions of the declared types, to find the default precisions that make the output shorter */
+class SpglslGetPrecisionsTraverser : public SpglslAnalysis, NonCopyable {
  public:
   sh::TPrecision floatPrecision;
   sh::TPrecision intPrecision;
@@ -26,11 +28,10 @@ class SpglslGetPrecisionsTraverser : protected sh::TIntermTraverser, NonCopyable
 
   void count();
 
- protected:
-  bool visitDeclaration(sh::Visit visit, sh::TIntermDeclaration * node) override;
-  bool visitGlobalQualifierDeclaration(sh::Visit visit, sh::TIntermGlobalQualifierDeclaration * node) override;
-  bool visitFunctionDefinition(sh::Visit visit, sh::TIntermFunctionDefinition * node) override;
-  bool visitAggregate(sh::Visit visit, sh::TIntermAggregate * node) override;
+  void onDeclaration(sh::TIntermDeclaration * node) override;
+  void onGlobalQualifierDeclaration(sh::TIntermGlobalQualifierDeclaration * node) override;
+  void onFunctionDefinition(sh::TIntermFunctionDefinition * node) override;
+  void onAggregate(sh::TIntermAggregate * node) override;
 
  private:
   std::unordered_set<const sh::TStructure *> _declaredStructs;
@@ -10,7 +10,7 @@
 #include <angle/src/compiler/translator/tree_ops/SplitSequenceOperator.h>
 #include <angle/src/compiler/translator/tree_util/IntermNodePatternMatcher.h>
 
-#include "../lib/spglsl-angle-ast-hasher.h"
+#include "../lib/spglsl-angle-ast-hash-cache.h"
 #include "../lib/spglsl-angle-node-utils.h"
 #include "../spglsl-angle-compiler.h"
 #include "../spglsl-angle-webgl-output.h"
@@ -220,8 +220,8 @@ class XRebuilder : public sh::TIntermRebuild {
 };
 
 bool spglsl_treeops_optimize(SpglslAngleCompiler & compiler, sh::TIntermBlock * root) {
-  SpglslHashValue oldAstHash;
-  AngleAstHasher astHasher(&compiler.symbolTable);
+  AngleAstHashCache::HashValue oldAstHash = 0;
+  AngleAstHashCache astHashCache(&compiler.symbolTable);
   int repeat = -1;
 
   do {
@@ -249,14 +249,14 @@ bool spglsl_treeops_optimize(SpglslAngleCompiler & compiler, sh::TIntermBlock *
     compiler.callDag.tagUsedFunctions();
     compiler.callDag.pruneUnusedFunctions(root);
 
-    spglsl_treeops_OptimizeBlocks(compiler, root);
+    spglsl_treeops_OptimizeBlocks(compiler, root, astHashCache);
 
     XRebuilder rebuilder(compiler);
     if (!rebuilder.rebuildRoot(*root)) {
       return false;
     }
 
-  } while (repeat < 50 && astHasher.computeNodeHashChanged(root, oldAstHash));
+  } while (repeat < 50 && astHashCache.computeNodeHashChanged(root, oldAstHash));
 
   return true;
 }
@@ -4,6 +4,7 @@
 #include "spglsl-get-precisions-traverser.h"
 
 class SpglslAngleCompiler;
+class AngleAstHashCache;
 
 namespace sh {
   class TIntermBlock;
@@ -13,7 +14,15 @@ namespace sh {
 bool spglsl_treeops_optimize(SpglslAngleCompiler & compiler, sh::TIntermBlock * root);
 
 /** Removes unnecessary or empty blocks, replace comma operators with statements */
-void spglsl_treeops_OptimizeBlocks(SpglslAngleCompiler & compiler, sh::TIntermNode * root);
+void spglsl_treeops_OptimizeBlocks(SpglslAngleCompiler & compiler,
+    sh::TIntermNode * root,
+    AngleAstHashCache & hashCache);
+
+/** Merges local variables of the same type declared in the same block when their lifetimes do not overlap */
+bool spglsl_treeops_coalesceLocals(SpglslAngleCompiler & compiler, sh::TIntermBlock * root);
+
+/** Declares the float constants repeated many times as shared global consts, when it makes the output shorter */
+bool spglsl_treeops_hoistLiterals(SpglslAngleCompiler & compiler, sh::TIntermBlock * root);
 
 /** Minification - replace statements with comma operator where possible */
 void spglsl_treeops_minify(SpglslAngleCompiler & compiler, sh::TIntermNode * root);
@@ -0,0 +1,172 @@
+#include <unordered_map>
+#include <unordered_set>
+
+#include "../lib/spglsl-angle-node-utils.h"
+#include "../spglsl-angle-compiler.h"
+#include "tree-ops.h"
+
+/** Gets the variable declared by a declaration that declares a single variable */
+static const sh::TVariable * _getSingleDeclaredVariable(sh::TIntermNode * node, sh::TIntermTyped ** initializer) {
+  auto * declaration = node ? node->getAsDeclarationNode() : nullptr;
+  if (!declaration || declaration->getSequence()->size() != 1) {
+    return nullptr;
+  }
+  sh::TIntermNode * child = declaration->getSequence()->front();
+  auto * symbol = child->getAsSymbolNode();
+  if (symbol) {
+    *initializer = nullptr;
+    return &symbol->variable();
+  }
+  auto * binary = nodeGetAsBinaryNode(child, sh::EOpInitialize);
+  symbol = binary ? nodeGetAsSymbolNode(binary->getLeft()) : nullptr;
+  if (symbol) {
+    *initializer = binary->getRight();
+    return &symbol->variable();
+  }
+  return nullptr;
+}
+
+/** Only plain non constant locals that can be assigned as a whole can be merged */
+static bool _canBeCoalesced(const sh::TVariable & variable) {
+  const sh::TType & type = variable.getType();
+  return type.getQualifier() == sh::EvqTemporary && !type.isArray() && !type.isStructureContainingArrays() &&
+      !IsOpaqueType(type.getBasicType()) && type.getBasicType() != sh::EbtVoid;
+}
+
+static bool _sameTypes(const sh::TType & a, const sh::TType & b) {
+  return a == b && a.getPrecision() == b.getPrecision() && a.getQualifier() == b.getQualifier();
+}
+
+/** Collects, for each statement of a block, the variables it references and the names declared inside it */
+class SpglslCoalesceLocalsUsesTraverser : public sh::TIntermTraverser {
+ public:
+  std::unordered_map<const sh::TVariable *, size_t> lastUses;
+  std::unordered_set<std::string> nestedDeclaredNames;
+  size_t statementIndex = 0;
+
+  SpglslCoalesceLocalsUsesTraverser() : sh::TIntermTraverser(true, false, false) {
+  }
+
+  void visitSymbol(sh::TIntermSymbol * node) override {
+    this->lastUses[&node->variable()] = this->statementIndex;
+  }
+
+  bool visitDeclaration(sh::Visit visit, sh::TIntermDeclaration * node) override {
+    if (this->getCurrentTraversalDepth() > 0) {
+      for (sh::TIntermNode * child : *node->getSequence()) {
+        auto * binary = nodeGetAsBinaryNode(child, sh::EOpInitialize);
+        auto * symbol = nodeGetAsSymbolNode(binary ? binary->getLeft() : child);
+        if (symbol) {
+          this->nestedDeclaredNames.emplace(symbol->variable().name().data());
+          const sh::TStructure * structure = symbol->getType().getStruct();
+          if (structure) {
+            this->nestedDeclaredNames.emplace(structure->name().data());
+          }
+        }
+      }
+    }
+    return true;
+  }
+};
+
+/** Replaces the references to the merged variables */
+class SpglslCoalesceLocalsReplaceTraverser : public sh::TIntermTraverser {
+ public:
+  const std::unordered_map<const sh::TVariable *, const sh::TVariable *> & replacements;
+
+  explicit SpglslCoalesceLocalsReplaceTraverser(
+      const std::unordered_map<const sh::TVariable *, const sh::TVariable *> & replacements) :
+      sh::TIntermTraverser(true, false, false), replacements(replacements) {
+  }
+
+  void visitSymbol(sh::TIntermSymbol * node) override {
+    auto found = this->replacements.find(&node->variable());
+    if (found != this->replacements.end()) {
+      this->queueReplacement(new sh::TIntermSymbol(found->second), OriginalNode::IS_DROPPED);
+    }
+  }
+};
+
+/** Collects all the blocks where local variables can be declared in sequence */
+class SpglslCoalesceLocalsBlocksTraverser : public sh::TIntermTraverser {
+ public:
+  std::vector<sh::TIntermBlock *> blocks;
+
+  SpglslCoalesceLocalsBlocksTraverser() : sh::TIntermTraverser(true, false, false) {
+  }
+
+  bool visitBlock(sh::Visit visit, sh::TIntermBlock * node) override {
+    // Case labels jump over declarations, the order of the statements in a switch is not the execution order.
+    sh::TIntermNode * parent = this->getParentNode();
+    if (parent && !parent->getAsSwitchNode()) {
+      this->blocks.push_back(node);
+    }
+    return true;
+  }
+};
+
+/**
+ * Merges the locals declared in a block into an earlier local of the same type that is not used anymore.
+ * The declaration of the merged variable becomes an assignment to the earlier one.
+ * Both variables are declared in the same block, so their values cannot be carried across loop iterations,
+ * and function parameters, out parameters included, are never merged.
+ */
+static void _coalesceBlockLocals(sh::TIntermBlock * block,
+    std::unordered_map<const sh::TVariable *, const sh::TVariable *> & replacements) {
+  sh::TIntermSequence & sequence = *block->getSequence();
+
+  SpglslCoalesceLocalsUsesTraverser uses;
+  for (size_t i = 0; i < sequence.size(); ++i) {
+    uses.statementIndex = i;
+    sequence[i]->traverse(&uses);
+  }
+
+  // Variables declared in this block that were not merged, they may be reused once their last use is passed.
+  std::vector<const sh::TVariable *> candidates;
+  for (size_t i = 0; i < sequence.size(); ++i) {
+    sh::TIntermTyped * initializer = nullptr;
+    const sh::TVariable * variable = _getSingleDeclaredVariable(sequence[i], &initializer);
+    if (!variable || !_canBeCoalesced(*variable)) {
+      continue;
+    }
+
+    const sh::TVariable * target = nullptr;
+    if (initializer) {
+      for (const sh::TVariable * candidate : candidates) {
+        // The candidate can still be read by the initializer, it is evaluated before the assignment.
+        if (uses.lastUses[candidate] <= i && _sameTypes(candidate->getType(), variable->getType()) &&
+            uses.nestedDeclaredNames.count(candidate->name().data()) == 0) {
+          target = candidate;
+          break;
+        }
+      }
+    }
+
+    if (!target) {
+      candidates.push_back(variable);
+      continue;
+    }
+
+    sequence[i] = new sh::TIntermBinary(sh::EOpAssign, new sh::TIntermSymbol(target), initializer);
+    replacements.emplace(variable, target);
+    uses.lastUses[target] = uses.lastUses[variable];
+  }
+}
+
+bool spglsl_treeops_coalesceLocals(SpglslAngleCompiler & compiler, sh::TIntermBlock * root) {
+  SpglslCoalesceLocalsBlocksTraverser blocksTraverser;
+  root->traverse(&blocksTraverser);
+
+  std::unordered_map<const sh::TVariable *, const sh::TVariable *> replacements;
+  for (sh::TIntermBlock * block : blocksTraverser.blocks) {
+    _coalesceBlockLocals(block, replacements);
+  }
+
+  if (replacements.empty()) {
+    return true;
+  }
+
+  SpglslCoalesceLocalsReplaceTraverser replaceTraverser(replacements);
+  root->traverse(&replaceTraverser);
+  return replaceTraverser.updateTree(&compiler.tCompiler, root);
+}
@@ -0,0 +1,203 @@
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <angle/src/compiler/translator/Common.h>
+
+#include "../../core/math-utils.h"
+#include "../lib/spglsl-angle-node-utils.h"
+#include "../spglsl-angle-compiler.h"
+#include "tree-ops.h"
+
+/** Length assumed for the mangled name of a hoisted constant, the most used symbols get one or two characters */
+static constexpr size_t HOISTED_NAME_LENGTH = 2;
+
+/** The occurrences of the same constant value, used at the same precision */
+struct SpglslHoistedLiteral {
+  sh::TIntermConstantUnion * first = nullptr;
+  sh::TPrecision precision = sh::EbpUndefined;
+  std::vector<sh::TIntermConstantUnion *> nodes;
+};
+
+/** Only float scalars, vectors and matrices, integers are used where constant expressions are required */
+static bool _canBeHoisted(const sh::TType & type) {
+  return type.getBasicType() == sh::EbtFloat && !type.isArray() && type.getStruct() == nullptr;
+}
+
+static int _literalMantissaBits(const SpglslAngleCompiler & compiler, sh::TPrecision precision) {
+  if (compiler.compilerOptions.lowPrecisionLiterals) {
+    switch (precision) {
+      case sh::EbpMedium: return FLOAT_MANTISSA_BITS_MEDIUMP;
+      case sh::EbpLow: return FLOAT_MANTISSA_BITS_LOWP;
+      default: break;
+    }
+  }
+  return FLOAT_MANTISSA_BITS_HIGHP;
+}
+
+/** Number of characters the output writes for a float constant, the same rules of SpglslAngleWebglOutput */
+static size_t _literalLength(const sh::TType & type, const sh::TConstantUnion * values, int mantissaBits) {
+  const size_t size = type.getObjectSize();
+  if (size == 1) {
+    return floatToGlsl(values->getFConst(), false, true, nullptr, mantissaBits).length();
+  }
+
+  bool isSingleValue = true;
+  if (type.isVector()) {
+    for (size_t i = 1; i < size && isSingleValue; ++i) {
+      isSingleValue = values[0] == values[i];
+    }
+  } else if (type.isMatrix() && type.getNominalSize() == type.getSecondarySize()) {
+    for (int i = 0, msize = type.getNominalSize(); i < msize && isSingleValue; i++) {
+      for (int j = 0; j < msize; j++) {
+        const sh::TConstantUnion & cell = values[i * msize + j];
+        if ((i == j && cell != *values) || (i != j && !cell.isZero())) {
+          isSingleValue = false;
+          break;
+        }
+      }
+    }
+  } else {
+    isSingleValue = false;
+  }
+
+  // Type name and parentheses, "vec3(" and ")"
+  size_t result = strlen(type.getBuiltInTypeNameString()) + 2;
+  for (size_t i = 0, count = isSingleValue ? 1 : size; i < count; ++i) {
+    result += floatToGlsl(values[i].getFConst(), false, false, nullptr, mantissaBits).length() + (i != 0 ? 1 : 0);
+  }
+  return result;
+}
+
+/** Groups the float constants by type, precision of the expression that uses them and value */
+class SpglslHoistLiteralsCollectTraverser : public sh::TIntermTraverser {
+ public:
+  std::vector<SpglslHoistedLiteral *> literals;
+  std::unordered_map<std::string, SpglslHoistedLiteral> literalsByKey;
+
+  SpglslHoistLiteralsCollectTraverser() : sh::TIntermTraverser(true, false, false) {
+  }
+
+  void visitConstantUnion(sh::TIntermConstantUnion * node) override {
+    const sh::TType & type = node->getType();
+    if (!_canBeHoisted(type)) {
+      return;
+    }
+
+    // Without a precision the constant cannot be declared in a fragment shader without a default float precision.
+    sh::TPrecision precision = nodeGetConsumingPrecision(this->getParentNode(), node);
+    if (precision == sh::EbpUndefined) {
+      return;
+    }
+
+    const size_t size = type.getObjectSize();
+    std::string key;
+    key.reserve(3 + size * sizeof(float));
+    key.push_back((char)type.getNominalSize());
+    key.push_back((char)type.getSecondarySize());
+    key.push_back((char)precision);
+    const sh::TConstantUnion * values = node->getConstantValue();
+    for (size_t i = 0; i < size; ++i) {
+      float value = values[i].getFConst();
+      char bytes[sizeof(float)];
+      memcpy(bytes, &value, sizeof(float));
+      key.append(bytes, sizeof(float));
+    }
+
+    SpglslHoistedLiteral & literal = this->literalsByKey[key];
+    if (!literal.first) {
+      literal.first = node;
+      literal.precision = precision;
+      this->literals.push_back(&literal);
+    }
+    literal.nodes.push_back(node);
+  }
+};
+
+/** Replaces the hoisted constants with their variable */
+class SpglslHoistLiteralsReplaceTraverser : public sh::TIntermTraverser {
+ public:
+  const std::unordered_map<const sh::TIntermConstantUnion *, const sh::TVariable *> & replacements;
+
+  explicit SpglslHoistLiteralsReplaceTraverser(
+      const std::unordered_map<const sh::TIntermConstantUnion *, const sh::TVariable *> & replacements) :
+      sh::TIntermTraverser(true, false, false), replacements(replacements) {
+  }
+
+  void visitConstantUnion(sh::TIntermConstantUnion * node) override {
+    auto found = this->replacements.find(node);
+    if (found != this->replacements.end()) {
+      this->queueReplacement(new sh::TIntermSymbol(found->second), OriginalNode::IS_DROPPED);
+    }
+  }
+};
+
+/**
+ * Declares a constant repeated many times as a global const, when the declaration is shorter than the repetitions.
+ * Constant constructors like vec3(.2126,.7152,.0722) are already folded to a single constant union by ANGLE.
+ */
+bool spglsl_treeops_hoistLiterals(SpglslAngleCompiler & compiler, sh::TIntermBlock * root) {
+  SpglslHoistLiteralsCollectTraverser collect;
+  root->traverse(&collect);
+
+  std::unordered_map<const sh::TIntermConstantUnion *, const sh::TVariable *> replacements;
+  sh::TIntermSequence declarations;
+
+  for (SpglslHoistedLiteral * literal : collect.literals) {
+    const size_t count = literal->nodes.size();
+    if (count < 2) {
+      continue;
+    }
+
+    sh::TType * type = new sh::TType(literal->first->getType());
+    type->setQualifier(sh::EvqConst);
+    type->setPrecision(literal->precision);
+
+    const size_t literalLength = _literalLength(
+        *type, literal->first->getConstantValue(), _literalMantissaBits(compiler, literal->precision));
+
+    // "const mediump vec3 " + name + "=" + literal + ";"
+    const char * precisionString = compiler.precisions.getTypePrecisionString(*type);
+    const size_t declarationLength = strlen("const ") + (precisionString ? strlen(precisionString) + 1 : 0) +
+        strlen(type->getBuiltInTypeNameString()) + 1 + HOISTED_NAME_LENGTH + 1 + literalLength + 1;
+
+    if (count * literalLength <= count * HOISTED_NAME_LENGTH + declarationLength) {
+      continue;
+    }
+
+    // A distinct name for each one, global names are the keys of the mangle map.
+    const std::string name = "spglsl_literal" + std::to_string(declarations.size());
+    const sh::TVariable * variable = new sh::TVariable(&compiler.symbolTable,
+        sh::ImmutableString(sh::AllocatePoolCharArray(name.c_str(), name.length()), name.length()), type,
+        sh::SymbolType::AngleInternal);
+
+    sh::TIntermDeclaration * declaration = new sh::TIntermDeclaration();
+    declaration->appendDeclarator(
+        new sh::TIntermBinary(sh::EOpInitialize, new sh::TIntermSymbol(variable), literal->first->deepCopy()));
+    declarations.push_back(declaration);
+
+    for (sh::TIntermConstantUnion * node : literal->nodes) {
+      replacements.emplace(node, variable);
+    }
+  }
+
+  if (replacements.empty()) {
+    return true;
+  }
+
+  SpglslHoistLiteralsReplaceTraverser replaceTraverser(replacements);
+  root->traverse(&replaceTraverser);
+  if (!replaceTraverser.updateTree(&compiler.tCompiler, root)) {
+    return false;
+  }
+
+  // After the directives, #extension must come before any declaration.
+  sh::TIntermSequence & sequence = *root->getSequence();
+  size_t position = 0;
+  while (position < sequence.size() && sequence[position]->getAsPreprocessorDirective()) {
+    ++position;
+  }
+  sequence.insert(sequence.begin() + position, declarations.begin(), declarations.end());
+  return true;
+}
@@ -1,4 +1,4 @@
-#include "../lib/spglsl-angle-ast-hasher.h"
+#include "../lib/spglsl-angle-ast-hash-cache.h"
 #include "../lib/spglsl-angle-node-utils.h"
 #include "../spglsl-angle-compiler.h"
 #include "tree-ops.h"
@@ -33,10 +33,10 @@ sh::TIntermTyped * _asCommaOpArg(sh::TIntermNode * node) {
 class SpglslPutCommaOperatorTraverser : public sh::TIntermTraverser {
  public:
   bool hasChanges = false;
-  AngleAstHasher & astHasher;
+  AngleAstHashCache & astHashCache;
 
-  explicit SpglslPutCommaOperatorTraverser(AngleAstHasher & hasher) :
-      sh::TIntermTraverser(false, false, true), astHasher(hasher) {
+  explicit SpglslPutCommaOperatorTraverser(AngleAstHashCache & hashCache) :
+      sh::TIntermTraverser(false, false, true), astHashCache(hashCache) {
   }
 
   bool visitBlock(sh::Visit visit, sh::TIntermBlock * block) override {
@@ -102,7 +102,7 @@ class SpglslPutCommaOperatorTraverser : public sh::TIntermTraverser {
           }
 
           if (a0Assignment && a1Assignment && a0Assignment->getOp() == a1Assignment->getOp() &&
-              this->astHasher.nodesAreTheSame(a0Assignment->getLeft(), a1Assignment->getLeft())) {
+              this->astHashCache.nodesAreTheSame(a0Assignment->getLeft(), a1Assignment->getLeft())) {
             // optimizes ternary assignments with or without commas
 
             sh::TIntermTyped * a0new;
@@ -141,7 +141,7 @@ class SpglslPutCommaOperatorTraverser : public sh::TIntermTraverser {
             if (flushedCommasAsComma) {
               auto * asBin = flushedCommasAsComma->getLeft()->getAsBinaryNode();
               if (asBin && sh::IsAssignment(asBin->getOp())) {
-                if (this->astHasher.nodesAreTheSame(asBin->getLeft(), branchNode->getExpression())) {
+                if (this->astHashCache.nodesAreTheSame(asBin->getLeft(), branchNode->getExpression())) {
                   // return xxx,yyy,a+=n,a => return xxx,yyy,a+=n
                   node = new sh::TIntermBranch(sh::EOpReturn, flushedCommas);
                   nodeMade = true;
@@ -193,6 +193,7 @@ class SpglslPutCommaOperatorTraverser : public sh::TIntermTraverser {
 
     if (changed) {
       block->replaceAllChildren(std::move(newSequence));
+      this->astHashCache.invalidate(block);
       this->hasChanges = true;
     }
 
@@ -221,8 +222,9 @@ class SpglslPutCommaOperatorTraverser : public sh::TIntermTraverser {
 };
 
 void spglsl_treeops_minify(SpglslAngleCompiler & compiler, sh::TIntermNode * root) {
-  AngleAstHasher hasher;
-  for (SpglslPutCommaOperatorTraverser traverser(hasher);;) {
+  AngleAstHashCache hashCache(&compiler.symbolTable);
+  for (SpglslPutCommaOperatorTraverser traverser(hashCache);;) {
+    hashCache.validate(root);
     root->traverse(&traverser);
     if (!traverser.hasChanges) {
       break;
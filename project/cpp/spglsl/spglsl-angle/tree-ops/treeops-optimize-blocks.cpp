@@ -1,4 +1,4 @@
-#include "../lib/spglsl-angle-ast-hasher.h"
+#include "../lib/spglsl-angle-ast-hash-cache.h"
 #include "../lib/spglsl-angle-node-utils.h"
 #include "../spglsl-angle-compiler.h"
 #include "tree-ops.h"
@@ -7,15 +7,15 @@ typedef std::vector<sh::TIntermNode> OptimizeBlockNodeResult;
 
 class SpglslOptimizeBlocksTraverser : public sh::TIntermTraverser {
  public:
-  AngleAstHasher & astHasher;
+  AngleAstHashCache & astHashCache;
   SpglslSymbols & symbols;
 
   explicit SpglslOptimizeBlocksTraverser(SpglslSymbols & symbols,
-      AngleAstHasher & astHasher,
+      AngleAstHashCache & astHashCache,
       sh::TDiagnostics * diagnostics) :
       sh::TIntermTraverser(true, false, false, symbols.symbolTable),
       symbols(symbols),
-      astHasher(astHasher),
+      astHashCache(astHashCache),
       _diagnostics(diagnostics) {
   }
 
@@ -63,6 +63,7 @@ class SpglslOptimizeBlocksTraverser : public sh::TIntermTraverser {
     }
     if (changed) {
       block->replaceAllChildren(std::move(newSequence));
+      this->astHashCache.invalidate(block);
       this->hasChanges = true;
     }
     return true;
@@ -104,7 +105,7 @@ class SpglslOptimizeBlocksTraverser : public sh::TIntermTraverser {
         auto * trueBin = trueBlock->getChildNode(0)->getAsBinaryNode();
         auto * falseBin = falseBlock->getChildNode(0)->getAsBinaryNode();
         if (trueBin && falseBin && trueBin->getOp() == falseBin->getOp() && sh::IsAssignment(trueBin->getOp()) &&
-            this->astHasher.nodesAreTheSame(trueBin->getLeft(), falseBin->getLeft())) {
+            this->astHashCache.nodesAreTheSame(trueBin->getLeft(), falseBin->getLeft())) {
           // Replace "if (condition) {x=t} else {x=f}" to "x=condition?t:f";
           return new sh::TIntermBinary(trueBin->getOp(), trueBin->getLeft(),
               new sh::TIntermTernary(condition, trueBin->getRight(), falseBin->getRight()));
@@ -163,6 +164,7 @@ class SpglslOptimizeBlocksTraverser : public sh::TIntermTraverser {
                 // float x=0.; => float x;
                 if (nodeIsConstantZero(declInitialize->getRight())) {
                   (*forInitDecl->getSequence())[i] = declInitialize->getLeft();
+                  this->astHashCache.invalidate(forInitDecl);
                   this->hasChanges = true;
                 }
               }
@@ -259,10 +261,12 @@ class SpglslOptimizeBlocksTraverser : public sh::TIntermTraverser {
   }
 };
 
-void spglsl_treeops_OptimizeBlocks(SpglslAngleCompiler & compiler, sh::TIntermNode * root) {
-  AngleAstHasher hasher;
-  SpglslOptimizeBlocksTraverser traverser(compiler.symbols, hasher, &compiler.diagnostics);
+void spglsl_treeops_OptimizeBlocks(SpglslAngleCompiler & compiler,
+    sh::TIntermNode * root,
+    AngleAstHashCache & hashCache) {
+  SpglslOptimizeBlocksTraverser traverser(compiler.symbols, hashCache, &compiler.diagnostics);
   for (;;) {
+    hashCache.validate(root);
     root->traverse(&traverser);
     if (!traverser.hasChanges) {
       break;
@@ -10,7 +10,18 @@ SpglslCompileOptions::SpglslCompileOptions() :
     recordConstantPrecision(false),
     minify(false),
     mangle(false),
-    beautify(false) {
+    beautify(false),
+    optimizeGzip(false),
+    mangleLiveRanges(false),
+    coalesceLocals(false),
+    mangleFields(false),
+    lowPrecisionLiterals(false),
+    hoistLiterals(false),
+    defineMacros(false),
+    sourceMap(false),
+    reportRepeatedSubtrees(false),
+    outputThreads(0),
+    parallelOutputMinSourceLength(1024 * 1024) {
   sh::InitBuiltInResources(&this->angle);
 }
 
@@ -31,8 +42,28 @@ void SpglslCompileOptions::loadFromVal(emscripten::val input, emscripten::val re
   this->mangle = this->compileMode >= SpglslCompileMode::Optimize && input["mangle"].as<bool>();
 
   this->mangle_global_map = input["mangle_global_map"];
+  this->mangle_map = input["mangle_map"];
   this->beautify = this->compileMode >= SpglslCompileMode::Optimize && input["beautify"].as<bool>();
   this->recordConstantPrecision = input["recordConstantPrecision"].as<bool>();
+  this->optimizeGzip = this->compileMode >= SpglslCompileMode::Optimize && input["optimizeGzip"].as<bool>();
+  this->mangleLiveRanges = this->mangle && input["mangleLiveRanges"].as<bool>();
+  this->coalesceLocals = this->compileMode >= SpglslCompileMode::Optimize && input["coalesceLocals"].as<bool>();
+  this->mangleFields = this->mangle && input["mangleFields"].as<bool>();
+  this->lowPrecisionLiterals =
+      this->compileMode >= SpglslCompileMode::Optimize && input["lowPrecisionLiterals"].as<bool>();
+  this->hoistLiterals = this->mangle && input["hoistLiterals"].as<bool>();
+  this->sourceMap = this->compileMode >= SpglslCompileMode::Compile && input["sourceMap"].as<bool>();
+  // The aliases would move the mapped columns.
+  this->defineMacros = this->minify && !this->sourceMap && input["defineMacros"].as<bool>();
+  this->reportRepeatedSubtrees =
+      this->compileMode >= SpglslCompileMode::Compile && input["reportRepeatedSubtrees"].as<bool>();
+
+  if (input["outputThreads"].isNumber()) {
+    this->outputThreads = input["outputThreads"].as<unsigned>();
+  }
+  if (input["parallelOutputMinSourceLength"].isNumber()) {
+    this->parallelOutputMinSourceLength = input["parallelOutputMinSourceLength"].as<unsigned>();
+  }
 
   ShBuiltInResources & a = this->angle;
 
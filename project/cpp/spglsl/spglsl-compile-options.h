@@ -20,8 +20,20 @@ class SpglslCompileOptions : NonCopyable {
   bool minify;
   bool mangle;
   emscripten::val mangle_global_map;
+  emscripten::val mangle_map;
   bool beautify;
   bool recordConstantPrecision;
+  bool optimizeGzip;
+  bool mangleLiveRanges;
+  bool coalesceLocals;
+  bool mangleFields;
+  bool lowPrecisionLiterals;
+  bool hoistLiterals;
+  bool defineMacros;
+  bool sourceMap;
+  bool reportRepeatedSubtrees;
+  unsigned outputThreads;
+  size_t parallelOutputMinSourceLength;
 
   explicit SpglslCompileOptions();
   ~SpglslCompileOptions();
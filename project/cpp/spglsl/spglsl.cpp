@@ -2,10 +2,24 @@
 
 #include <sstream>
 
+#include "core/gzip-size.h"
+#include "spglsl-angle/lib/spglsl-glsl-macros.h"
+#include "spglsl-angle/lib/spglsl-source-map.h"
 #include "spglsl-angle/spglsl-angle-compiler-handle.h"
+#include "spglsl-angle/spglsl-angle-compiler.h"
 #include "spglsl-compile-options.h"
 #include "spglsl-init.h"
 
+/** Checks that a rewritten output is still a valid shader, compiling it again with the same options */
+static bool _validateOutput(emscripten::val cinput, emscripten::val resourceLimitsVal, const std::string & output) {
+  SpglslCompileOptions coptions;
+  coptions.loadFromVal(cinput, resourceLimitsVal);
+  coptions.compileMode = SpglslCompileMode::Validate;
+
+  SpglslAngleCompilerHandle angleCompiler(coptions);
+  return angleCompiler.isInitialized() && angleCompiler.compile(output);
+}
+
 emscripten::val spglsl_angle_compile(emscripten::val cinput,
     emscripten::val resourceLimitsVal,
     const std::string & mainSourceCode) {
@@ -25,13 +39,30 @@ emscripten::val spglsl_angle_compile(emscripten::val cinput,
     wresult.set("valid", emscripten::val(angleValid));
 
     if (angleValid) {
-      wresult.set("output", angleCompiler.decompileOutput());
+      SpglslSourceMap sourceMap;
+      std::string output = angleCompiler.decompileOutput(coptions.sourceMap ? &sourceMap : nullptr);
+      if (coptions.sourceMap) {
+        std::string sourcePath = cinput["mainFilePath"].isString() ? cinput["mainFilePath"].as<std::string>() : "";
+        wresult.set("sourceMap", sourceMap.toJSON(sourcePath));
+      }
+      if (coptions.defineMacros) {
+        std::string withMacros;
+        size_t saved = spglslDefineMacros(output, withMacros);
+        if (saved != 0 && _validateOutput(cinput, resourceLimitsVal, withMacros)) {
+          output = std::move(withMacros);
+          wresult.set("macroBytesSaved", emscripten::val(saved));
+        }
+      }
+      wresult.set("gzipSize", emscripten::val(gzipSize(output)));
+      wresult.set("output", output);
     }
     const auto * uniformsMap = angleCompiler.getUniforms();
     const auto * globalsMap = angleCompiler.getGlobals();
+    const auto * mangleMapNames = angleCompiler.getMangleMap();
 
     emscripten::val uniforms = emscripten::val::object();
     emscripten::val globals = emscripten::val::object();
+    emscripten::val mangleMap = emscripten::val::object();
 
     if (uniformsMap) {
       for (const auto & item : *uniformsMap) {
@@ -45,8 +76,31 @@ emscripten::val spglsl_angle_compile(emscripten::val cinput,
       }
     }
 
+    if (mangleMapNames) {
+      for (const auto & item : *mangleMapNames) {
+        mangleMap.set(item.first, item.second);
+      }
+    }
+
     wresult.set("uniforms", uniforms);
     wresult.set("globals", globals);
+    wresult.set("mangleMap", mangleMap);
+
+    const auto * repeatedSubtreesList = angleCompiler.getRepeatedSubtrees();
+    if (coptions.reportRepeatedSubtrees && repeatedSubtreesList) {
+      emscripten::val repeatedSubtrees = emscripten::val::array();
+      for (const auto & item : *repeatedSubtreesList) {
+        emscripten::val lines = emscripten::val::array();
+        for (int line : item.lines) {
+          lines.call<void>("push", line);
+        }
+        emscripten::val repeated = emscripten::val::object();
+        repeated.set("nodes", emscripten::val(item.nodes));
+        repeated.set("lines", lines);
+        repeatedSubtrees.call<void>("push", repeated);
+      }
+      wresult.set("repeatedSubtrees", repeatedSubtrees);
+    }
   }
   return wresult;
 }
@@ -57,29 +111,3 @@ EMSCRIPTEN_BINDINGS(spglsl) {
   function("spglsl_init", &spglsl_init);
   function("spglsl_angle_compile", &spglsl_angle_compile);
 }
-
-namespace angle {
-  bool IsDebuggerAttached() {
-    return false;
-  }
-
-  void BreakDebugger() {
-  }
-};
-
-namespace gl {
-  namespace priv {
-    bool ShouldCreatePlatformLogMessage(int severity) {
-      return false;
-    }
-  }
-  
-  LogMessage::LogMessage(const char *file, const char *function, int line, LogSeverity severity) :
-    mFile(file), mFunction(function), mLine(line), mSeverity(severity)
-  {
-  }
-
-
-  LogMessage::~LogMessage() {
-  }
-};
\ No newline at end of file
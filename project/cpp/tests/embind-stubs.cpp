@@ -0,0 +1,39 @@
+#include <cstdio>
+#include <cstdlib>
+
+/**
+ * The embind imports are JavaScript functions, a native test has none of them.
+ * The tests only use undefined and null values, the inline code of emscripten::val never calls the imports for them.
+ * These stubs only satisfy the linker, a test that reaches one of them is aborted with the name of the import.
+ * val.h is not included, the signatures do not matter for functions that are never called.
+ */
+
+[[noreturn]] static void _emvalStubCalled(const char * name) {
+  fprintf(stderr, "embind import %s called in a native test\n", name);
+  abort();
+}
+
+#define SPGLSL_EMVAL_STUB(name) \
+  extern "C" void name() {      \
+    _emvalStubCalled(#name);    \
+  }
+
+SPGLSL_EMVAL_STUB(_emval_incref)
+SPGLSL_EMVAL_STUB(_emval_decref)
+SPGLSL_EMVAL_STUB(_emval_run_destructors)
+SPGLSL_EMVAL_STUB(_emval_new_array)
+SPGLSL_EMVAL_STUB(_emval_new_object)
+SPGLSL_EMVAL_STUB(_emval_new_cstring)
+SPGLSL_EMVAL_STUB(_emval_new_u8string)
+SPGLSL_EMVAL_STUB(_emval_take_value)
+SPGLSL_EMVAL_STUB(_emval_get_global)
+SPGLSL_EMVAL_STUB(_emval_get_property)
+SPGLSL_EMVAL_STUB(_emval_set_property)
+SPGLSL_EMVAL_STUB(_emval_as)
+SPGLSL_EMVAL_STUB(_emval_as_int64)
+SPGLSL_EMVAL_STUB(_emval_as_uint64)
+SPGLSL_EMVAL_STUB(_emval_equals)
+SPGLSL_EMVAL_STUB(_emval_strictly_equals)
+SPGLSL_EMVAL_STUB(_emval_typeof)
+SPGLSL_EMVAL_STUB(_emval_is_number)
+SPGLSL_EMVAL_STUB(_emval_is_string)
@@ -0,0 +1,208 @@
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "spglsl/core/float-to-decimal.h"
+#include "spglsl/core/math-utils.h"
+#include "spglsl/core/string-utils.h"
+
+static float floatFromBits(uint32_t bits) {
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+/** Runs fn(begin, end) on slices of [0, count) in all the hardware threads */
+template <typename Fn>
+static void parallelFor(uint64_t count, Fn fn) {
+  const uint64_t threadsCount = std::max(1u, std::thread::hardware_concurrency());
+  std::vector<std::thread> threads;
+  for (uint64_t t = 0; t < threadsCount; ++t) {
+    threads.emplace_back(fn, count * t / threadsCount, count * (t + 1) / threadsCount);
+  }
+  for (std::thread & thread : threads) {
+    thread.join();
+  }
+}
+
+/** Writes a decimal as std::to_chars writes the shortest scientific notation, d.ddde+XX */
+static size_t writeScientific(char * out, bool negative, const SpglslFloatDecimal & decimal) {
+  char digits[16];
+  const size_t digitsLength = (size_t)snprintf(digits, sizeof(digits), "%u", decimal.digits);
+  const int32_t exponent = decimal.exponent + (int32_t)digitsLength - 1;
+  size_t length = 0;
+  if (negative) {
+    out[length++] = '-';
+  }
+  out[length++] = digits[0];
+  if (digitsLength > 1) {
+    out[length++] = '.';
+    memcpy(out + length, digits + 1, digitsLength - 1);
+    length += digitsLength - 1;
+  }
+  length += (size_t)snprintf(out + length, 16, "e%c%02d", exponent < 0 ? '-' : '+', std::abs(exponent));
+  return length;
+}
+
+/** floatToShortestDecimal must produce the same digits as std::to_chars for every finite float */
+static bool checkShortestDecimal() {
+  std::atomic<uint64_t> mismatches{0};
+  std::atomic<uint64_t> checked{0};
+  parallelFor(1ull << 32, [&](uint64_t begin, uint64_t end) {
+    uint64_t localMismatches = 0;
+    uint64_t localChecked = 0;
+    for (uint64_t bits = begin; bits < end; ++bits) {
+      const float value = floatFromBits((uint32_t)bits);
+      if (!std::isfinite(value) || value == 0) {
+        continue;
+      }
+      char expected[64];
+      const char * expectedEnd = std::to_chars(expected, expected + sizeof(expected), value,
+          std::chars_format::scientific).ptr;
+      char actual[64];
+      const size_t actualLength = writeScientific(actual, value < 0, floatToShortestDecimal(std::abs(value)));
+      ++localChecked;
+      if ((size_t)(expectedEnd - expected) != actualLength || memcmp(expected, actual, actualLength) != 0) {
+        if (localMismatches++ < 10) {
+          fprintf(stderr, "floatToShortestDecimal 0x%08x: %.*s, expected %.*s\n", (uint32_t)bits, (int)actualLength,
+              actual, (int)(expectedEnd - expected), expected);
+        }
+      }
+    }
+    mismatches += localMismatches;
+    checked += localChecked;
+  });
+  printf("floatToShortestDecimal: %llu floats, %llu mismatches\n", (unsigned long long)checked.load(),
+      (unsigned long long)mismatches.load());
+  return mismatches == 0;
+}
+
+/** The formatter floatToGlsl used before the shortest decimal, formats with std::stringstream */
+static std::string oldFloatToGlslInner(float value, bool scientific) {
+  std::string s;
+  float diff = 0;
+  for (int i = 8; i >= 0; --i) {
+    std::stringstream ss;
+    if (scientific) {
+      ss.unsetf(std::ios::fixed);
+      ss.setf(std::ios::scientific);
+    } else {
+      ss.setf(std::ios::fixed);
+      ss.unsetf(std::ios::scientific);
+    }
+    ss.precision(i);
+    ss << value;
+
+    float v = std::stof(ss.str());
+    float ndiff = std::abs(v - value);
+    if (ndiff <= diff || s.empty() || v == value) {
+      ndiff = diff;
+      s = ss.str();
+    }
+  }
+
+  bool hasDot = s.find('.') != std::string::npos;
+
+  if (s.size() > 1 && s[0] == '+') {
+    s.erase(0, 1);
+  }
+
+  auto expSplit = stringSplit(s, "e");
+  bool isExponential = expSplit.size() > 1;
+  if (isExponential) {
+    s = expSplit[0] + "e" + std::to_string(std::stoi(expSplit[1]));
+  }
+  if (s.size() > 2 && s[s.size() - 2] == 'e' && s[s.size() - 1] == '0') {
+    s = s.substr(0, s.size() - 2);
+    isExponential = false;
+  }
+
+  if (!isExponential && !hasDot) {
+    s += '.';
+  }
+  if (hasDot) {
+    while (s.size() > 1 && s[s.size() - 1] == '0') {
+      s.erase(s.size() - 1, 1);
+    }
+  }
+  if (s.size() > 2 && s[0] == '0' && s[1] == '.') {
+    s.erase(0, 1);
+  }
+  if (s.size() > 3 && s[0] == '-' && s[1] == '0' && s[2] == '.') {
+    s.erase(0, 2);
+    s = "-" + s;
+  }
+  if (s == "." || s == "-." || s == "-0.") {
+    return "0.";
+  }
+  if (s.empty()) {
+    return "0.";
+  }
+
+  return s;
+}
+
+static std::string oldFloatToGlsl(float value) {
+  if (std::abs(value) < FLT_MIN) {
+    return "0.";
+  }
+  const std::string fixed = oldFloatToGlslInner(value, false);
+  const std::string scientific = oldFloatToGlslInner(value, true);
+  return fixed.size() <= scientific.size() ? fixed : scientific;
+}
+
+/**
+ * floatToGlsl must produce the same literal as the old formatter, on a sample of all the finite floats.
+ * Skipped: the values where the old literal does not convert back to the same float, which are its known bugs
+ * (exponents with trailing zeros stripped, fixed notation limited to 8 decimals, std::stof out_of_range near FLT_MIN),
+ * and the values written as a known expression like acos(-1.).
+ */
+static bool checkOldFormatter(uint32_t stride) {
+  std::atomic<uint64_t> mismatches{0};
+  std::atomic<uint64_t> checked{0};
+  std::atomic<uint64_t> skipped{0};
+  const uint64_t samplesCount = ((1ull << 32) + stride - 1) / stride;
+  parallelFor(samplesCount, [&](uint64_t begin, uint64_t end) {
+    for (uint64_t sample = begin; sample < end; ++sample) {
+      const uint32_t bits = (uint32_t)(sample * stride);
+      const float value = floatFromBits(bits);
+      if (!std::isfinite(value)) {
+        continue;
+      }
+      const std::string actual = floatToGlsl(value, false);
+      std::string expected;
+      try {
+        expected = oldFloatToGlsl(value);
+      } catch (const std::out_of_range &) {
+        ++skipped;
+        continue;
+      }
+      if (actual.find('(') != std::string::npos || strtof(expected.c_str(), nullptr) != value) {
+        ++skipped;
+        continue;
+      }
+      ++checked;
+      if (actual != expected && mismatches++ < 10) {
+        fprintf(stderr, "floatToGlsl 0x%08x: %s, expected %s\n", bits, actual.c_str(), expected.c_str());
+      }
+    }
+  });
+  printf("floatToGlsl: %llu floats, %llu skipped, %llu mismatches\n", (unsigned long long)checked.load(),
+      (unsigned long long)skipped.load(), (unsigned long long)mismatches.load());
+  return mismatches == 0;
+}
+
+int main() {
+  bool valid = checkShortestDecimal();
+  valid = checkOldFormatter(10007) && valid;
+  return valid ? 0 : 1;
+}
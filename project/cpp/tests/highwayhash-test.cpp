@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "spglsl/core/hash-stream.h"
+#include "spglsl/external/highwayhash/highwayhash.h"
+
+using namespace highwayhash;
+
+static const uint64_t hashKey[4] = {0x125231, 0x876832, 0x8876263, 0x7486864};
+
+struct HashVector {
+  size_t size;
+  uint64_t hash[4];
+};
+
+/**
+ * Digests of the bytes 0, 1, 2... with the key of SpglslHasher, computed with the scalar backend.
+ * The digests are persisted in the mangle map keys, every backend of every build must produce the same values.
+ */
+static const HashVector hashVectors[] = {
+    {0, {0x9867cdd52bbeaf6dull, 0x1aff5da960a5f2eeull, 0x2ff4defade1c9785ull, 0x82d332e9247bd2f7ull}},
+    {1, {0xca83f44db41bc064ull, 0xcf7616b63ebea8aaull, 0xae7da6346114a11aull, 0xab575967c14bfb76ull}},
+    {31, {0x7e2ad25c0a3cbe30ull, 0xd97af0c7c54735d7ull, 0x2a43859c92f1b1d0ull, 0x5bf3ed6dd0befd88ull}},
+    {32, {0x2c3b57d0b6ce7363ull, 0x8d24920daa9ab992ull, 0xf7d4630dc79ac0cdull, 0x76b5a180b8991720ull}},
+    {33, {0x6f37c79d7a9272b0ull, 0xefda0d6c7546916full, 0xfb8e01a8dda002abull, 0xfe2b369de98989c7ull}},
+    {63, {0x16a47a2b401966c1ull, 0x6daeacc7df830efeull, 0x0ef0ebf12a386a87ull, 0x769cee90f740fd28ull}},
+    {64, {0x69a08aef8383a4ddull, 0xd69df8f51a98f30dull, 0x69cb9f7cee60acebull, 0x0953560fdf538b09ull}},
+    {65, {0xaf27349380664925ull, 0x583364b6781feeaaull, 0x094af4d24f1b6b6cull, 0x1f537cb58d9e6d8eull}},
+    {255, {0x1dbfdfe43256d4f5ull, 0xd88f6b0cddc4b4aaull, 0xea3dd696e7dab242ull, 0xa249cc297a260c9aull}},
+    {256, {0x760008b1f98d12b0ull, 0x381e77e0433dd2c4ull, 0xe0ec92523377f63aull, 0x288b7ccd146edacaull}},
+    {257, {0x64caff6a33c2b26full, 0x2fa3d0461ad0664bull, 0x872d43c764da0b0dull, 0x82089285f0afdd2cull}},
+    {300, {0x2b9d8d0d2b44759aull, 0x672962f87e06f6e4ull, 0xb71498bbbd10c302ull, 0xc0f92a6c0bf11f70ull}},
+    {1000, {0x686d8159c8d1109bull, 0xda990205d8ef23b3ull, 0xcd36ffce7021709dull, 0x4cb50b282072512aull}},
+};
+
+struct Backend {
+  HighwayHashBackend backend;
+  const char * name;
+};
+
+static const Backend backends[] = {
+    {HighwayHashBackendScalar, "scalar"},
+    {HighwayHashBackendAVX2, "avx2"},
+    {HighwayHashBackendSIMD128, "simd128"},
+};
+
+/** Hashes the whole packets with the given backend and the remainder with the Cat API */
+static bool hashWith(HighwayHashBackend backend, const uint8_t * data, size_t size, SpglslHashValue & result) {
+  HighwayHashCat cat;
+  HighwayHashCatStart(hashKey, &cat);
+  if (!HighwayHashUpdatePacketsWith(backend, data, size / 32, &cat.state)) {
+    return false;
+  }
+  HighwayHashCatAppend(data + size - size % 32, size % 32, &cat);
+  HighwayHashCatFinish256(&cat, result.data);
+  return true;
+}
+
+static bool checkDigest(const char * what, size_t size, const SpglslHashValue & value, const SpglslHashValue & expected) {
+  if (value == expected) {
+    return true;
+  }
+  fprintf(stderr, "%s, %zu bytes: %016" PRIx64 " %016" PRIx64 " %016" PRIx64 " %016" PRIx64 ", expected %016" PRIx64
+                  " %016" PRIx64 " %016" PRIx64 " %016" PRIx64 "\n",
+      what, size, value.a, value.b, value.c, value.d, expected.a, expected.b, expected.c, expected.d);
+  return false;
+}
+
+/** Checks every backend available in this build and on this CPU against the persisted digests */
+static bool checkHashVectors(const std::vector<uint8_t> & data) {
+  bool valid = true;
+  for (const Backend & backend : backends) {
+    for (const HashVector & vector : hashVectors) {
+      SpglslHashValue expected;
+      memcpy(expected.data, vector.hash, sizeof(expected.data));
+      SpglslHashValue value;
+      if (!hashWith(backend.backend, data.data(), vector.size, value)) {
+        printf("%s backend not available\n", backend.name);
+        break;
+      }
+      valid = checkDigest(backend.name, vector.size, value, expected) && valid;
+    }
+  }
+
+  for (const HashVector & vector : hashVectors) {
+    SpglslHashValue expected;
+    memcpy(expected.data, vector.hash, sizeof(expected.data));
+    SpglslHasher hasher;
+    hasher.append(data.data(), vector.size);
+    valid = checkDigest("SpglslHasher", vector.size, hasher.digest(), expected) && valid;
+  }
+  return valid;
+}
+
+/**
+ * Compares every backend with the scalar one on random inputs of every length up to maxSize,
+ * and the SpglslHasher staging buffer fed with random split appends.
+ */
+static bool checkRandomInputs(size_t maxSize) {
+  std::mt19937 random(0x125231);
+  std::vector<uint8_t> data(maxSize);
+  bool valid = true;
+  for (size_t size = 0; size <= maxSize; ++size) {
+    for (size_t i = 0; i < size; ++i) {
+      data[i] = (uint8_t)random();
+    }
+
+    SpglslHashValue expected;
+    hashWith(HighwayHashBackendScalar, data.data(), size, expected);
+
+    for (const Backend & backend : backends) {
+      SpglslHashValue value;
+      if (hashWith(backend.backend, data.data(), size, value)) {
+        valid = checkDigest(backend.name, size, value, expected) && valid;
+      }
+    }
+
+    SpglslHashValue oneShot;
+    HighwayHash256(data.data(), size, hashKey, oneShot.data);
+    valid = checkDigest("HighwayHash256", size, oneShot, expected) && valid;
+
+    // Splits of up to 600 bytes cross the 256 bytes staging buffer in both directions.
+    SpglslHasher hasher;
+    for (size_t offset = 0; offset < size;) {
+      size_t split = std::min<size_t>(random() % 600, size - offset);
+      hasher.append(data.data() + offset, split);
+      offset += split;
+    }
+    valid = checkDigest("SpglslHasher split appends", size, hasher.digest(), expected) && valid;
+
+    if (!valid) {
+      break;
+    }
+  }
+  return valid;
+}
+
+int main() {
+  std::vector<uint8_t> data(1000);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = (uint8_t)i;
+  }
+
+  bool valid = checkHashVectors(data);
+  valid = checkRandomInputs(2048) && valid;
+  return valid ? 0 : 1;
+}
@@ -0,0 +1,106 @@
+#include <cstdio>
+#include <string>
+
+#include "spglsl/spglsl-angle/spglsl-angle-compiler-handle.h"
+#include "spglsl/spglsl-angle/spglsl-angle-compiler.h"
+#include "spglsl/spglsl-angle/spglsl-angle-parallel-output.h"
+#include "spglsl/spglsl-compile-options.h"
+#include "spglsl/spglsl-init.h"
+
+/**
+ * A shader with many functions, with variables declared directly before a function and structs declared
+ * between functions, where the state of the writer crosses the boundary of a function.
+ */
+static std::string makeShader(int functionsCount) {
+  std::string source =
+      "#version 300 es\n"
+      "precision highp float;\n"
+      "uniform float uTime;\n"
+      "out vec4 fragColor;\n";
+  for (int i = 0; i < functionsCount; ++i) {
+    const std::string n = std::to_string(i);
+    const std::string previous = i == 0 ? "uTime" : "f" + std::to_string(i - 1) + "(x * 0.5)";
+    if (i % 4 == 1) {
+      source += "float g" + n + " = " + n + ".25;\n";
+    }
+    if (i % 4 == 2) {
+      source += "struct S" + n + " { vec3 color; float power; };\n";
+      source += "S" + n + " s" + n + "(float x) { return S" + n + "(vec3(x, " + previous + ", 1.0), x * 2.0); }\n";
+    }
+    source += "float f" + n + "(float x) {\n";
+    source += "  float a = sin(x * " + n + ".5 + uTime);\n";
+    if (i % 4 == 1) {
+      source += "  a += g" + n + ";\n";
+      source += "  g" + n + " = a;\n";
+    }
+    if (i % 4 == 2) {
+      source += "  S" + n + " light = s" + n + "(a);\n";
+      source += "  a *= light.color.y * light.power;\n";
+    }
+    source += "  for (int k = 0; k < 3; ++k) {\n";
+    source += "    if (a > 0.5) { a -= cos(float(k) * a); } else { a += " + previous + "; }\n";
+    source += "  }\n";
+    source += "  return a;\n";
+    source += "}\n";
+  }
+  source += "void main() {\n";
+  source += "  fragColor = vec4(f" + std::to_string(functionsCount - 1) + "(gl_FragCoord.x), 0.0, 0.0, 1.0);\n";
+  source += "}\n";
+  return source;
+}
+
+/** Checks that the functions written in parallel produce the same bytes as the serial output */
+static bool checkParallelOutput(const std::string & source, bool minify, bool beautify) {
+  SpglslCompileOptions options;
+  options.minify = minify;
+  options.mangle = minify;
+  options.beautify = beautify;
+
+  SpglslAngleCompilerHandle handle(options);
+  if (!handle.compile(source)) {
+    fprintf(stderr, "compilation failed\n%s\n", handle.getInfoLog().c_str());
+    return false;
+  }
+
+  options.outputThreads = 1;
+  const std::string serial = handle.decompileOutput();
+
+  SpglslAngleCompiler & compiler = *handle.compiler;
+  std::string parallel;
+  SpglslAngleParallelOutput outputTraverser(
+      parallel, compiler.symbols, compiler.precisions, options.beautify, &compiler.floatLiteralCache);
+  outputTraverser.lowPrecisionLiterals = options.lowPrecisionLiterals;
+  outputTraverser.writeHeader(compiler.metadata.shaderVersion, compiler.metadata.pragma, compiler.extensionBehavior);
+  if (!outputTraverser.writeBody(compiler.body, 4) || outputTraverser.getParallelFunctionsCount() == 0) {
+    fprintf(stderr, "minify=%d beautify=%d: the functions were not written in parallel\n", minify, beautify);
+    return false;
+  }
+  if (parallel != serial) {
+    fprintf(stderr, "minify=%d beautify=%d: the parallel output differs\n%s\n----\n%s\n", minify, beautify,
+        serial.c_str(), parallel.c_str());
+    return false;
+  }
+
+  // The same output through the options of the compiler.
+  options.outputThreads = 4;
+  options.parallelOutputMinSourceLength = 0;
+  if (handle.decompileOutput() != serial) {
+    fprintf(stderr, "minify=%d beautify=%d: the output with outputThreads differs\n", minify, beautify);
+    return false;
+  }
+  return true;
+}
+
+int main() {
+  if (!spglsl_init(emscripten::val::null())) {
+    fprintf(stderr, "initialization failed\n");
+    return 1;
+  }
+
+  const std::string source = makeShader(24);
+  bool valid = true;
+  valid = checkParallelOutput(source, true, false) && valid;
+  valid = checkParallelOutput(source, true, true) && valid;
+  valid = checkParallelOutput(source, false, true) && valid;
+  return valid ? 0 : 1;
+}
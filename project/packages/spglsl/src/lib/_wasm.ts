@@ -1,4 +1,4 @@
-import type { SpglslAngleCompileResult } from "../spglsl-compile";
+import type { SpglslAngleCompileResult, SpglslRepeatedSubtree } from "../spglsl-compile";
 import type { SpglslResourceLimits } from "../spglsl-resource-limits";
 
 export interface WasmSpglsl {
@@ -10,8 +10,13 @@ export interface WasmSpglsl {
     infoLog?: string | undefined;
     valid?: boolean | undefined;
     output?: string | undefined;
+    gzipSize?: number | undefined;
+    sourceMap?: string | undefined;
+    macroBytesSaved?: number | undefined;
     uniforms?: Record<string, string> | undefined;
     globals?: Record<string, string> | undefined;
+    mangleMap?: Record<string, string> | undefined;
+    repeatedSubtrees?: SpglslRepeatedSubtree[] | undefined;
   };
 }
 
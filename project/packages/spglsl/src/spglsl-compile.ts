@@ -21,8 +21,85 @@ export interface SpglslAngleCompileOptions {
   /** If not undefined, and mangle is true, this field will be used to mange uniforms and shared between compilation steps. */
   mangle_global_map?: Record<string, string> | undefined;
 
+  /**
+   * If not undefined, and mangle is true, the mangleMap of a previous compilation of the same shader.
+   * Symbols that did not change keep the names they had in the previous compilation, when possible.
+   */
+  mangle_map?: Record<string, string> | undefined;
+
   beautify?: boolean;
   recordConstantPrecision?: boolean;
+
+  /**
+   * If true, the compiler tries different mangling strategies and orders of global declarations
+   * and keeps the one with the smallest gzipped output.
+   */
+  optimizeGzip?: boolean;
+
+  /**
+   * If true, and mangle is true, a local variable can reuse the name of an outer variable
+   * that is not used anymore in the rest of the block where the local variable is declared.
+   */
+  mangleLiveRanges?: boolean;
+
+  /**
+   * If true, local variables of the same type declared in the same block are merged into one variable
+   * when their lifetimes do not overlap.
+   */
+  coalesceLocals?: boolean;
+
+  /**
+   * If true, and mangle is true, the fields of the structs are renamed too.
+   * Structs used by uniforms, shader inputs and outputs and interface blocks keep their field names.
+   */
+  mangleFields?: boolean;
+
+  /**
+   * If true, float literals used by mediump or lowp expressions are written with only the digits
+   * that are meaningful at that precision, for example 3.14 instead of 3.1415927 in a mediump expression.
+   * This changes the value of the literals on hardware that evaluates mediump at full precision.
+   */
+  lowPrecisionLiterals?: boolean;
+
+  /**
+   * If true, and mangle is true, float constants repeated many times in the shader are declared once
+   * as a global const and replaced by its name, when this makes the output shorter.
+   */
+  hoistLiterals?: boolean;
+
+  /**
+   * If true, and minify is true, the keywords and names repeated many times in the output are replaced
+   * by short #define aliases, when this makes the output shorter and the result still compiles.
+   */
+  defineMacros?: boolean;
+
+  /**
+   * If true, a source map v3 of the output is generated in outputSourceMap, mapping the statements and symbols
+   * to their source line, and the mangled names to the original names. defineMacros is ignored if true.
+   */
+  sourceMap?: boolean;
+
+  /**
+   * If true, the largest subtrees that appear more than once in the source are reported in repeatedSubtrees,
+   * with their source lines. Useful to find the code worth moving to a function.
+   */
+  reportRepeatedSubtrees?: boolean;
+
+  /**
+   * Threads used to write the functions of large shaders, 0 or undefined uses the hardware concurrency.
+   * The output is the same with any number of threads. Ignored by the wasm builds without threads.
+   */
+  outputThreads?: number;
+
+  /** Shaders shorter than this are written serially, 1MB by default. Ignored by the wasm builds without threads. */
+  parallelOutputMinSourceLength?: number;
+}
+
+export interface SpglslRepeatedSubtree {
+  /** Number of AST nodes in one occurrence */
+  nodes: number;
+  /** Source line of each occurrence, in ascending order */
+  lines: number[];
 }
 
 export interface SpglslAngleCompileInput extends SpglslAngleCompileOptions {
@@ -48,10 +125,23 @@ export class SpglslAngleCompileResult {
   /** The output or null if there is no output */
   public output: string | null;
 
+  /** The size in bytes of the output compressed with gzip at level 9, or 0 if there is no output */
+  public gzipSize: number;
+
+  /** If sourceMap is true, the source map v3 JSON of the output, or null if there is no output */
+  public outputSourceMap: string | null;
+
+  /** If defineMacros is true, the number of bytes saved by the #define aliases, 0 if none was used */
+  public macroBytesSaved: number;
+
   /** The map of uniform names defined in the shader */
   public uniforms: Record<string, string>;
   /** The map of globals defined in the shader (attributes, shared variables, outputs ...), excluding uniforms */
   public globals: Record<string, string>;
+  /** If mangle is true, the map of the stable keys of the renamed symbols and their names, to pass as mangle_map */
+  public mangleMap: Record<string, string>;
+  /** If reportRepeatedSubtrees is true, the subtrees that appear more than once in the source, largest first */
+  public repeatedSubtrees: SpglslRepeatedSubtree[];
 
   /** Simple parsed #define constants. Only plain numbers and booleans are supported. */
   public constDefs: Record<string, number | boolean>;
@@ -61,9 +151,21 @@ export class SpglslAngleCompileResult {
 
   public mangle: boolean;
   public mangle_global_map: Record<string, string> | undefined;
+  public mangle_map: Record<string, string> | undefined;
 
   public beautify: boolean;
   public recordConstantPrecision: boolean;
+  public optimizeGzip: boolean;
+  public mangleLiveRanges: boolean;
+  public coalesceLocals: boolean;
+  public mangleFields: boolean;
+  public lowPrecisionLiterals: boolean;
+  public hoistLiterals: boolean;
+  public defineMacros: boolean;
+  public sourceMap: boolean;
+  public reportRepeatedSubtrees: boolean;
+  public outputThreads: number;
+  public parallelOutputMinSourceLength: number | undefined;
   public cwd: string | undefined;
 
   public constructor() {
@@ -75,15 +177,32 @@ export class SpglslAngleCompileResult {
     this.valid = false;
     this.customData = undefined;
     this.output = null;
+    this.gzipSize = 0;
+    this.outputSourceMap = null;
+    this.macroBytesSaved = 0;
     this.uniforms = {};
     this.globals = {};
+    this.mangleMap = {};
+    this.repeatedSubtrees = [];
     this.constDefs = {};
     this.infoLog = new GlslInfoLogArray();
     this.minify = false;
     this.mangle = false;
     this.mangle_global_map = undefined;
+    this.mangle_map = undefined;
     this.beautify = false;
     this.recordConstantPrecision = DEFAULT_RECORD_CONSTANT_PRECISION;
+    this.optimizeGzip = false;
+    this.mangleLiveRanges = false;
+    this.coalesceLocals = false;
+    this.mangleFields = false;
+    this.lowPrecisionLiterals = false;
+    this.hoistLiterals = false;
+    this.defineMacros = false;
+    this.sourceMap = false;
+    this.reportRepeatedSubtrees = false;
+    this.outputThreads = 0;
+    this.parallelOutputMinSourceLength = undefined;
     this.duration = 0;
     this.cwd = undefined;
   }
@@ -102,9 +221,21 @@ export async function spglslAngleCompile(input: Readonly<SpglslAngleCompileInput
 
   result.mangle = input.mangle === undefined ? result.minify : !!input.mangle;
   result.mangle_global_map = input.mangle_global_map || undefined;
+  result.mangle_map = input.mangle_map || undefined;
 
   result.beautify = input.beautify === undefined ? !result.minify : !!input.beautify;
   result.recordConstantPrecision = input.recordConstantPrecision || DEFAULT_RECORD_CONSTANT_PRECISION;
+  result.optimizeGzip = !!input.optimizeGzip;
+  result.mangleLiveRanges = !!input.mangleLiveRanges;
+  result.coalesceLocals = !!input.coalesceLocals;
+  result.mangleFields = !!input.mangleFields;
+  result.lowPrecisionLiterals = !!input.lowPrecisionLiterals;
+  result.hoistLiterals = !!input.hoistLiterals;
+  result.defineMacros = !!input.defineMacros;
+  result.sourceMap = !!input.sourceMap;
+  result.reportRepeatedSubtrees = !!input.reportRepeatedSubtrees;
+  result.outputThreads = input.outputThreads || 0;
+  result.parallelOutputMinSourceLength = input.parallelOutputMinSourceLength;
   result.cwd = input.cwd;
   const resourceLimits = { ...SpglslResourceLimits, ...input.resourceLimits };
 
@@ -151,8 +282,13 @@ export async function spglslAngleCompile(input: Readonly<SpglslAngleCompileInput
 
   result.valid = !result.infoLog.hasErrors();
   result.output = typeof wresult.output === "string" ? wresult.output : null;
+  result.gzipSize = (result.output !== null && wresult.gzipSize) || 0;
+  result.outputSourceMap = result.output !== null && typeof wresult.sourceMap === "string" ? wresult.sourceMap : null;
+  result.macroBytesSaved = (result.output !== null && wresult.macroBytesSaved) || 0;
   result.uniforms = wresult.uniforms || {};
   result.globals = wresult.globals || {};
+  result.mangleMap = wresult.mangleMap || {};
+  result.repeatedSubtrees = wresult.repeatedSubtrees || [];
   result.constDefs = constDefs;
 
   return result;
@@ -0,0 +1,175 @@
+#!/usr/bin/env node
+
+// Script that generates cpp/spglsl/core/float-known-expressions-autogen.h,
+// a sorted table of float values, keyed by their bits, that can be written as a GLSL expression
+// shorter than (or as long as) their shortest literal, for example acos(-1.) for pi.
+// Change the configuration below and run it again to search more expression forms.
+
+const path = require("path");
+const fs = require("fs");
+
+const projectDir = path.resolve(__dirname, "../");
+const outputFilePath = path.resolve(projectDir, "cpp/spglsl/core/float-known-expressions-autogen.h");
+
+/** Arguments from 0 to 4.9 with step 0.1, for the functions below */
+const tenthsArguments = Array.from({ length: 50 }, (_, i) => Math.fround(i / 10));
+
+/** Integer arguments from 2 to 99 */
+const integerArguments = Array.from({ length: 98 }, (_, i) => i + 2);
+
+/** Maximum denominator of the fractions a/b that are searched */
+const fractionsMaxDenominator = 16;
+
+const functionForms = [
+  { name: "cos", fn: Math.cos, args: tenthsArguments },
+  { name: "sin", fn: Math.sin, args: tenthsArguments },
+  { name: "exp", fn: Math.exp, args: tenthsArguments },
+  { name: "sqrt", fn: Math.sqrt, args: tenthsArguments },
+  { name: "atan", fn: Math.atan, args: tenthsArguments },
+  { name: "asinh", fn: Math.asinh, args: tenthsArguments },
+  { name: "cosh", fn: Math.cosh, args: tenthsArguments },
+  { name: "sqrt", fn: Math.sqrt, args: integerArguments },
+  { name: "log", fn: Math.log, args: integerArguments },
+];
+
+/** Shortest GLSL literal of a float, as floatToGlsl in core/math-utils.cpp */
+function floatToGlsl(value) {
+  if (value === 0) {
+    return "0.";
+  }
+  const sign = value < 0 ? "-" : "";
+  const absValue = Math.abs(value);
+
+  let digits = "";
+  let exponent = 0;
+  for (let precision = 1; precision <= 9; ++precision) {
+    const s = absValue.toExponential(precision - 1);
+    if (Math.fround(Number(s)) === absValue) {
+      const [mantissa, e] = s.split("e");
+      digits = mantissa.replace(".", "");
+      exponent = Number(e) - (precision - 1);
+      break;
+    }
+  }
+  while (digits.length > 1 && digits.endsWith("0")) {
+    digits = digits.slice(0, -1);
+    ++exponent;
+  }
+
+  let fixed;
+  if (exponent >= 0) {
+    fixed = (absValue < 2 ** 64 ? BigInt(absValue).toString() : digits + "0".repeat(exponent)) + ".";
+  } else {
+    const pointPosition = digits.length + exponent;
+    fixed =
+      pointPosition > 0
+        ? `${digits.slice(0, pointPosition)}.${digits.slice(pointPosition)}`
+        : `.${"0".repeat(-pointPosition)}${digits}`;
+  }
+  fixed = sign + fixed;
+
+  const scientificExponent = exponent + digits.length - 1;
+  if (scientificExponent === 0) {
+    return fixed;
+  }
+  const scientific = `${sign}${digits[0]}${digits.length > 1 ? `.${digits.slice(1)}` : ""}e${scientificExponent}`;
+  return fixed.length <= scientific.length ? fixed : scientific;
+}
+
+function floatBits(value) {
+  const view = new DataView(new ArrayBuffer(4));
+  view.setFloat32(0, value);
+  return view.getUint32(0);
+}
+
+/** @type {Map<number, string>} */
+const expressions = new Map();
+
+function addExpression(value, expression) {
+  value = Math.fround(value);
+  if (!Number.isFinite(value) || value === 0 || Math.abs(value) < 2 ** -126) {
+    return;
+  }
+  if (expression.length > floatToGlsl(value).length) {
+    return;
+  }
+  const bits = floatBits(value);
+  const existing = expressions.get(bits);
+  if (existing === undefined || expression.length < existing.length) {
+    expressions.set(bits, expression);
+  }
+}
+
+addExpression(Math.PI, "acos(-1.)");
+addExpression(Math.PI * 2, "(acos(-1.)*2.)");
+addExpression(Math.PI / 2, "acos(0.)");
+
+for (const { name, fn, args } of functionForms) {
+  for (const arg of args) {
+    addExpression(fn(arg), `${name}(${floatToGlsl(Math.fround(arg))})`);
+  }
+}
+
+for (let b = 3; b <= fractionsMaxDenominator; ++b) {
+  for (let a = 1; a < b; ++a) {
+    addExpression(a / b, `(${floatToGlsl(a)}/${floatToGlsl(b)})`);
+  }
+}
+
+const sorted = Array.from(expressions).sort((a, b) => a[0] - b[0]);
+
+const entries = sorted
+  .map(([bits, expression]) => `    {0x${bits.toString(16).padStart(8, "0")}u, "${expression}"},`)
+  .join("\n");
+
+const contentToWrite = `// Generated by scripts/generate-known-floats.js, do not edit.
+
+#ifndef _SPGLSL_FLOAT_KNOWN_EXPRESSIONS_AUTOGEN_
+#define _SPGLSL_FLOAT_KNOWN_EXPRESSIONS_AUTOGEN_
+
+#include <cstdint>
+#include <string_view>
+
+/** A float value, as its bits, and a GLSL expression that evaluates to it */
+struct SpglslKnownFloatExpression {
+  uint32_t bits;
+  std::string_view expression;
+};
+
+constexpr uint32_t spglslKnownFloatExpressionsCount = ${sorted.length};
+
+/** Sorted by bits */
+constexpr SpglslKnownFloatExpression spglslKnownFloatExpressions[spglslKnownFloatExpressionsCount] = {
+${entries}
+};
+
+constexpr bool spglslKnownFloatExpressionsAreSorted() {
+  for (uint32_t i = 1; i < spglslKnownFloatExpressionsCount; ++i) {
+    if (spglslKnownFloatExpressions[i - 1].bits >= spglslKnownFloatExpressions[i].bits) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static_assert(spglslKnownFloatExpressionsAreSorted());
+
+#endif
+`;
+
+console.log(`${sorted.length} known float expressions`);
+console.log("Output file is ./", path.relative(projectDir, outputFilePath));
+
+let isDifferent = true;
+try {
+  if (fs.readFileSync(outputFilePath, "utf8") === contentToWrite) {
+    isDifferent = false;
+  }
+} catch (_) {}
+
+if (isDifferent) {
+  fs.writeFileSync(outputFilePath, contentToWrite, "utf8");
+  console.log("file written");
+} else {
+  console.log("already up to date");
+}
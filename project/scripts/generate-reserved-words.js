@@ -0,0 +1,205 @@
+#!/usr/bin/env node
+
+// Script that generates cpp/spglsl/spglsl-angle/symbols/spglsl-reserved-words-autogen.h,
+// a perfect hash table of the GLSL keywords and built-in names that cannot be used as mangled names.
+// Run it again after changing the list of words.
+
+const path = require("path");
+const fs = require("fs");
+
+const projectDir = path.resolve(__dirname, "../");
+const outputFilePath = path.resolve(projectDir, "cpp/spglsl/spglsl-angle/symbols/spglsl-reserved-words-autogen.h");
+
+const reservedWords = [
+  "main", "and", "or", "xor", "not", "EmitVertex", "EndPrimitive", "abs", "acos", "acosh", "active", "all",
+  "angle_BaseInstance", "angle_BaseVertex", "any", "asin", "asinh", "asm", "atan", "atanh", "atomicAdd", "atomicAnd",
+  "atomicCompSwap", "atomicCounter", "atomicCounterDecrement", "atomicCounterIncrement", "atomicExchange", "atomicMax",
+  "atomicMin", "atomicOr", "atomicXor", "attribute", "barrier", "bitCount", "bitfieldExtract", "bitfieldInsert",
+  "bitfieldReverse", "bool", "break", "bvec2", "bvec3", "bvec4", "case", "cast", "ceil", "centroid", "clamp", "class",
+  "common", "const", "continue", "cos", "cosh", "cross", "dFdx", "dFdy", "default", "degrees", "determinant", "diff",
+  "discard", "distance", "dmat2", "dmat2x2", "dmat2x3", "dmat2x4", "dmat3", "dmat3x2", "dmat3x3", "dmat3x4", "dmat4",
+  "dmat4x2", "dmat4x3", "dmat4x4", "do", "dot", "double", "dvec2", "dvec3", "dvec4", "else", "enum", "equal", "exp",
+  "exp2", "extern", "external", "faceforward", "false", "far", "filter", "findLSB", "findMSB", "fixed", "flat",
+  "float", "floatBitsToInt", "floatBitsToUint", "floor", "fma", "for", "fract", "frexp", "fvec2", "fvec3", "fvec4",
+  "fwidth", "gl_BaseInstance", "gl_BaseVertex", "gl_ClipDistance", "gl_DepthRange", "gl_DepthRangeParameters",
+  "gl_DrawID", "gl_FragColor", "gl_FragCoord", "gl_FragData", "gl_FragDepth", "gl_FragDepthEXT", "gl_FrontFacing",
+  "gl_GlobalInvocationID", "gl_HelperInvocation", "gl_InstanceID", "gl_InstanceIndex", "gl_InvocationID",
+  "gl_LastFragColor", "gl_LastFragColorARM", "gl_LastFragData", "gl_Layer", "gl_LocalInvocationID",
+  "gl_LocalInvocationIndex", "gl_MaxAtomicCounterBindings", "gl_MaxAtomicCounterBufferSize", "gl_MaxClipDistances",
+  "gl_MaxCombinedAtomicCounterBuffers", "gl_MaxCombinedAtomicCounterBuffers(", "gl_MaxCombinedAtomicCounters",
+  "gl_MaxCombinedImageUniforms", "gl_MaxCombinedShaderOutputResources", "gl_MaxCombinedShaderOutputResources(",
+  "gl_MaxCombinedTextureImageUnits", "gl_MaxComputeAtomicCounterBuffers", "gl_MaxComputeAtomicCounterBuffers(",
+  "gl_MaxComputeAtomicCounters", "gl_MaxComputeImageUniforms", "gl_MaxComputeTextureImageUnits",
+  "gl_MaxComputeUniformComponents", "gl_MaxComputeWorkGroupCount", "gl_MaxComputeWorkGroupSize", "gl_MaxDrawBuffers",
+  "gl_MaxDualSourceDrawBuffersEXT", "gl_MaxFragmentAtomicCounterBuffers", "gl_MaxFragmentAtomicCounterBuffers(",
+  "gl_MaxFragmentAtomicCounters", "gl_MaxFragmentImageUniforms", "gl_MaxFragmentInputVectors",
+  "gl_MaxFragmentUniformVectors", "gl_MaxGeometryAtomicCounterBuffers", "gl_MaxGeometryAtomicCounterBuffers(",
+  "gl_MaxGeometryAtomicCounters", "gl_MaxGeometryImageUniforms", "gl_MaxGeometryInputComponents",
+  "gl_MaxGeometryOutputComponents", "gl_MaxGeometryOutputVertices", "gl_MaxGeometryTextureImageUnits",
+  "gl_MaxGeometryTotalOutputComponents", "gl_MaxGeometryTotalOutputComponents(", "gl_MaxGeometryUniformComponents",
+  "gl_MaxImageUnits", "gl_MaxProgramTexelOffset", "gl_MaxTextureImageUnits", "gl_MaxVaryingVectors",
+  "gl_MaxVertexAtomicCounterBuffers", "gl_MaxVertexAtomicCounterBuffers(", "gl_MaxVertexAtomicCounters",
+  "gl_MaxVertexAttribs", "gl_MaxVertexImageUniforms", "gl_MaxVertexOutputVectors", "gl_MaxVertexTextureImageUnits",
+  "gl_MaxVertexUniformVectors", "gl_MinProgramTexelOffset", "gl_NumWorkGroups", "gl_PerVertex", "gl_PointCoord",
+  "gl_PointSize", "gl_Position", "gl_PrimitiveID", "gl_PrimitiveIDIn", "gl_SecondaryFragColorEXT",
+  "gl_SecondaryFragDataEXT", "gl_VertexID", "gl_VertexIndex", "gl_ViewID_OVR", "gl_ViewportIndex", "gl_WorkGroupID",
+  "gl_WorkGroupSize", "gl_in", "goto", "greaterThan", "greaterThanEqual", "groupMemoryBarrier", "half", "highp",
+  "hvec2", "hvec3", "hvec4", "if", "iimage1D", "iimage1DArray", "iimage2D", "iimage2DArray", "iimage3D",
+  "iimageBuffer", "iimageCube", "image1D", "image1DArray", "image1DArrayShadow", "image1DShadow", "image2D",
+  "image2DArray", "image2DArrayShadow", "image2DShadow", "image3D", "imageBuffer", "imageCube", "imageLoad",
+  "imageSize", "imageStore", "imulExtended", "in", "inline", "inout", "input", "int", "intBitsToFloat", "interface",
+  "invariant", "inverse", "inversesqrt", "isampler1D", "isampler1DArray", "isampler2D", "isampler2DArray",
+  "isampler2DMS", "isampler2DMSArray", "isampler2DRect", "isampler3D", "isamplerBuffer", "isamplerCube",
+  "isamplerCubeArray", "isinf", "isnan", "ivec2", "ivec3", "ivec4", "layout", "ldexp", "length", "lessThan",
+  "lessThanEqual", "log", "log2", "long", "lowp", "mat2", "mat2x2", "mat2x3", "mat2x4", "mat3", "mat3x2", "mat3x3",
+  "mat3x4", "mat4", "mat4x2", "mat4x3", "mat4x4", "matrixCompMult", "max", "mediump", "memoryBarrier",
+  "memoryBarrierAtomicCounter", "memoryBarrierBuffer", "memoryBarrierImage", "memoryBarrierShared", "min", "mix",
+  "mod", "modf", "namespace", "near", "noinline", "noperspective", "normalize", "notEqual", "out", "outerProduct",
+  "output", "packHalf2x16", "packSnorm2x16", "packSnorm4x8", "packUnorm2x16", "packUnorm4x8", "packed", "partition",
+  "patch", "pow", "precision", "public", "radians", "reflect", "refract", "return", "rgb_2_yuv", "round", "roundEven",
+  "row_major", "sample", "sampler1D", "sampler1DArray", "sampler1DArrayShadow", "sampler1DShadow", "sampler2D",
+  "sampler2DArray", "sampler2DArrayShadow", "sampler2DMS", "sampler2DMSArray", "sampler2DRect", "sampler2DRectShadow",
+  "sampler2DShadow", "sampler3D", "sampler3DRect", "samplerBuffer", "samplerCube", "samplerCubeArray",
+  "samplerCubeArrayShadow", "samplerCubeShadow", "short", "sign", "sin", "sinh", "sizeof", "smooth", "smoothstep",
+  "sqrt", "static", "step", "struct", "subroutine", "superp", "switch", "tan", "tanh", "template", "texelFetch",
+  "texelFetchOffset", "texture", "texture2D", "texture2DGradEXT", "texture2DLod", "texture2DLodEXT", "texture2DProj",
+  "texture2DProjGradEXT", "texture2DProjLod", "texture2DProjLodEXT", "texture2DRect", "texture2DRectProj", "texture3D",
+  "texture3DLod", "texture3DProj", "texture3DProjLod", "textureCube", "textureCubeGradEXT", "textureCubeLod",
+  "textureCubeLodEXT", "textureGather", "textureGatherOffset", "textureGatherOffsets", "textureGrad",
+  "textureGradOffset", "textureLod", "textureLodOffset", "textureOffset", "textureProj", "textureProjGrad",
+  "textureProjGradOffset", "textureProjLod", "textureProjLodOffset", "textureProjOffset", "textureSize",
+  "textureVideoWEBGL", "this", "transpose", "true", "trunc", "typedef", "uaddCarry", "uimage1D", "uimage1DArray",
+  "uimage2D", "uimage2DArray", "uimage3D", "uimageBuffer", "uimageCube", "uint", "uintBitsToFloat", "umulExtended",
+  "uniform", "union", "unpackHalf2x16", "unpackSnorm2x16", "unpackSnorm4x8", "unpackUnorm2x16", "unpackUnorm4x8",
+  "unsigned", "usampler1D", "usampler1DArray", "usampler2D", "usampler2DArray", "usampler2DMS", "usampler2DMSArray",
+  "usampler2DRect", "usampler3D", "usamplerBuffer", "usamplerCube", "usamplerCubeArray", "using", "usubBorrow",
+  "uvec2", "uvec3", "uvec4", "varying", "vec2", "vec3", "vec4", "void", "volatile", "while", "yuv_2_rgb",
+];
+
+/** FNV-1a with a seed and a final avalanche, must be the same as spglslReservedWordHash in the generated file */
+function hashWord(word, seed) {
+  let h = (0x811c9dc5 ^ seed) >>> 0;
+  for (let i = 0; i < word.length; ++i) {
+    h = Math.imul(h ^ word.charCodeAt(i), 0x01000193) >>> 0;
+  }
+  h = Math.imul(h ^ (h >>> 16), 0x7feb352d) >>> 0;
+  h = Math.imul(h ^ (h >>> 15), 0x846ca68b) >>> 0;
+  return (h ^ (h >>> 16)) >>> 0;
+}
+
+const words = Array.from(new Set(reservedWords)).sort();
+
+let tableSize = 1;
+while (tableSize < words.length * 1.25) {
+  tableSize *= 2;
+}
+const bucketsCount = Math.ceil(words.length / 4);
+
+// Hash and displace: the words of each bucket are placed with the first seed that puts all of them in free slots.
+const buckets = Array.from({ length: bucketsCount }, () => []);
+for (const word of words) {
+  buckets[hashWord(word, 0) % bucketsCount].push(word);
+}
+
+const displacements = new Array(bucketsCount).fill(0);
+const table = new Array(tableSize).fill(null);
+const bucketsOrder = buckets.map((_, i) => i).sort((a, b) => buckets[b].length - buckets[a].length || a - b);
+for (const bucketIndex of bucketsOrder) {
+  const bucket = buckets[bucketIndex];
+  if (bucket.length === 0) {
+    continue;
+  }
+  for (let seed = 1; ; ++seed) {
+    if (seed > 0xffff) {
+      throw new Error("Could not find a perfect hash");
+    }
+    const slots = bucket.map((word) => hashWord(word, seed) & (tableSize - 1));
+    if (new Set(slots).size === slots.length && slots.every((slot) => table[slot] === null)) {
+      slots.forEach((slot, i) => {
+        table[slot] = bucket[i];
+      });
+      displacements[bucketIndex] = seed;
+      break;
+    }
+  }
+}
+
+function formatList(items, indent) {
+  const lines = [];
+  let line = indent;
+  for (const item of items) {
+    const token = `${item},`;
+    if (line.length + token.length + 1 > 120) {
+      lines.push(line.trimEnd());
+      line = indent;
+    }
+    line += `${token} `;
+  }
+  lines.push(line.trimEnd());
+  return lines.join("\n");
+}
+
+const contentToWrite = `// Generated by scripts/generate-reserved-words.js, do not edit.
+
+#ifndef _SPGLSL_RESERVED_WORDS_AUTOGEN_
+#define _SPGLSL_RESERVED_WORDS_AUTOGEN_
+
+#include <cstdint>
+#include <string_view>
+
+constexpr uint32_t spglslReservedWordsCount = ${words.length};
+constexpr uint32_t spglslReservedWordsTableSize = ${tableSize};
+constexpr uint32_t spglslReservedWordsBucketsCount = ${bucketsCount};
+
+constexpr uint16_t spglslReservedWordsDisplacements[spglslReservedWordsBucketsCount] = {
+${formatList(displacements, "    ")}
+};
+
+constexpr std::string_view spglslReservedWordsTable[spglslReservedWordsTableSize] = {
+${formatList(
+  table.map((word) => (word === null ? '""' : JSON.stringify(word))),
+  "    ",
+)}
+};
+
+constexpr uint32_t spglslReservedWordHash(std::string_view word, uint32_t seed) {
+  uint32_t h = 0x811c9dc5u ^ seed;
+  for (char c : word) {
+    h = (h ^ (uint8_t)c) * 0x01000193u;
+  }
+  h = (h ^ (h >> 16)) * 0x7feb352du;
+  h = (h ^ (h >> 15)) * 0x846ca68bu;
+  return h ^ (h >> 16);
+}
+
+/** True if the word is a GLSL keyword or built-in name, without any allocation */
+constexpr bool spglslReservedWordsHas(std::string_view word) {
+  if (word.empty()) {
+    return false;
+  }
+  const uint32_t bucket = spglslReservedWordHash(word, 0) % spglslReservedWordsBucketsCount;
+  const uint32_t slot = spglslReservedWordHash(word, spglslReservedWordsDisplacements[bucket]);
+  return spglslReservedWordsTable[slot & (spglslReservedWordsTableSize - 1)] == word;
+}
+
+static_assert(spglslReservedWordsHas("main") && spglslReservedWordsHas("vec4") && !spglslReservedWordsHas("a"));
+
+#endif
+`;
+
+console.log(`${words.length} words, table size ${tableSize}, ${bucketsCount} buckets`);
+console.log("Output file is ./", path.relative(projectDir, outputFilePath));
+
+let isDifferent = true;
+try {
+  if (fs.readFileSync(outputFilePath, "utf8") === contentToWrite) {
+    isDifferent = false;
+  }
+} catch (_) {}
+
+if (isDifferent) {
+  fs.writeFileSync(outputFilePath, contentToWrite, "utf8");
+  console.log("file written");
+} else {
+  console.log("already up to date");
+}
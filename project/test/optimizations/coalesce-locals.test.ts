@@ -0,0 +1,157 @@
+import { expect } from "chai";
+import { spglslAngleCompile, SpglslAngleCompileError, SpglslAngleCompileResult } from "spglsl";
+
+const source = `#version 300 es
+precision highp float;
+uniform float uTime;
+uniform vec2 uResolution;
+out vec4 fragColor;
+void main() {
+  vec2 uv = gl_FragCoord.xy / uResolution;
+  float wave = sin(uv.x * 10.0 + uTime);
+  fragColor.x = wave * wave;
+  float ripple = cos(uv.y * 7.0 - uTime);
+  fragColor.y = ripple * ripple;
+  float glow = 0.0;
+  for (int i = 0; i < 4; ++i) {
+    float step = float(i) * uTime;
+    glow += sin(step);
+    float fade = glow * 0.5;
+    glow -= fade * fade;
+  }
+  fragColor.zw = vec2(glow, 1.0);
+}
+`;
+
+/** A fragment shader with the given functions before main and the given body of main */
+function makeSource(mainBody: string, functions = ""): string {
+  return `#version 300 es
+precision highp float;
+uniform float uTime;
+uniform vec2 uResolution;
+out vec4 fragColor;
+${functions}void main() {
+  vec2 uv = gl_FragCoord.xy / uResolution;
+  fragColor = vec4(0.0);
+${mainBody}}
+`;
+}
+
+describe("coalesce-locals", function () {
+  this.timeout(7000);
+
+  it("produces a valid shader that is not bigger with coalesceLocals", async () => {
+    const normal = await compile(source, false);
+    const coalesced = await compile(source, true);
+    expect((coalesced.output || "").length).to.be.lessThanOrEqual((normal.output || "").length);
+  });
+
+  it("merges a local into an earlier one of the same type that is not used anymore", async () => {
+    const waves = makeSource(`  float wave = sin(uv.x * 10.0 + uTime);
+  fragColor.x = wave * wave;
+  float ripple = cos(uv.y * 7.0 - uTime);
+  fragColor.y = ripple * ripple;
+`);
+    const normal = await compile(waves, false);
+    const coalesced = await compile(waves, true);
+    // ripple is declared after the last use of wave, its declaration becomes an assignment to wave.
+    expect(hasLocal(normal, "ripple")).to.equal(true);
+    expect(hasLocal(coalesced, "ripple")).to.equal(false);
+    expect(countDeclarations(coalesced, "float")).to.equal(countDeclarations(normal, "float") - 1);
+  });
+
+  it("does not merge a local that is read after the later declaration", async () => {
+    await expectUnchanged(
+      makeSource(`  float wave = sin(uv.x * 10.0 + uTime);
+  float ripple = cos(uv.y * 7.0 - uTime);
+  fragColor = vec4(wave, ripple, wave * ripple, 1.0);
+`),
+    );
+  });
+
+  it("does not merge a local into an out parameter", async () => {
+    await expectUnchanged(
+      makeSource(
+        `  float wave;
+  waves(uv, wave);
+  fragColor.x = wave;
+`,
+        `void waves(vec2 uv, out float wave) {
+  wave = sin(uv.x * 10.0 + uTime);
+  float ripple = cos(uv.y * 7.0 - wave);
+  fragColor.y = ripple * ripple;
+}
+`,
+      ),
+    );
+  });
+
+  it("does not merge the locals of a switch body", async () => {
+    await expectUnchanged(
+      makeSource(`  switch (int(uTime) % 2) {
+    case 0:
+      float wave = sin(uv.x * 10.0 + uTime);
+      fragColor.x = wave * wave;
+      float ripple = cos(uv.y * 7.0 - uTime);
+      fragColor.y = ripple * ripple;
+      break;
+    default:
+      fragColor.z = uTime;
+      break;
+  }
+`),
+    );
+  });
+
+  it("does not merge into a local whose name is shadowed in a nested scope", async () => {
+    await expectUnchanged(
+      makeSource(`  float wave = sin(uv.x * 10.0 + uTime);
+  fragColor.x = wave * wave;
+  float ripple = cos(uv.y * 7.0 - uTime);
+  for (int i = 0; i < 4; ++i) {
+    float wave = ripple * float(i);
+    fragColor.z += wave * wave;
+  }
+  fragColor.y = ripple;
+`),
+    );
+  });
+});
+
+async function expectUnchanged(mainSourceCode: string) {
+  const normal = await compile(mainSourceCode, false);
+  const coalesced = await compile(mainSourceCode, true);
+  expect(coalesced.output).to.equal(normal.output);
+}
+
+/** True if a local variable of main with the given source name is still declared */
+function hasLocal(result: SpglslAngleCompileResult, name: string): boolean {
+  return Object.keys(result.mangleMap).some((key) => key.startsWith("main()@") && key.endsWith(`/${name}#0`));
+}
+
+/** Number of declarations of the given type in the output, a declaration may declare many variables */
+function countDeclarations(result: SpglslAngleCompileResult, type: string): number {
+  return ((result.output || "").match(new RegExp(`(?:^|[;{}\\n])${type} `, "g")) || []).length;
+}
+
+async function compile(mainSourceCode: string, coalesceLocals: boolean): Promise<SpglslAngleCompileResult> {
+  const compiled = await spglslAngleCompile({
+    mainSourceCode,
+    compileMode: "Optimize",
+    mangle: true,
+    minify: true,
+    beautify: false,
+    coalesceLocals,
+  });
+  if (compiled.infoLog.hasErrors()) {
+    throw new SpglslAngleCompileError(compiled);
+  }
+  const validated = await spglslAngleCompile({
+    mainSourceCode: compiled.output || "",
+    compileMode: "Validate",
+  });
+  if (validated.infoLog.hasErrors()) {
+    throw new SpglslAngleCompileError(validated);
+  }
+  return compiled;
+}
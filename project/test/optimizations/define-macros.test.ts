@@ -0,0 +1,51 @@
+import { expect } from "chai";
+import { spglslAngleCompile, SpglslAngleCompileError, SpglslAngleCompileResult } from "spglsl";
+
+const SHADER =
+  "#version 300 es\nprecision mediump float;uniform vec3 U;out vec4 V;" +
+  "vec3 f(vec3 x){return normalize(x)*U;}vec3 g(vec3 x){return normalize(x+U);}vec3 h(vec3 x){return normalize(x-U);}" +
+  "vec3 k(vec3 x){return normalize(x*U);}void main(){vec3 a=normalize(U);V=vec4(f(a)+g(a)+h(a)+k(a),1.);}";
+
+describe("define-macros", function () {
+  this.timeout(7000);
+
+  it("aliases repeated keywords", async () => {
+    const withMacros = await compile(SHADER, true);
+    const withoutMacros = await compile(SHADER, false);
+    expect(withMacros.output).to.contain("#define ");
+    expect(withMacros.macroBytesSaved).to.be.greaterThan(0);
+    expect(withMacros.output!.length).to.equal(withoutMacros.output!.length - withMacros.macroBytesSaved);
+  });
+
+  it("keeps the #version directive first", async () => {
+    expect((await compile(SHADER, true)).output).to.match(/^#version 300 es\n#define /);
+  });
+
+  it("does not change the output when not enabled", async () => {
+    const result = await compile(SHADER, false);
+    expect(result.output).to.not.contain("#define");
+    expect(result.macroBytesSaved).to.equal(0);
+  });
+});
+
+async function compile(code: string, defineMacros: boolean): Promise<SpglslAngleCompileResult> {
+  const compiled = await spglslAngleCompile({
+    mainSourceCode: code,
+    compileMode: "Optimize",
+    mangle: true,
+    minify: true,
+    beautify: false,
+    defineMacros,
+  });
+  if (compiled.infoLog.hasErrors()) {
+    throw new SpglslAngleCompileError(compiled);
+  }
+  const validated = await spglslAngleCompile({
+    mainSourceCode: compiled.output || "",
+    compileMode: "Validate",
+  });
+  if (validated.infoLog.hasErrors()) {
+    throw new SpglslAngleCompileError(validated);
+  }
+  return compiled;
+}
@@ -0,0 +1,49 @@
+import { expect } from "chai";
+import { spglslAngleCompile, SpglslAngleCompileError } from "spglsl";
+
+const SHADER_PREFIX =
+  "#version 300 es\nprecision mediump float;layout(location=1)out vec4 V;layout(location=2)out vec4 P;";
+
+describe("float-literals", function () {
+  this.timeout(7000);
+
+  it("writes the shortest fixed or scientific literal", async () => {
+    expect(await compileMain("P.x=0.5;")).to.eq("P.x=.5;");
+    expect(await compileMain("P.x=-0.25;")).to.eq("P.x=-.25;");
+    expect(await compileMain("P.x=100.0;")).to.eq("P.x=1e2;");
+    expect(await compileMain("P.x=0.00001;")).to.eq("P.x=1e-5;");
+    expect(await compileMain("P.x=123456789.0;")).to.eq("P.x=123456792.;");
+  });
+
+  it("keeps exponents that end with zero", async () => {
+    expect(await compileMain("P.x=1.5e10;")).to.eq("P.x=1.5e10;");
+    expect(await compileMain("P.x=3.25e20;")).to.eq("P.x=3.25e20;");
+    expect(await compileMain("P.x=2.5e-10;")).to.eq("P.x=2.5e-10;");
+  });
+
+  it("does not lose precision on small values", async () => {
+    expect(await compileMain("P.x=0.000123456789;")).to.eq("P.x=.00012345679;");
+    expect(await compileMain("P.x=1e-10;")).to.eq("P.x=1e-10;");
+  });
+});
+
+async function compileMain(code: string): Promise<string> {
+  const compiled = await spglslAngleCompile({
+    mainSourceCode: `${SHADER_PREFIX}void main(){${code}}`,
+    compileMode: "Optimize",
+    mangle: false,
+    minify: true,
+    beautify: false,
+  });
+  if (compiled.infoLog.hasErrors()) {
+    throw new SpglslAngleCompileError(compiled);
+  }
+  const validated = await spglslAngleCompile({
+    mainSourceCode: compiled.output || "",
+    compileMode: "Validate",
+  });
+  if (validated.infoLog.hasErrors()) {
+    throw new SpglslAngleCompileError(validated);
+  }
+  return (compiled.output || "").replace(SHADER_PREFIX, "").replace("void main(){", "").slice(0, -1);
+}
@@ -0,0 +1,103 @@
+import { expect } from "chai";
+import zlib from "node:zlib";
+import { spglslAngleCompile, SpglslAngleCompileError, SpglslAngleCompileResult } from "spglsl";
+
+const source = `#version 300 es
+precision highp float;
+uniform float uTime;
+out vec4 fragColor;
+float waveA(float x) { return sin(x * 3.1 + uTime); }
+uniform vec2 uResolution;
+float waveB(float x) { return cos(x * 1.7 - uTime); }
+uniform float uScale;
+void main() {
+  vec2 uv = gl_FragCoord.xy / uResolution;
+  float a = waveA(uv.x * uScale);
+  float b = waveB(uv.y * uScale);
+  fragColor = vec4(a, b, a * b, 1.0);
+}
+`;
+
+/**
+ * Each caller C<i> repeats the literals of the function L<i> it calls. In source order all the L functions come
+ * before all the C functions, too far apart to be in the same gzip window, moving L<i> right before C<i> pays.
+ */
+function makeClusteredSource(count: number, terms: number): string {
+  const literals = (i: number) =>
+    Array.from({ length: terms }, (_, k) => (Math.abs(Math.sin(i * 12.9898 + k * 78.233)) * 0.999 + 0.0005).toFixed(6));
+  const polynomial = (v: string, i: number) => literals(i).map((c) => `${v} * ${c}`).join(" + ");
+  let result = "#version 300 es\nprecision highp float;\nuniform float uTime;\nout vec4 fragColor;\n";
+  for (let i = 0; i < count; ++i) {
+    result += `float L${i}(float x) { return ${polynomial("x", i)}; }\n`;
+  }
+  for (let i = 0; i < count; ++i) {
+    result += `float C${i}(float y) { return L${i}(y) - ${polynomial("y", i)}; }\n`;
+  }
+  const calls = Array.from({ length: count }, (_, i) => `C${i}(uTime)`).join(" + ");
+  return `${result}void main() {\n  fragColor = vec4(${calls});\n}\n`;
+}
+
+const clusteredSource = makeClusteredSource(160, 24);
+
+/** Position of the definition of a function in the output, from its mangled name */
+function definitionIndex(compiled: SpglslAngleCompileResult, name: string): number {
+  const key = Object.keys(compiled.mangleMap).find((k) => k.startsWith(`${name}(`));
+  expect(key, `mangle map key of ${name}`).to.be.a("string");
+  const output = compiled.output || "";
+  const match = new RegExp(`float ${compiled.mangleMap[key as string]}\\(float \\w+\\)\\{`).exec(output);
+  expect(match, `definition of ${name}`).to.not.equal(null);
+  return match!.index;
+}
+
+describe("gzip-optimizations", function () {
+  this.timeout(30000);
+
+  it("reports the gzipped size of the output", async () => {
+    const compiled = await compile(false);
+    expect(compiled.gzipSize).to.eq(zlib.gzipSync(compiled.output || "", { level: 9 }).length);
+  });
+
+  it("does not produce a bigger gzipped output with optimizeGzip", async () => {
+    const normal = await compile(false);
+    const optimized = await compile(true);
+    expect(optimized.gzipSize).to.eq(zlib.gzipSync(optimized.output || "", { level: 9 }).length);
+    expect(optimized.gzipSize).to.be.lessThanOrEqual(normal.gzipSize);
+  });
+
+  it("moves the functions right before their first caller", async () => {
+    const normal = await compile(false, clusteredSource);
+    const optimized = await compile(true, clusteredSource);
+    expect(optimized.gzipSize).to.be.lessThan(normal.gzipSize);
+
+    // Source order: all the L functions, then all the C functions.
+    expect(definitionIndex(normal, "L1")).to.be.lessThan(definitionIndex(normal, "C0"));
+
+    // Clustered order: L0 C0 L1 C1 ..., every callee still before its caller.
+    expect(definitionIndex(optimized, "C0")).to.be.lessThan(definitionIndex(optimized, "L1"));
+    for (let i = 0; i < 160; ++i) {
+      expect(definitionIndex(optimized, `L${i}`)).to.be.lessThan(definitionIndex(optimized, `C${i}`));
+    }
+  });
+});
+
+async function compile(optimizeGzip: boolean, mainSourceCode = source) {
+  const compiled = await spglslAngleCompile({
+    mainSourceCode,
+    compileMode: "Optimize",
+    mangle: true,
+    minify: true,
+    beautify: false,
+    optimizeGzip,
+  });
+  if (compiled.infoLog.hasErrors()) {
+    throw new SpglslAngleCompileError(compiled);
+  }
+  const validated = await spglslAngleCompile({
+    mainSourceCode: compiled.output || "",
+    compileMode: "Validate",
+  });
+  if (validated.infoLog.hasErrors()) {
+    throw new SpglslAngleCompileError(validated);
+  }
+  return compiled;
+}
@@ -0,0 +1,50 @@
+import { expect } from "chai";
+import { spglslAngleCompile, SpglslAngleCompileError } from "spglsl";
+
+const SHADER_PREFIX = "#version 300 es\nprecision mediump float;layout(location=1)out vec4 V;";
+
+describe("hoist-literals", function () {
+  this.timeout(7000);
+
+  it("declares a repeated literal once", async () => {
+    const code = "V.x*=1.2345678;V.y*=1.2345678;V.z*=1.2345678;V.w*=1.2345678;";
+    expect(count(await compile(code, true), "1.2345678")).to.equal(1);
+    expect(count(await compile(code, false), "1.2345678")).to.equal(4);
+  });
+
+  it("declares a repeated vector constant once", async () => {
+    const code = "V.x=dot(V.xyz,vec3(.2126,.7152,.0722));V.y=dot(V.yzw,vec3(.2126,.7152,.0722));";
+    expect(count(await compile(code, true), ".2126")).to.equal(1);
+  });
+
+  it("keeps short literals", async () => {
+    const code = "V.x*=2.;V.y*=2.;V.z*=2.;V.w*=2.;";
+    expect(await compile(code, true)).to.not.contain("const");
+  });
+});
+
+function count(text: string, search: string): number {
+  return text.split(search).length - 1;
+}
+
+async function compile(code: string, hoistLiterals: boolean): Promise<string> {
+  const compiled = await spglslAngleCompile({
+    mainSourceCode: `${SHADER_PREFIX}void main(){${code}}`,
+    compileMode: "Optimize",
+    mangle: true,
+    minify: true,
+    beautify: false,
+    hoistLiterals,
+  });
+  if (compiled.infoLog.hasErrors()) {
+    throw new SpglslAngleCompileError(compiled);
+  }
+  const validated = await spglslAngleCompile({
+    mainSourceCode: compiled.output || "",
+    compileMode: "Validate",
+  });
+  if (validated.infoLog.hasErrors()) {
+    throw new SpglslAngleCompileError(validated);
+  }
+  return compiled.output || "";
+}
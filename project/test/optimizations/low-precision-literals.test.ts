@@ -0,0 +1,44 @@
+import { expect } from "chai";
+import { spglslAngleCompile, SpglslAngleCompileError } from "spglsl";
+
+const SHADER_PREFIX =
+  "#version 300 es\nprecision mediump float;layout(location=1)out vec4 V;layout(location=2)out highp vec4 P;";
+
+describe("low-precision-literals", function () {
+  this.timeout(7000);
+
+  it("shortens literals used by mediump expressions", async () => {
+    expect(await compile("V.x*=1.23456789;", true)).to.contain("V.x*=1.234;");
+    expect(await compile("V.x*=0.33333333;", true)).to.contain("V.x*=.3333;");
+  });
+
+  it("keeps full precision in highp expressions", async () => {
+    expect(await compile("P.x*=1.23456789;", true)).to.contain("P.x*=1.2345679;");
+  });
+
+  it("keeps full precision when not enabled", async () => {
+    expect(await compile("V.x*=1.23456789;", false)).to.contain("V.x*=1.2345679;");
+  });
+});
+
+async function compile(code: string, lowPrecisionLiterals: boolean): Promise<string> {
+  const compiled = await spglslAngleCompile({
+    mainSourceCode: `${SHADER_PREFIX}void main(){${code}}`,
+    compileMode: "Optimize",
+    mangle: false,
+    minify: true,
+    beautify: false,
+    lowPrecisionLiterals,
+  });
+  if (compiled.infoLog.hasErrors()) {
+    throw new SpglslAngleCompileError(compiled);
+  }
+  const validated = await spglslAngleCompile({
+    mainSourceCode: compiled.output || "",
+    compileMode: "Validate",
+  });
+  if (validated.infoLog.hasErrors()) {
+    throw new SpglslAngleCompileError(validated);
+  }
+  return compiled.output || "";
+}
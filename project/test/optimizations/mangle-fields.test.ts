@@ -0,0 +1,71 @@
+import { expect } from "chai";
+import { spglslAngleCompile, SpglslAngleCompileError } from "spglsl";
+
+const source = `#version 300 es
+precision highp float;
+struct PointLight {
+  vec3 position;
+  float attenuationRadius;
+};
+struct Material {
+  vec3 albedo;
+  float roughness;
+};
+uniform Material uMaterial;
+uniform vec3 uLightPositions[2];
+in vec3 vPosition;
+out vec4 fragColor;
+float lightContribution(PointLight light) {
+  float distanceToLight = length(light.position - vPosition);
+  return clamp(1.0 - distanceToLight / light.attenuationRadius, 0.0, 1.0);
+}
+void main() {
+  float total = 0.0;
+  for (int i = 0; i < 2; ++i) {
+    PointLight light = PointLight(uLightPositions[i], 4.0 + float(i));
+    total += lightContribution(light);
+  }
+  fragColor = vec4(uMaterial.albedo * total * (1.0 - uMaterial.roughness), 1.0);
+}
+`;
+
+describe("mangle-fields", function () {
+  this.timeout(7000);
+
+  it("renames the fields of local structs only with mangleFields", async () => {
+    const normal = await compile(false);
+    expect(normal).to.contain("attenuationRadius");
+
+    const mangled = await compile(true);
+    expect(mangled).to.not.contain("attenuationRadius");
+    expect(mangled.length).to.be.lessThan(normal.length);
+  });
+
+  it("keeps the fields of structs used by uniforms", async () => {
+    const mangled = await compile(true);
+    expect(mangled).to.contain("albedo");
+    expect(mangled).to.contain("roughness");
+  });
+});
+
+async function compile(mangleFields: boolean): Promise<string> {
+  const compiled = await spglslAngleCompile({
+    mainSourceCode: source,
+    compileMode: "Optimize",
+    mangle: true,
+    minify: true,
+    beautify: false,
+    mangleFields,
+  });
+  if (compiled.infoLog.hasErrors()) {
+    throw new SpglslAngleCompileError(compiled);
+  }
+  const validated = await spglslAngleCompile({
+    mainSourceCode: compiled.output || "",
+    compileMode: "Validate",
+  });
+  if (validated.infoLog.hasErrors()) {
+    throw new SpglslAngleCompileError(validated);
+  }
+  return compiled.output || "";
+}
@@ -0,0 +1,98 @@
+import { expect } from "chai";
+import { spglslAngleCompile, SpglslAngleCompileError, SpglslAngleCompileResult } from "spglsl";
+
+const source = `#version 300 es
+precision highp float;
+uniform float uTime;
+uniform vec2 uResolution;
+out vec4 fragColor;
+void main() {
+  vec2 uv = gl_FragCoord.xy / uResolution;
+  float wave = sin(uv.x * 10.0 + uTime);
+  float ripple = cos(uv.y * 7.0 - uTime);
+  vec3 color = vec3(wave * ripple);
+  if (color.x > 0.5) {
+    float glow = color.x * color.y;
+    for (int i = 0; i < 4; ++i) {
+      float step = float(i) * glow;
+      glow += sin(step + uTime);
+    }
+    fragColor = vec4(glow);
+    return;
+  }
+  fragColor = vec4(color, 1.0);
+}
+`;
+
+const shadowingSource = `#version 300 es
+precision highp float;
+uniform float uTime;
+out vec4 fragColor;
+void main() {
+  float base = uTime * 0.5;
+  if (base > 0.25) {
+    float glow = base * base;
+    glow += sin(glow + uTime);
+    fragColor = vec4(glow);
+    return;
+  }
+  fragColor = vec4(base);
+}
+`;
+
+describe("mangle-live-ranges", function () {
+  this.timeout(7000);
+
+  it("produces a valid shader that is not bigger with mangleLiveRanges", async () => {
+    const normal = await compile(false);
+    const optimized = await compile(true);
+    expect(optimized.length).to.be.lessThanOrEqual(normal.length);
+  });
+
+  it("lets a nested variable take the name of an outer variable not read after its declaration", async () => {
+    const normal = await compileResult(shadowingSource, false);
+    expect(mangledName(normal, "glow")).to.not.equal(mangledName(normal, "base"));
+
+    const optimized = await compileResult(shadowingSource, true);
+    expect(mangledName(optimized, "glow")).to.equal(mangledName(optimized, "base"));
+  });
+
+  it("keeps distinct names when the outer variable is read after the nested declaration", async () => {
+    const readAfter = shadowingSource.replace("fragColor = vec4(glow);", "fragColor = vec4(glow, base, 0.0, 1.0);");
+    const optimized = await compileResult(readAfter, true);
+    expect(mangledName(optimized, "glow")).to.not.equal(mangledName(optimized, "base"));
+  });
+});
+
+/** The mangled name of a local variable of main, from the exported mangle map */
+function mangledName(result: SpglslAngleCompileResult, name: string): string {
+  const key = Object.keys(result.mangleMap).find((k) => k.startsWith("main()@") && k.endsWith(`/${name}#0`));
+  expect(key, `mangle map key of ${name}`).to.be.a("string");
+  return result.mangleMap[key as string];
+}
+
+async function compile(mangleLiveRanges: boolean): Promise<string> {
+  return (await compileResult(source, mangleLiveRanges)).output || "";
+}
+
+async function compileResult(mainSourceCode: string, mangleLiveRanges: boolean): Promise<SpglslAngleCompileResult> {
+  const compiled = await spglslAngleCompile({
+    mainSourceCode,
+    compileMode: "Optimize",
+    mangle: true,
+    minify: true,
+    beautify: false,
+    mangleLiveRanges,
+  });
+  if (compiled.infoLog.hasErrors()) {
+    throw new SpglslAngleCompileError(compiled);
+  }
+  const validated = await spglslAngleCompile({
+    mainSourceCode: compiled.output || "",
+    compileMode: "Validate",
+  });
+  if (validated.infoLog.hasErrors()) {
+    throw new SpglslAngleCompileError(validated);
+  }
+  return compiled;
+}
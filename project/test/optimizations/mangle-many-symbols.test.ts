@@ -0,0 +1,44 @@
+import { expect } from "chai";
+import { spglslAngleCompile, SpglslAngleCompileError } from "spglsl";
+
+const SYMBOLS_COUNT = 12000;
+
+function makeSource(): string {
+  let source = "#version 300 es\nprecision highp float;\nuniform float uTime;\nout vec4 fragColor;\n";
+  for (let i = 0; i < SYMBOLS_COUNT; ++i) {
+    source += `float global${i};\n`;
+  }
+  source += "void main() {\n  float sum = 0.0;\n";
+  for (let i = 0; i < SYMBOLS_COUNT; ++i) {
+    source += `  global${i} = uTime * ${i}.0;\n  sum += global${i};\n`;
+  }
+  source += "  fragColor = vec4(sum);\n}\n";
+  return source;
+}
+
+describe("mangle-many-symbols", function () {
+  this.timeout(60000);
+
+  it(`mangles a shader with ${SYMBOLS_COUNT} globals`, async () => {
+    const source = makeSource();
+
+    const compiled = await spglslAngleCompile({
+      mainSourceCode: source,
+      compileMode: "Optimize",
+      mangle: true,
+      minify: true,
+      beautify: false,
+    });
+    if (compiled.infoLog.hasErrors()) {
+      throw new SpglslAngleCompileError(compiled);
+    }
+
+    const output = compiled.output || "";
+    expect(output.length).to.be.lessThan(source.length);
+
+    const validated = await spglslAngleCompile({ mainSourceCode: output, compileMode: "Validate" });
+    if (validated.infoLog.hasErrors()) {
+      throw new SpglslAngleCompileError(validated);
+    }
+  });
+});
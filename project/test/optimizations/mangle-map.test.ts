@@ -0,0 +1,101 @@
+import { expect } from "chai";
+import {
+  spglslAngleCompile,
+  SpglslAngleCompileError,
+  SpglslAngleCompileResult,
+  spglslPreload,
+  spglslUnload,
+} from "spglsl";
+
+const source = `#version 300 es
+precision highp float;
+uniform float uTime;
+uniform vec2 uResolution;
+out vec4 fragColor;
+float wave(float x, float speed) {
+  float phase = x * speed + uTime;
+  return sin(phase) * 0.5 + 0.5;
+}
+vec3 palette(float t) {
+  vec3 base = vec3(0.5, 0.4, 0.3);
+  return base + base * cos(6.28318 * (t + vec3(0.0, 0.33, 0.67)));
+}
+void main() {
+  vec2 uv = gl_FragCoord.xy / uResolution;
+  float intensity = wave(uv.x, 3.0) * wave(uv.y, 5.0);
+  fragColor = vec4(palette(intensity), 1.0);
+}
+`;
+
+describe("mangle-map", function () {
+  this.timeout(7000);
+
+  it("exports the names of the mangled symbols", async () => {
+    const compiled = await compile(source, undefined);
+    expect(Object.keys(compiled.mangleMap)).to.not.be.empty;
+  });
+
+  it("produces the same output when the mangle map is imported", async () => {
+    const first = await compile(source, undefined);
+    const second = await compile(source, first.mangleMap);
+    expect(second.output).to.equal(first.output);
+    expect(second.mangleMap).to.deep.equal(first.mangleMap);
+  });
+
+  it("keeps the names of the functions that did not change", async () => {
+    const first = await compile(source, undefined);
+    const changed = source.replace("vec3(0.5, 0.4, 0.3)", "vec3(0.6, 0.4, 0.2)");
+    const second = await compile(changed, first.mangleMap);
+    for (const [key, value] of Object.entries(first.mangleMap)) {
+      if (key.startsWith("wave(")) {
+        expect(second.mangleMap[key]).to.equal(value);
+      }
+    }
+  });
+
+  it("initializes only if the fingerprints hash matches the scalar HighwayHash golden values", async () => {
+    // spglsl_init fails if the HighwayHash backend of the build differs from the scalar implementation.
+    spglslUnload();
+    await spglslPreload();
+    const compiled = await compile(source, undefined);
+    const localKeys = Object.keys(compiled.mangleMap).filter((key) => key.includes("/"));
+    expect(localKeys).to.not.be.empty;
+    for (const key of localKeys) {
+      expect(key).to.match(/^\w+\([^)]*\)@[0-9a-f]{16}\/\w+#\d+$/);
+    }
+  });
+
+  it("ignores invalid names", async () => {
+    const first = await compile(source, undefined);
+    const invalid: Record<string, string> = {};
+    for (const key of Object.keys(first.mangleMap)) {
+      invalid[key] = "gl_Invalid";
+    }
+    await compile(source, invalid);
+  });
+});
+
+async function compile(
+  mainSourceCode: string,
+  mangle_map: Record<string, string> | undefined,
+): Promise<SpglslAngleCompileResult> {
+  const compiled = await spglslAngleCompile({
+    mainSourceCode,
+    compileMode: "Optimize",
+    mangle: true,
+    minify: true,
+    beautify: false,
+    mangle_map,
+  });
+  if (compiled.infoLog.hasErrors()) {
+    throw new SpglslAngleCompileError(compiled);
+  }
+  const validated = await spglslAngleCompile({
+    mainSourceCode: compiled.output || "",
+    compileMode: "Validate",
+  });
+  if (validated.infoLog.hasErrors()) {
+    throw new SpglslAngleCompileError(validated);
+  }
+  return compiled;
+}
@@ -0,0 +1,60 @@
+import { expect } from "chai";
+import { spglslAngleCompile, SpglslAngleCompileError, SpglslRepeatedSubtree } from "spglsl";
+
+const source = `#version 300 es
+precision highp float;
+uniform vec3 lightDir;
+uniform vec3 viewDir;
+uniform vec3 normal;
+out vec4 fragColor;
+void main() {
+  float specular = dot(normal, normalize(lightDir + viewDir));
+  float sheen = pow(max(dot(normal, normalize(lightDir + viewDir)), 0.0), 8.0);
+  vec3 halfway = normalize(lightDir + viewDir);
+  fragColor = vec4(halfway * specular * sheen, 1.0);
+}
+`;
+
+const uniqueMain = `void main() {
+  fragColor = vec4(normalize(lightDir + viewDir) * dot(normal, viewDir), 1.0);
+}
+`;
+
+describe("repeated-subtrees", function () {
+  this.timeout(7000);
+
+  it("reports the largest repeated subtree with the lines of all its occurrences", async () => {
+    const repeated = await compile(source);
+    // dot(normal, normalize(lightDir + viewDir))
+    expect(repeated[0]).to.deep.equal({ nodes: 6, lines: [8, 9] });
+  });
+
+  it("reports a smaller subtree that also appears outside of a larger repeated one", async () => {
+    const repeated = await compile(source);
+    // normalize(lightDir + viewDir), the occurrence at line 10 is not part of the dot product
+    expect(repeated[1]).to.deep.equal({ nodes: 4, lines: [8, 9, 10] });
+  });
+
+  it("does not report the subtrees that only appear inside a reported subtree", async () => {
+    const repeated = await compile(source);
+    // lightDir + viewDir only appears in normalize(lightDir + viewDir)
+    expect(repeated).to.have.length(2);
+  });
+
+  it("reports nothing when no subtree is repeated", async () => {
+    const repeated = await compile(source.replace(/void main\(\) {[^]*/, uniqueMain));
+    expect(repeated).to.deep.equal([]);
+  });
+});
+
+async function compile(mainSourceCode: string): Promise<SpglslRepeatedSubtree[]> {
+  const compiled = await spglslAngleCompile({
+    mainSourceCode,
+    compileMode: "Compile",
+    reportRepeatedSubtrees: true,
+  });
+  if (compiled.infoLog.hasErrors()) {
+    throw new SpglslAngleCompileError(compiled);
+  }
+  return compiled.repeatedSubtrees;
+}
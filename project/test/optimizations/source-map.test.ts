@@ -0,0 +1,133 @@
+import { expect } from "chai";
+import { spglslAngleCompile, SpglslAngleCompileError, SpglslAngleCompileResult } from "spglsl";
+
+const SHADER = [
+  "#version 300 es",
+  "precision mediump float;",
+  "uniform vec3 lightDirection;",
+  "out vec4 fragColor;",
+  "vec3 shade(vec3 direction) {",
+  "  return normalize(direction) * lightDirection;",
+  "}",
+  "void main() {",
+  "  fragColor = vec4(shade(lightDirection) + shade(fragColor.xyz), 1.0);",
+  "}",
+].join("\n");
+
+describe("source-map", function () {
+  this.timeout(7000);
+
+  it("generates a source map v3", async () => {
+    const result = await compile(true);
+    const sourceMap = JSON.parse(result.outputSourceMap!);
+    expect(sourceMap.version).to.equal(3);
+    expect(sourceMap.sources).to.deep.equal(["shader.frag"]);
+    expect(sourceMap.mappings).to.match(/^[A-Za-z0-9+/,;]+$/);
+  });
+
+  it("maps the mangled names to the original names", async () => {
+    const sourceMap = JSON.parse((await compile(true)).outputSourceMap!);
+    expect(sourceMap.names).to.contain("shade");
+  });
+
+  it("maps the mangled shade call to its source line and original name", async () => {
+    expectShadeCallMapping(await compile(true));
+  });
+
+  it("maps the positions of a beautified multi-line output", async () => {
+    const result = await compile(true, true);
+    expect(result.output!.split("\n").length).to.be.greaterThan(3);
+    const mapping = expectShadeCallMapping(result);
+    expect(mapping.generatedLine).to.be.greaterThan(0);
+  });
+
+  it("does not generate a source map when not enabled", async () => {
+    expect((await compile(false)).outputSourceMap).to.equal(null);
+  });
+});
+
+interface DecodedMapping {
+  generatedLine: number;
+  generatedColumn: number;
+  sourceLine: number;
+  name: string | undefined;
+}
+
+const BASE64_CHARS = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/** Decodes the base64 VLQ mappings of a source map v3 with a single source */
+function decodeMappings(sourceMap: { mappings: string; names: string[] }): DecodedMapping[] {
+  const result: DecodedMapping[] = [];
+  let sourceLine = 0;
+  let nameIndex = 0;
+  sourceMap.mappings.split(";").forEach((line, generatedLine) => {
+    let generatedColumn = 0;
+    for (const segment of line.split(",")) {
+      if (!segment) {
+        continue;
+      }
+      const fields: number[] = [];
+      let value = 0;
+      let shift = 0;
+      for (const char of segment) {
+        const digit = BASE64_CHARS.indexOf(char);
+        value += (digit & 31) << shift;
+        shift += 5;
+        if (!(digit & 32)) {
+          fields.push(value & 1 ? -(value >>> 1) : value >>> 1);
+          value = 0;
+          shift = 0;
+        }
+      }
+      generatedColumn += fields[0];
+      sourceLine += fields[2];
+      let name: string | undefined;
+      if (fields.length > 4) {
+        nameIndex += fields[4];
+        name = sourceMap.names[nameIndex];
+      }
+      result.push({ generatedLine, generatedColumn, sourceLine, name });
+    }
+  });
+  return result;
+}
+
+/** Finds the mapping of the first call of shade in main, it must point to the zero based source line 8 */
+function expectShadeCallMapping(result: SpglslAngleCompileResult): DecodedMapping {
+  const shadeKey = Object.keys(result.mangleMap).find((key) => key.startsWith("shade("));
+  expect(shadeKey).to.be.a("string");
+  const mangled = result.mangleMap[shadeKey!];
+  expect(mangled).to.not.equal("shade");
+
+  const output = result.output!;
+  const mainIndex = output.indexOf("main(");
+  const call = new RegExp(`\\b${mangled}\\(`, "g");
+  call.lastIndex = mainIndex;
+  const callIndex = call.exec(output)!.index;
+  const linesBefore = output.slice(0, callIndex).split("\n");
+  const generatedLine = linesBefore.length - 1;
+  const generatedColumn = linesBefore[generatedLine].length;
+
+  const mappings = decodeMappings(JSON.parse(result.outputSourceMap!));
+  const mapping = mappings.find((m) => m.generatedLine === generatedLine && m.generatedColumn === generatedColumn);
+  expect(mapping, `mapping at ${generatedLine}:${generatedColumn}`).to.not.equal(undefined);
+  expect(mapping!.sourceLine).to.equal(8);
+  expect(mapping!.name).to.equal("shade");
+  return mapping!;
+}
+
+async function compile(sourceMap: boolean, beautify = false): Promise<SpglslAngleCompileResult> {
+  const compiled = await spglslAngleCompile({
+    mainFilePath: "shader.frag",
+    mainSourceCode: SHADER,
+    compileMode: "Optimize",
+    mangle: true,
+    minify: true,
+    beautify,
+    sourceMap,
+  });
+  if (compiled.infoLog.hasErrors()) {
+    throw new SpglslAngleCompileError(compiled);
+  }
+  return compiled;
+}